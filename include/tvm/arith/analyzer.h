@@ -163,6 +163,8 @@ class ConstIntBoundAnalyzer {
   class Impl;
   /*! \brief Internal impl */
   Impl* impl_;
+  /*! \brief The parent analyzer */
+  Analyzer* parent_;
 };
 
 /*!
@@ -309,6 +311,8 @@ class CanonicalSimplifier {
   class Impl;
   /*! \brief Internal impl */
   Impl* impl_;
+  /*! \brief The parent analyzer */
+  Analyzer* parent_;
 };
 
 /*!
@@ -403,6 +407,8 @@ class TVM_DLL Analyzer {
   IntSetAnalyzer int_set;
   /*! \brief constructor */
   Analyzer();
+  /*! \brief destructor */
+  ~Analyzer();
   /*!
    * \brief Notify all the sub-analyzers that var
    *        is created and binded to expr.
@@ -491,6 +497,35 @@ class TVM_DLL Analyzer {
    * \note Analyzer will call into sub-analyzers to get the result.
    */
   PrimExpr Simplify(const PrimExpr& expr, int steps = 2);
+  /*!
+   * \brief Enable or disable the memo table of Simplify, canonical_simplify and const_int_bound.
+   *
+   *  The memo table is keyed by the structure of the expression, so repeated queries
+   *  on structurally equal expressions are answered without running the analysis again.
+   *  Each constraint scope gets its own table, and all the tables are cleared
+   *  whenever the information about a Var changes.
+   *
+   * \param enable Whether to enable the memo table.
+   * \note Only the outermost query is memoized, the queries issued by the sub-analyzers
+   *  while answering it are not.
+   */
+  void EnableMemo(bool enable = true);
+  /*!
+   * \brief Clear the memo table.
+   *
+   *  Called by the sub-analyzers when the information about a Var has been updated.
+   */
+  void ClearMemo();
+
+ private:
+  friend class ConstIntBoundAnalyzer;
+  friend class CanonicalSimplifier;
+  friend class ConstraintContext;
+  class Memo;
+  /*! \brief Simplify without looking up the memo table. */
+  PrimExpr SimplifyImpl(const PrimExpr& expr, int steps);
+  /*! \brief The memo table, nullptr when memoization is disabled. */
+  std::unique_ptr<Memo> memo_;
 };
 
 }  // namespace arith
@@ -50,6 +50,11 @@ class TuningOptionsNode : public Object {
   ProgramRunner runner;
   /*! \brief MeasureCallback functions to be called after each measure batch */
   Optional<Array<MeasureCallback>> measure_callbacks;
+  /*!
+   * \brief The maximum number of built batches that may wait for the runner.
+   * A positive value overlaps building and running, 0 builds and runs in sequence.
+   */
+  int async_measure_queue_size;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("num_measure_trials", &num_measure_trials);
@@ -59,6 +64,7 @@ class TuningOptionsNode : public Object {
     v->Visit("builder", &builder);
     v->Visit("runner", &runner);
     v->Visit("measure_callbacks", &measure_callbacks);
+    v->Visit("async_measure_queue_size", &async_measure_queue_size);
   }
 
   static constexpr const char* _type_key = "auto_scheduler.TuningOptions";
@@ -81,10 +87,13 @@ class TuningOptions : public ObjectRef {
    * \param builder ProgramBuilder which builds the program.
    * \param runner ProgramRunner which runs the program and measure time costs.
    * \param measure_callbacks MeasureCallback functions to be called after each measure batch.
+   * \param async_measure_queue_size The maximum number of built batches that may wait for the
+   * runner when building and running are overlapped. 0 disables the overlap.
    */
   TuningOptions(int num_measure_trials, int early_stopping, int num_measures_per_round, int verbose,
                 ProgramBuilder builder, ProgramRunner runner,
-                Optional<Array<MeasureCallback>> measure_callbacks);
+                Optional<Array<MeasureCallback>> measure_callbacks,
+                int async_measure_queue_size = 0);
 
   TVM_DEFINE_OBJECT_REF_METHODS(TuningOptions, ObjectRef, TuningOptionsNode);
 };
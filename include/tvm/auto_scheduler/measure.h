@@ -478,6 +478,13 @@ class ProgramMeasurerNode : public Object {
   int verbose;
   /*! \brief The number of allowed maximum continuous error before forcely stopping the tuning */
   int max_continuous_error;
+  /*!
+   * \brief The maximum number of built batches that may wait for the runner.
+   * When it is positive, the batches are built on a background thread so that building batch
+   * k+1 overlaps with running batch k, and the build thread blocks once this many built batches
+   * are pending. 0 builds and runs every batch in sequence.
+   */
+  int async_queue_size;
 
   /*! \brief Reset book keeping variables */
   void Reset();
@@ -498,9 +505,12 @@ class ProgramMeasurerNode : public Object {
    * \param task The current SearchTask.
    * \param inputs The MeasureInputs.
    * \param results A pointer to a MeasureResult Array, this is used as output.
+   * \param build_results The build results of the inputs if they are already built, otherwise
+   * the inputs are built first.
    */
   void SilentMeasure(const SearchTask& task, const Array<MeasureInput>& inputs,
-                     Array<MeasureResult>* results);
+                     Array<MeasureResult>* results,
+                     Optional<Array<BuildResult>> build_results = NullOpt);
 
   /*! \brief The default max continuous error setting. */
   static const int DEFAULT_MAX_CONTINUOUS_ERROR = 150;
@@ -524,10 +534,12 @@ class ProgramMeasurer : public ObjectRef {
    * measuring.
    * \param max_continuous_error The number of allowed maximum continuous error before
    * forcely stopping the tuning.
+   * \param async_queue_size The maximum number of built batches that may wait for the runner
+   * when building and running are overlapped. 0 disables the overlap.
    */
   ProgramMeasurer(ProgramBuilder builder, ProgramRunner runner,
                   Optional<Array<MeasureCallback>> callbacks, int verbose,
-                  int max_continuous_error = -1);
+                  int max_continuous_error = -1, int async_queue_size = 0);
 
   TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(ProgramMeasurer, ObjectRef, ProgramMeasurerNode);
 };
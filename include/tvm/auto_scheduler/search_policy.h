@@ -168,6 +168,24 @@ class SearchPolicyNode : public Object {
    */
   void PreloadMeasuredStates(const String& log_file);
 
+  /*!
+   * \brief Preload the measured states of similar workloads from a log file to warm-start the
+   * search. A workload is similar if its workload key has the same function name or ComputeDAG
+   * hash as the current task. The best states of the nearest workloads (by shape distance) are
+   * replayed on the current ComputeDAG, with their split factors adapted to the new extents.
+   * \param log_file The name of the record log file.
+   * \param num_states The maximum number of states to transfer.
+   * \return The records of the similar workloads, nearest workloads first. They can be used to
+   * pretrain a cost model.
+   */
+  std::pair<Array<MeasureInput>, Array<MeasureResult>> PreloadSimilarStates(const String& log_file,
+                                                                            int num_states);
+
+  /*! \return The states transferred from similar workloads, best first. */
+  Array<State> GetTransferredStates() const {
+    return Array<State>(transferred_states_.begin(), transferred_states_.end());
+  }
+
   /*!
    * \brief Call SearchCallback with the current SearchPolicyNode
    * \param callbacks SearchCallback to be called.
@@ -189,6 +207,11 @@ class SearchPolicyNode : public Object {
   std::vector<State> measured_states_vector_;
   /*! \brief The throughputs of already measured states */
   std::vector<float> measured_states_throughputs_;
+  /*!
+   * \brief The states transferred from similar workloads, best first.
+   * Unlike `measured_states_vector_`, they have not been measured for the current task yet.
+   */
+  std::vector<State> transferred_states_;
 };
 
 /*!
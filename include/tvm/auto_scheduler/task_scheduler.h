@@ -0,0 +1,197 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file auto_scheduler/task_scheduler.h
+ * \brief The task scheduler that allocates the measurement trials when tuning multiple tasks
+ * (e.g. all the subgraphs of a network) together.
+ *
+ * This is the C++ counterpart of `python/tvm/auto_scheduler/task_scheduler.py`.
+ * The details of the "gradient" strategy can be found in the section 6 of this paper:
+ * L. Zheng, C. Jia, M. Sun, Z. Wu, C. Yu, et al. "Ansor : Generating High-Performance Tensor
+ * Programs for Deep Learning." (OSDI 2020).
+ */
+
+#ifndef TVM_AUTO_SCHEDULER_TASK_SCHEDULER_H_
+#define TVM_AUTO_SCHEDULER_TASK_SCHEDULER_H_
+
+#include <tvm/auto_scheduler/auto_schedule.h>
+#include <tvm/auto_scheduler/search_policy.h>
+
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tvm {
+namespace auto_scheduler {
+
+/*! \brief Allocate the measurement trials when tuning multiple tasks together. */
+class TaskSchedulerNode : public Object {
+ public:
+  /*! \brief All tasks to tune. */
+  Array<SearchTask> tasks;
+  /*! \brief One search policy per task. */
+  Array<SearchPolicy> search_policies;
+  /*!
+   * \brief The weights of tasks. The objective to minimize is sum(weight[t] * latency[t]),
+   * which is the estimated end-to-end latency when the weights are the number of occurrences of
+   * each task in the network.
+   */
+  std::vector<double> task_weights;
+  /*! \brief The scheduling strategy, "gradient" or "round-robin". */
+  String strategy;
+  /*! \brief The weight of the backward gradient in the "gradient" strategy. */
+  double alpha;
+  /*! \brief The speedup a task is assumed to reach w.r.t. its similar tasks in "gradient". */
+  double beta;
+  /*! \brief The window size of the backward gradient in the "gradient" strategy. */
+  int backward_window_size;
+  /*!
+   * \brief Stop tuning a task if it got no improvement in this many measurement trials.
+   * A negative value disables it.
+   */
+  int per_task_early_stopping;
+  /*!
+   * \brief Stop tuning a task once its latency improved by less than this ratio over the last
+   * `backward_window_size` rounds. 0 disables it.
+   */
+  double plateau_threshold;
+  /*!
+   * \brief The number of different tasks whose rounds run at the same time.
+   * The searches of the rounds are serialized, while their programs are built and run
+   * concurrently, which pays off when the tasks are measured on separate remote devices.
+   */
+  int num_parallel_tasks;
+
+  /*! \brief The number of tuning rounds of each task. */
+  std::vector<int> task_cts;
+  /*! \brief The round in which each task found its best latency. */
+  std::vector<int> task_best_cts;
+  /*! \brief The history of the best latency of each task, one entry per round. */
+  std::vector<std::vector<double>> task_costs_history;
+  /*! \brief The best latency of each task. */
+  std::vector<double> best_costs;
+  /*! \brief The tasks that will not be tuned any more. */
+  std::unordered_set<int> dead_tasks;
+  /*! \brief The total number of measurement trials. */
+  int ct;
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    v->Visit("tasks", &tasks);
+    v->Visit("search_policies", &search_policies);
+    v->Visit("strategy", &strategy);
+    v->Visit("alpha", &alpha);
+    v->Visit("beta", &beta);
+    v->Visit("backward_window_size", &backward_window_size);
+    v->Visit("per_task_early_stopping", &per_task_early_stopping);
+    v->Visit("plateau_threshold", &plateau_threshold);
+    v->Visit("num_parallel_tasks", &num_parallel_tasks);
+    v->Visit("ct", &ct);
+  }
+
+  /*!
+   * \brief Tune all the tasks together.
+   * \param tuning_options The tuning options applied to all tasks. `num_measure_trials` is the
+   * total number of trials shared by all tasks and `early_stopping` applies to the objective.
+   */
+  void Tune(const TuningOptions& tuning_options);
+
+  /*!
+   * \brief Update the book keeping with the measurement of one round of a task, and stop tuning
+   * the task if it has no improvement for a long while or it has plateaued.
+   * \param task_idx The index of the task.
+   * \param inputs The measured inputs of the round.
+   * \param results The measurement results of the round.
+   */
+  void UpdateTask(int task_idx, const Array<MeasureInput>& inputs,
+                  const Array<MeasureResult>& results);
+
+  /*! \return The current value of the objective function. */
+  double ComputeScore(const std::vector<double>& costs) const;
+
+  static constexpr const char* _type_key = "auto_scheduler.TaskScheduler";
+  TVM_DECLARE_FINAL_OBJECT_INFO(TaskSchedulerNode, Object);
+
+ private:
+  /*!
+   * \brief Pick the next task to tune with the "round-robin" strategy.
+   * \param last_idx The last picked task, or -1 if none.
+   * \param busy The tasks that can not be picked since their rounds are running.
+   * \return The picked task, or -1 if all the live tasks are busy.
+   */
+  int PickTaskByRoundRobin(int last_idx, const std::unordered_set<int>& busy);
+  /*!
+   * \brief Pick the next task to tune with the "gradient" strategy.
+   * \param busy The tasks that can not be picked since their rounds are running.
+   * \return The picked task, or -1 if all the live tasks are busy.
+   */
+  int PickTaskByGradient(const std::unordered_set<int>& busy);
+  /*! \brief Remove a task from its similarity group if it does not behave like the group. */
+  void AdjustSimilarityGroup(int task_idx);
+
+  /*! \brief The number of measurement trials of each round. */
+  int num_measures_per_round_;
+  /*! \brief The verbosity level. */
+  int verbose_;
+  /*! \brief The similarity tag of each task. An empty tag means no similar task. */
+  std::vector<std::string> task_tags_;
+  /*! \brief The task ids of each similarity tag. */
+  std::unordered_map<std::string, std::vector<int>> tag_to_task_ids_;
+  /*! \brief Random generator to break the ties. */
+  std::mt19937 rand_gen_;
+
+  friend class TaskScheduler;
+};
+
+/*!
+ * \brief Managed reference to TaskSchedulerNode.
+ * \sa TaskSchedulerNode
+ */
+class TaskScheduler : public ObjectRef {
+ public:
+  /*!
+   * \brief The constructor.
+   * \param tasks All tasks to tune.
+   * \param search_policies One search policy per task.
+   * \param task_weights The weights of tasks. Equal weights are used if it is empty.
+   * \param strategy The scheduling strategy, "gradient" or "round-robin".
+   * \param alpha The weight of the backward gradient in the "gradient" strategy.
+   * \param beta The assumed speedup w.r.t. similar tasks in the "gradient" strategy.
+   * \param backward_window_size The window size of the backward gradient.
+   * \param per_task_early_stopping Stop tuning a task if it got no improvement in this many
+   * measurement trials. A negative value disables it.
+   * \param plateau_threshold Stop tuning a task once its latency improved by less than this ratio
+   * over the last `backward_window_size` rounds. 0 disables it.
+   * \param num_parallel_tasks The number of different tasks whose rounds run at the same time.
+   * \param seed The random seed.
+   */
+  TaskScheduler(Array<SearchTask> tasks, Array<SearchPolicy> search_policies,
+                Array<FloatImm> task_weights, String strategy, double alpha, double beta,
+                int backward_window_size, int per_task_early_stopping, double plateau_threshold,
+                int num_parallel_tasks, int seed);
+
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(TaskScheduler, ObjectRef, TaskSchedulerNode);
+};
+
+}  // namespace auto_scheduler
+}  // namespace tvm
+
+#endif  // TVM_AUTO_SCHEDULER_TASK_SCHEDULER_H_
@@ -77,6 +77,18 @@ class DFPatternCallback : public ObjectRef {
  */
 bool MatchPattern(DFPattern pattern, Expr expr);
 
+/*!
+ * \brief Find the matches of a number of patterns in an expression in one walk of its graph
+ *
+ * A node is only tried against the patterns whose root can match its operator and arity.
+ *
+ * \param patterns The patterns to match
+ * \param expr The expression to match
+ *
+ * \return For each pattern, the expressions where a match of the pattern is rooted.
+ */
+Array<Array<Expr>> MatchPatterns(const Array<DFPattern>& patterns, const Expr& expr);
+
 /*!
  * \brief Rewrite an expression based on some number of DFPatternCallbacks
  *
@@ -91,6 +91,23 @@ TVM_DLL Pass DeadCodeElimination(bool inline_once = false);
  */
 TVM_DLL Pass LazyGradientInit();
 
+/*!
+ * \brief Recompute cheap activations right before their late uses instead of
+ * keeping them alive, until the storage planned for the function by
+ * GraphPlanMemory fits the memory budget.
+ *
+ * This lowers the peak memory of the functions returned by the gradient
+ * passes, which keep the forward activations alive until the backward
+ * computation. Functions with control flow, closures or references are
+ * not changed, and the others are returned in graph normal form.
+ *
+ * \param memory_budget The number of bytes the storage may take, including
+ *        the parameters and the constants. The pass does nothing if it is 0.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass Rematerialize(Integer memory_budget);
+
 /*!
  * \brief Fold constant expressions.
  *
@@ -286,6 +303,18 @@ TVM_DLL Pass CombineParallelDense(uint64_t min_num_branches = 3, bool to_batch_m
  */
 TVM_DLL Pass CombineParallelBatchMatmul(uint64_t min_num_branches = 3);
 
+/*!
+ * \brief Fuse independent ops of the same operator and argument shapes from
+ *  different branches into a single batched op, if there are at least
+ * `min_num_branch` of them. Unlike the CombineParallel passes, the ops do not
+ *  need to share an input.
+ *
+ * \param min_num_branches The minimun number of ops to batch.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass HorizontalFusion(uint64_t min_num_branches = 3);
+
 /*!
  * \brief Backward fold axis scaling into weights of conv/dense operators.
  *
@@ -352,6 +381,36 @@ TVM_DLL Pass AutoSchedulerLayoutRewrite();
  */
 TVM_DLL Pass ConvertLayout(const Map<String, Array<String>>& desired_layouts);
 
+/*!
+ * \brief Choose the data layout of every conv2d of a function together.
+ *
+ * Unlike ConvertLayout, which converts every conv2d to one given layout, the
+ * layout of each conv2d is chosen among NCHW, NHWC and NCHW[x]c to minimize
+ * the cost of the convolutions and of the layout transforms between them, as
+ * estimated by the cost model of the relay.PlanLayout.cost_model config.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass PlanLayout();
+
+/*!
+ * \brief Rewrite a float32 function to compute in a lower precision float type.
+ *
+ * Each op is always converted, follows the precision of its inputs or is never
+ * converted, as given by op_categories or else by its
+ * FTVMMixedPrecisionConversionType attribute. Ops without a category are
+ * never converted, and neither are the always converted ops which have no
+ * out_dtype to accumulate in float32.
+ *
+ * \param mixed_precision_type The lower precision type, float16 or bfloat16.
+ * \param op_categories The category of ops by name, overriding their attributes:
+ *        0 to always convert, 1 to follow the inputs and 2 to never convert.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass ToMixedPrecision(DataType mixed_precision_type,
+                              Map<String, Integer> op_categories = {});
+
 /*!
  * \brief Legalizes an expr with another expression.
  * \param legalize_map_attr_name The Op's attr name which corresponds to the legalize rule function.
@@ -420,6 +479,15 @@ TVM_DLL Pass RemoveUnusedFunctions(Array<runtime::String> entry_functions);
  */
 TVM_DLL Pass SimplifyExpr();
 
+/*!
+ * \brief Canonicalize the ops which only move data: remove the layout transforms,
+ * transposes, reshapes and device copies which leave their input as it is, cancel
+ * those followed by their inverse and merge those in a row into one.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass SimplifyDataMovement();
+
 /*!
  * \brief A pass for manifesting explicit memory allocations and rewriting
  * specific dialects.
@@ -152,6 +152,26 @@ TVM_DLL int TVMBackendParallelBarrier(int task_id, TVMParallelGroupEnv* penv);
  */
 TVM_DLL int TVMBackendRunOnce(void** handle, int (*f)(void*), void* cdata, int nbytes);
 
+/*!
+ * \brief Backend function to record the entry of a profiled loop.
+ *
+ * \param key The key of the loop, a string constant of the module.
+ * \param trip_count The number of iterations of the loop.
+ * \return The timestamp of the entry in nanoseconds.
+ *
+ * \sa TVMBackendLoopProfileExit
+ */
+TVM_DLL int64_t TVMBackendLoopProfileEnter(const char* key, int64_t trip_count);
+
+/*!
+ * \brief Backend function to record the exit of a profiled loop.
+ *
+ * \param key The key of the loop.
+ * \param start The timestamp returned by TVMBackendLoopProfileEnter.
+ * \return 0 when no error is thrown, -1 when failure happens
+ */
+TVM_DLL int TVMBackendLoopProfileExit(const char* key, int64_t start);
+
 #ifdef __cplusplus
 }  // TVM_EXTERN_C
 #endif
@@ -553,6 +553,30 @@ TVM_DLL const Op& vectorlow();
  */
 TVM_DLL const Op& vectorcombine();
 
+/*!
+ * \brief Combine the lanes of a vector into a scalar with +.
+ *
+ *  vector_reduce_add(x) = x[0] + x[1] + ... + x[lanes - 1]
+ *
+ *  The lanes can be combined in any order.
+ */
+TVM_DLL const Op& vector_reduce_add();
+
+/*!
+ * \brief Combine the lanes of a vector into a scalar with *.
+ */
+TVM_DLL const Op& vector_reduce_mul();
+
+/*!
+ * \brief Combine the lanes of a vector into a scalar with max.
+ */
+TVM_DLL const Op& vector_reduce_max();
+
+/*!
+ * \brief Combine the lanes of a vector into a scalar with min.
+ */
+TVM_DLL const Op& vector_reduce_min();
+
 /*!
  * \brief atomic add instruction, corresponding e.g. to atomicAdd in CUDA
  */
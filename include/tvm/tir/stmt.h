@@ -1247,6 +1247,11 @@ constexpr const char* pragma_import_c = "pragma_import_c";
 constexpr const char* pragma_import_llvm = "pragma_import_llvm";
 /*! \brief Try to modify the AST to support Tensor Core */
 constexpr const char* pragma_tensor_core = "pragma_tensor_core";
+/*!
+ * \brief Annotation of a For loop on whether LoopPartition partitions it,
+ *  the value is 1 to partition the loop and 0 to keep it as is.
+ */
+constexpr const char* pragma_loop_partition = "pragma_loop_partition";
 /*!
  * \brief Mark of prefetch scope, value=offset,
  *  run prefetch of Tensor on the current loop scope
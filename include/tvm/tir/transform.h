@@ -75,6 +75,16 @@ TVM_DLL Pass InjectPrefetch();
  */
 TVM_DLL Pass StorageFlatten(int cache_line_size, bool create_bound_attribute = false);
 
+/*!
+ * \brief Tile and reorder the perfectly nested loops so that the data
+ *  touched by each tile fits into the L1/L2 cache.
+ *
+ *  The cache sizes are read from the "tir.LoopTiling" pass config.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass LoopTiling();
+
 /*!
  * \brief Inject copy intrinsics with optional pad.
  *
@@ -105,6 +115,16 @@ TVM_DLL Pass CoProcSync();
  */
 TVM_DLL Pass LiftAttrScope(String attr_key);
 
+/*!
+ * \brief Profile-guided loop optimization, configured by the "tir.LoopProfile"
+ *  pass config. With instrument set, the loops are wrapped with trip count and
+ *  time counters. With a profile of an instrumented run, cold loops are kept
+ *  rolled and unpartitioned, while hot loops are unrolled or partitioned.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass LoopProfile();
+
 /*!
  * \brief partition loops in the stmt.
  *
@@ -338,6 +358,47 @@ TVM_DLL Pass BF16Legalize();
  */
 TVM_DLL Pass PointerValueTypeRewrite();
 
+/*!
+ * \brief Prefetch the strided and indirect loads of the innermost loops
+ *  a few iterations ahead.
+ *
+ *  Only applies to the functions with an LLVM target, the parameters
+ *  are read from the "tir.InjectSoftwarePrefetch" pass config.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass InjectSoftwarePrefetch();
+
+/*!
+ * \brief Accumulate the commutative reductions of the innermost loops
+ *  into the lanes of a vector, and combine the lanes after the loop.
+ *
+ *  Only applies to the functions with an LLVM target, the accumulator
+ *  width is read from the "tir.VectorizeReduction" pass config.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass VectorizeReduction();
+
+/*!
+ * \brief Hoist the loop invariant index computations, and replace the
+ *  floordiv/floormod of the indices which are affine in the variable of
+ *  an innermost serial loop with incrementally updated counters.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass IndexStrengthReduction();
+
+/*!
+ * \brief Specialize the body of each function on the values of its symbolic
+ *  shapes read from the "tir.SpecializeShapes" pass config, the hot values
+ *  and the multiples of the divisors, and dispatch among the variants and
+ *  the generic body at call time.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass SpecializeShapes();
+
 /*!
  * \brief Hoist loop-invariant IfThenElse nodes to
  * outside the elligible loops.
@@ -90,6 +90,7 @@ class Analyzer:
         self._canonical_simplify = _mod("canonical_simplify")
         self._int_set = _mod("int_set")
         self._enter_constraint_context = _mod("enter_constraint_context")
+        self._enable_memo = _mod("enable_memo")
 
     def const_int_bound(self, expr):
         """Find constant integer bound for expr.
@@ -202,6 +203,20 @@ class Analyzer:
         """
         return self._bind(var, expr)
 
+    def enable_memo(self, enable=True):
+        """Enable or disable the memo table of simplify, canonical_simplify and const_int_bound.
+
+        The memoized results are keyed by the structure of the expression.
+        They are scoped to the constraint scope and cleared whenever
+        the information about a variable changes.
+
+        Parameters
+        ----------
+        enable : bool
+            Whether to enable the memo table.
+        """
+        self._enable_memo(enable)
+
     def constraint_scope(self, constraint):
         """Create a constraint scope.
 
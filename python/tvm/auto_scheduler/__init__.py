@@ -56,6 +56,7 @@ from .search_policy import (
     SketchPolicy,
     PreloadMeasuredStates,
     PreloadCustomSketchRule,
+    PreloadSimilarStates,
 )
-from .task_scheduler import TaskScheduler
+from .task_scheduler import TaskScheduler, NativeTaskScheduler
 from .workload_registry import register_workload, make_workload_key
@@ -35,6 +35,7 @@ import os
 import time
 import shutil
 import tempfile
+import threading
 import multiprocessing
 import logging
 
@@ -304,14 +305,49 @@ class ProgramMeasurer(Object):
         The Verbosity level: 0 for silent, 1 to output information during program
     max_continuous_error : Optional[int]
         The number of allowed maximum continuous error before stop the tuning
+    async_queue_size : int = 0
+        The maximum number of built batches that may wait for the runner.
+        When it is positive, the next batch is built in a background thread while the current
+        batch is being measured. This shortens the tuning time when the builder and the runner
+        do not compete for the same CPU (e.g. RPCRunner or GPU targets).
+        0 builds and runs every batch in sequence.
     """
 
-    def __init__(self, builder, runner, callbacks, verbose, max_continuous_error=None):
+    def __init__(
+        self, builder, runner, callbacks, verbose, max_continuous_error=None, async_queue_size=0
+    ):
         max_continuous_error = max_continuous_error or -1  # -1 means using the default value
         self.__init_handle_by_constructor__(
-            _ffi_api.ProgramMeasurer, builder, runner, callbacks, verbose, max_continuous_error
+            _ffi_api.ProgramMeasurer,
+            builder,
+            runner,
+            callbacks,
+            verbose,
+            max_continuous_error,
+            async_queue_size,
         )
 
+    def measure(self, task, policy, inputs, batch_size=-1):
+        """Measure a list of MeasureInputs in batches.
+
+        Parameters
+        ----------
+        task : SearchTask
+            The task of the inputs.
+        policy : SearchPolicy
+            The search policy passed to the callbacks.
+        inputs : List[MeasureInput]
+            The MeasureInputs to measure.
+        batch_size : int = -1
+            The number of programs measured in one batch, -1 for twice the build parallelism.
+
+        Returns
+        -------
+        results : List[MeasureResult]
+            The results of the inputs, in the same order.
+        """
+        return _ffi_api.ProgramMeasurerMeasure(self, task, policy, inputs, batch_size)
+
 
 @tvm._ffi.register_object("auto_scheduler.LocalBuilder")
 class LocalBuilder(ProgramBuilder):
@@ -680,6 +716,28 @@ def local_build_worker(args):
     return res
 
 
+@tvm._ffi.register_func("auto_scheduler.measure_pipeline_event")
+def measure_pipeline_event():
+    """Create the event a thread waits on for the C++ worker threads of auto_scheduler, such as the
+    build thread of a ProgramMeasurer with a positive `async_queue_size`.
+
+    Waiting on a python event releases the GIL, so the builders, runners and cost models
+    (implemented in python) can make progress on the worker threads meanwhile.
+
+    Returns
+    -------
+    event : Callable[[int], None]
+        Clears the event with 0, sets it with 1 and waits until it is set with 2.
+    """
+    event = threading.Event()
+    ops = [event.clear, event.set, event.wait]
+
+    def apply(op):
+        ops[op]()
+
+    return apply
+
+
 @tvm._ffi.register_func("auto_scheduler.local_builder.build")
 def local_builder_build(inputs, timeout, n_parallel, build_func="default", verbose=1):
     """
@@ -94,6 +94,29 @@ class PreloadCustomSketchRule(SearchCallback):
         )
 
 
+@tvm._ffi.register_object("auto_scheduler.PreloadSimilarStates")
+class PreloadSimilarStates(SearchCallback):
+    """A SearchCallback for SketchPolicy to warm-start the search from the measured records of
+    similar workloads.
+
+    A workload is similar if its workload key has the same function name or ComputeDAG hash as
+    the task, and the nearest ones are picked by the distance between their shapes.
+    Their best states are replayed on the task (with the split factors adapted to the new shapes)
+    and join the initial population of the evolutionary search. The cost model is also
+    pretrained on the records of the similar workloads.
+
+    Parameters
+    ----------
+    filename : str
+        The name of the record file.
+    num_states : int = 64
+        The maximum number of states to transfer.
+    """
+
+    def __init__(self, filename, num_states=64):
+        self.__init_handle_by_constructor__(_ffi_api.PreloadSimilarStates, filename, num_states)
+
+
 @tvm._ffi.register_object("auto_scheduler.SearchPolicy")
 class SearchPolicy(Object):
     """ The base class of search policies. """
@@ -273,3 +296,14 @@ class SketchPolicy(SearchPolicy):
         """
         states = _ffi_api.SketchPolicyEvolutionarySearch(self, init_populations, out_size)
         return states
+
+    def transferred_states(self):
+        """Get the states transferred from similar workloads by PreloadSimilarStates.
+        This python interface is mainly used for debugging and testing.
+
+        Returns
+        -------
+        states: List[State]
+            The transferred states, best first
+        """
+        return _ffi_api.SearchPolicyGetTransferredStates(self)
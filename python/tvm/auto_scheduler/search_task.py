@@ -118,6 +118,10 @@ class TuningOptions(Object):
         Callback functions called after each measurement.
         Candidates:
         - auto_scheduler.RecordToFile
+    async_measure_queue_size: int = 0
+        The maximum number of built batches that may wait for the runner.
+        A positive value builds the next batch in the background while the current batch is
+        being measured. See `auto_scheduler.measure.ProgramMeasurer` for details.
     """
 
     def __init__(
@@ -129,6 +133,7 @@ class TuningOptions(Object):
         builder="local",
         runner="local",
         measure_callbacks=None,
+        async_measure_queue_size=0,
     ):
         if isinstance(builder, str):
             if builder == "local":
@@ -161,6 +166,7 @@ class TuningOptions(Object):
             builder,
             runner,
             measure_callbacks,
+            async_measure_queue_size,
         )
 
 
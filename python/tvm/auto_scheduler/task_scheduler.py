@@ -29,6 +29,9 @@ import logging
 
 import numpy as np
 
+import tvm._ffi
+from tvm.runtime import Object
+
 from .search_policy import SearchPolicy, SketchPolicy, PreloadMeasuredStates
 from .cost_model import RandomModel, XGBModel
 from .utils import array_mean
@@ -320,6 +323,7 @@ class TaskScheduler:
             tune_option.runner,
             tune_option.measure_callbacks,
             tune_option.verbose,
+            async_queue_size=tune_option.async_measure_queue_size,
         )
         self.ct = self.best_ct = 0
         self.tic = time.time()
@@ -536,6 +540,125 @@ class TaskScheduler:
         logger.info("TaskScheduler: Loaded %d measurement records from %s", total_ct + 1, log_file)
 
 
+@tvm._ffi.register_object("auto_scheduler.TaskScheduler")
+class NativeTaskScheduler(Object):
+    """The C++ implementation of the task scheduler.
+
+    It allocates the measurement trials with the same "gradient" and "round-robin" strategies as
+    :class:`TaskScheduler`, but runs the whole tuning loop in C++. Besides the global early
+    stopping, a task is also retired once its latency stops improving.
+
+    Parameters
+    ----------
+    tasks: List[SearchTask]
+        All tasks to tune.
+    task_weights: Optional[List[float]]
+        The weights of tasks. The objective is sum(weight[t] * latency[t]).
+        If None, all weights are 1.
+    strategy : str = "gradient"
+        The scheduling strategy.
+        "round-robin": Tune tasks in round robin order.
+        "gradient" : Tune tasks with gradient descent.
+    alpha: float = 0.2
+        The parameter used for 'gradient' strategy
+    beta: float = 2
+        The parameter used for 'gradient' strategy
+    backward_window_size: int = 3
+        The parameter used for 'gradient' strategy
+    per_task_early_stopping: Optional[int]
+        Stop tuning a task if it got no improvement in this many measurement trials.
+    plateau_threshold: float = 0.0
+        Stop tuning a task once its latency improved by less than this ratio over the last
+        `backward_window_size` rounds. 0 disables it.
+    num_parallel_tasks: int = 1
+        The number of different tasks whose rounds run at the same time. The searches of the
+        rounds are serialized, while their programs are built and run concurrently. This pays off
+        when the tasks are measured on separate remote devices, e.g. with an RPCRunner that has
+        several devices; otherwise the concurrent measurements disturb each other.
+    seed: int = 0
+        The random seed used to break the ties.
+    search_policy: str or List[SearchPolicy] = "default"
+        The list of search policies, see :func:`make_search_policies`.
+    search_policy_params: Optional[Dict[str, Any]]
+        The parameters of the search policy.
+    num_measures_per_round: int = 64
+        The number of measures per round, used to configure the cost models.
+    verbose: int = 1
+        The verbosity level of the search policies.
+    """
+
+    def __init__(
+        self,
+        tasks,
+        task_weights=None,
+        strategy="gradient",
+        alpha=0.2,
+        beta=2,
+        backward_window_size=3,
+        per_task_early_stopping=None,
+        plateau_threshold=0.0,
+        num_parallel_tasks=1,
+        seed=0,
+        search_policy="default",
+        search_policy_params=None,
+        num_measures_per_round=64,
+        verbose=1,
+    ):
+        search_policies = make_search_policies(
+            search_policy, search_policy_params, tasks, num_measures_per_round, verbose
+        )
+        task_weights = [float(x) for x in task_weights] if task_weights else []
+        self.__init_handle_by_constructor__(
+            _ffi_api.TaskScheduler,
+            tasks,
+            search_policies,
+            task_weights,
+            strategy,
+            alpha,
+            beta,
+            backward_window_size,
+            -1 if per_task_early_stopping is None else per_task_early_stopping,
+            plateau_threshold,
+            num_parallel_tasks,
+            seed,
+        )
+
+    def tune(self, tune_option):
+        """Tune all tasks.
+
+        Parameters
+        ----------
+        tune_option: TuningOptions
+            The tuning options applied to all tasks.
+        """
+        _ffi_api.TaskSchedulerTune(self, tune_option)
+
+    def update_task(self, task_idx, inputs, results):
+        """Update the book keeping with the measurement of one round of a task, as done after
+        each round in :meth:`tune`.
+
+        Parameters
+        ----------
+        task_idx: int
+            The index of the task.
+        inputs: List[MeasureInput]
+            The measured inputs of the round.
+        results: List[MeasureResult]
+            The measurement results of the round.
+        """
+        _ffi_api.TaskSchedulerUpdateTask(self, task_idx, inputs, results)
+
+    @property
+    def best_costs(self):
+        """The best latency of each task."""
+        return np.array([x.value for x in _ffi_api.TaskSchedulerBestCosts(self)])
+
+    @property
+    def dead_tasks(self):
+        """The indices of the tasks that will not be tuned any more."""
+        return sorted(x.value for x in _ffi_api.TaskSchedulerDeadTasks(self))
+
+
 class TaskSchedulerCallback:
     """The base class of task scheduler callback functions. """
 
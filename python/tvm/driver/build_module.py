@@ -152,6 +152,10 @@ def lower(sch, args, name="main", binds=None, simple_mode=False):
     pass_ctx = PassContext.current()
     instrument_bound_checkers = bool(pass_ctx.config.get("tir.instrument_bound_checkers", False))
     disable_vectorize = bool(pass_ctx.config.get("tir.disable_vectorize", False))
+    enable_loop_tiling = bool(pass_ctx.config.get("tir.enable_loop_tiling", False))
+    enable_index_strength_reduction = bool(
+        pass_ctx.config.get("tir.enable_index_strength_reduction", False)
+    )
     add_lower_pass = pass_ctx.config.get("tir.add_lower_pass", [])
 
     lower_phase0 = [x[1] for x in add_lower_pass if x[0] == 0]
@@ -167,9 +171,12 @@ def lower(sch, args, name="main", binds=None, simple_mode=False):
 
     pass_list = lower_phase0
     # Phase 1
+    pass_list += [tvm.tir.transform.InjectPrefetch()]
+    if enable_loop_tiling:
+        pass_list += [tvm.tir.transform.LoopTiling()]
     pass_list += [
-        tvm.tir.transform.InjectPrefetch(),
         tvm.tir.transform.StorageFlatten(64, instrument_bound_checkers),
+        tvm.tir.transform.SpecializeShapes(),
         tvm.tir.transform.BF16Legalize(),
         tvm.tir.transform.NarrowDataType(32),
         tvm.tir.transform.Simplify(),
@@ -177,6 +184,7 @@ def lower(sch, args, name="main", binds=None, simple_mode=False):
     pass_list += lower_phase1
 
     # Phase 2
+    pass_list += [tvm.tir.transform.LoopProfile()]
     if not simple_mode:
         pass_list += [(tvm.tir.transform.LoopPartition())]
 
@@ -197,6 +205,8 @@ def lower(sch, args, name="main", binds=None, simple_mode=False):
 
     pass_list += [tvm.tir.transform.RewriteUnsafeSelect()]
     pass_list += [tvm.tir.transform.HoistIfThenElse()]
+    if enable_index_strength_reduction:
+        pass_list += [tvm.tir.transform.IndexStrengthReduction()]
     pass_list += lower_phase3
 
     # Instrument BoundCheckers
@@ -238,6 +248,10 @@ def _build_for_device(input_mod, target, target_host):
     mod_mixed = tvm.tir.transform.Apply(lambda f: f.with_attr("target", target))(mod_mixed)
 
     opt_mixed = [tvm.tir.transform.VerifyMemory()]
+    if PassContext.current().config.get("tir.enable_vectorize_reduction", False):
+        opt_mixed += [tvm.tir.transform.VectorizeReduction()]
+    if PassContext.current().config.get("tir.enable_software_prefetch", False):
+        opt_mixed += [tvm.tir.transform.InjectSoftwarePrefetch()]
     if len(mod_mixed.functions) == 1:
         opt_mixed += [tvm.tir.transform.Apply(lambda f: f.with_attr("tir.is_entry_func", True))]
 
@@ -319,6 +319,46 @@ def get_total_mac_number(expr):
     return _ffi_api.GetTotalMacNumber(expr)
 
 
+def estimate_fused_latency(expr):
+    """
+    Estimate the latency of a fused program with the analytic model of
+    the relay.FuseOps.cost_model config of the current pass context.
+
+    Parameters
+    ----------
+    expr : Union[tvm.relay.Expr, tvm.IRModule]
+        The program after FuseOps.
+
+    Returns
+    -------
+    result : float
+      The modeled latency of the primitive functions in nanoseconds.
+    """
+    mod = expr if isinstance(expr, IRModule) else IRModule.from_expr(expr)
+    mod = transform.InferType()(mod)
+    return _ffi_api.EstimateFusedLatency(mod["main"])
+
+
+def data_movement_bytes(expr):
+    """
+    Count the bytes written by the layout transforms, transposes, reshapes and device
+    copies of a program, the data movement which SimplifyDataMovement eliminates.
+
+    Parameters
+    ----------
+    expr : Union[tvm.relay.Expr, tvm.IRModule]
+        The program.
+
+    Returns
+    -------
+    result : int
+      The number of bytes.
+    """
+    mod = expr if isinstance(expr, IRModule) else IRModule.from_expr(expr)
+    mod = transform.InferType()(mod)
+    return _ffi_api.data_movement_bytes(mod["main"])
+
+
 def unmatched_cases(match, mod=None):
     """
     Finds cases that the match expression does not catch, if any.
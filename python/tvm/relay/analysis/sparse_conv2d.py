@@ -0,0 +1,83 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""
+This file contains helper functions for convert 1x1 conv2d
+to block sparse dense
+"""
+import numpy as np
+import tvm
+from . import _ffi_api
+from .sparse_dense import SparseAnalysisResult, select_bsr_block_size, _replace_with_bsr
+
+
+def _search_conv2d_op_weight(expr):
+    """Search name and kernel layout of weight in all 1x1 NHWC ```nn.conv2d``` operator
+
+    Parameters
+    ----------
+    expr : relay.Expr
+        Expr will be searched
+
+    Returns
+    -------
+    ret : Array[Array[String]]
+        name and kernel layout of weight in all 1x1 NHWC ```nn.conv2d``` operator
+    """
+    return _ffi_api.search_conv2d_op_weight(expr)
+
+
+def process_params(expr, params, block_sizes, speedup_threshold, simd_width):
+    """Convert the 1x1 conv2d weights which are estimated to run faster as
+    BSR matrices, each with its own block size
+
+    Parameters
+    ----------
+    expr : Relay.Expr
+        Expr of the network
+    params : Dict[String, tvm.nd.array]
+        parameters of the network
+    block_sizes : List[Tuple(int, int)]
+        the candidate blocks
+    speedup_threshold : float
+        Minimal estimated speedup for converting to sparse operation
+    simd_width : int
+        number of float32 lanes of the vector unit
+
+    Returns
+    -------
+    ret : Namedtuple[weight_name: Array[String], weight_shape: Array[Array[IntImm]]]
+        return names of qualified conv2d weight and the shape in BSR format
+    """
+    memo = SparseAnalysisResult(weight_name=[], weight_shape=[])
+    for name, kernel_layout in _search_conv2d_op_weight(expr):
+        name = str(name)
+        if name in memo.weight_name or name not in params:
+            continue
+        w_np = params[name].asnumpy()
+        # the (out, in) matrix of the kernel
+        if kernel_layout == "HWIO":
+            w_np = np.ascontiguousarray(w_np.reshape(w_np.shape[2], w_np.shape[3]).T)
+        else:
+            w_np = w_np.reshape(w_np.shape[0], w_np.shape[3])
+        block_size, speedup = select_bsr_block_size(w_np, block_sizes, simd_width)
+        if block_size is not None and speedup >= speedup_threshold:
+            memo.weight_name.append(name)
+            memo.weight_shape.append(_replace_with_bsr(params, name, w_np, block_size))
+    return SparseAnalysisResult(
+        weight_name=tvm.runtime.convert(memo.weight_name),
+        weight_shape=tvm.runtime.convert(memo.weight_shape),
+    )
@@ -54,6 +54,60 @@ def _search_dense_op_weight(expr):
     return _ffi_api.search_dense_op_weight(expr)
 
 
+def _replace_with_bsr(params, name, w_np, block_size):
+    """Replace a dense weight in params by the arrays of its BSR matrix
+
+    Parameters
+    ----------
+    params : Dict[String, tvm.nd.array]
+        parameters of the network
+    name : String
+        name of the weight
+    w_np : numpy.ndarray
+        the weight as an (out, in) matrix
+    block_size : Tuple(int, int)
+        Blocksize in BSR matrix
+
+    Returns
+    -------
+    ret : List[int]
+        the shapes of the data, indices and indptr arrays of the BSR matrix
+    """
+    # pylint: disable=import-outside-toplevel
+    from tvm.auto_scheduler.search_task import (
+        register_task_input_buffer,
+    )  # lazily import to avoid recursive dependency
+
+    sparse_weight = sp.bsr_matrix(w_np, blocksize=block_size)
+    # remove dense weight
+    del params[name]
+    params[name + ".data"] = tvm.nd.array(sparse_weight.data)
+    params[name + ".indices"] = tvm.nd.array(sparse_weight.indices)
+    params[name + ".indptr"] = tvm.nd.array(sparse_weight.indptr)
+
+    prefix = "sparse_dense_bsr_%d_%d_%d_%d_%.2f_" % (
+        w_np.shape[0],
+        w_np.shape[1],
+        block_size[0],
+        block_size[1],
+        np.count_nonzero(w_np) / w_np.size,
+    )
+    register_task_input_buffer(
+        "default", prefix + "W_data", tvm.runtime.ndarray.array(sparse_weight.data)
+    )
+    register_task_input_buffer(
+        "default", prefix + "W_indices", tvm.runtime.ndarray.array(sparse_weight.indices)
+    )
+    register_task_input_buffer(
+        "default", prefix + "W_indptr", tvm.runtime.ndarray.array(sparse_weight.indptr)
+    )
+    return (
+        list(sparse_weight.data.shape)
+        + list(sparse_weight.indices.shape)
+        + list(sparse_weight.indptr.shape)
+    )
+
+
 def process_params(expr, params, block_size, sparsity_threshold):
     """[summary]
 
@@ -73,12 +127,6 @@ def process_params(expr, params, block_size, sparsity_threshold):
     ret : Namedtuple[weight_name: Array[String], weight_shape: Array[Array[IntImm]]]
         return names of qualified dense weight and the shape in BSR format
     """
-
-    # pylint: disable=import-outside-toplevel
-    from tvm.auto_scheduler.search_task import (
-        register_task_input_buffer,
-    )  # lazily import to avoid recursive dependency
-
     memo = SparseAnalysisResult(weight_name=[], weight_shape=[])
     weight_names = _search_dense_op_weight(expr)
     for name in weight_names:
@@ -86,37 +134,112 @@ def process_params(expr, params, block_size, sparsity_threshold):
         w_np = params[name].asnumpy()
         sparsity = 1.0 - (np.count_nonzero(w_np) / w_np.size)
         if sparsity >= sparsity_threshold:
-            sparse_weight = sp.bsr_matrix(w_np, blocksize=block_size)
-            # remove dense weight
-            del params[name]
             memo.weight_name.append(name)
-            memo.weight_shape.append(
-                list(sparse_weight.data.shape)
-                + list(sparse_weight.indices.shape)
-                + list(sparse_weight.indptr.shape)
-            )
-            params[name + ".data"] = tvm.nd.array(sparse_weight.data)
-            params[name + ".indices"] = tvm.nd.array(sparse_weight.indices)
-            params[name + ".indptr"] = tvm.nd.array(sparse_weight.indptr)
-
-            prefix = "sparse_dense_bsr_%d_%d_%d_%d_%.2f_" % (
-                w_np.shape[0],
-                w_np.shape[1],
-                block_size[0],
-                block_size[1],
-                1 - sparsity,
-            )
-            register_task_input_buffer(
-                "default", prefix + "W_data", tvm.runtime.ndarray.array(sparse_weight.data)
-            )
-            register_task_input_buffer(
-                "default", prefix + "W_indices", tvm.runtime.ndarray.array(sparse_weight.indices)
-            )
-            register_task_input_buffer(
-                "default", prefix + "W_indptr", tvm.runtime.ndarray.array(sparse_weight.indptr)
-            )
+            memo.weight_shape.append(_replace_with_bsr(params, name, w_np, block_size))
     ret = SparseAnalysisResult(
         weight_name=tvm.runtime.convert(memo.weight_name),
         weight_shape=tvm.runtime.convert(memo.weight_shape),
     )
     return ret
+
+
+# The candidate BSR blocks, whose rows are vectorized by the x86 schedule.
+DEFAULT_BLOCK_SIZES = [(1, 1), (4, 1), (8, 1), (16, 1), (32, 1), (16, 4)]
+
+
+def estimate_bsr_speedup(w_np, block_size, simd_width, block_overhead=1.0):
+    """Estimate the speedup of sparse_dense with a BSR weight over dense
+
+    The x86 schedule of sparse_dense vectorizes the rows of each block, so
+    a nonzero block costs one vector multiply-add per block column for every
+    vector of its rows, plus a fixed overhead to load its index. A dense
+    takes one vector multiply-add per vector of weights.
+
+    Parameters
+    ----------
+    w_np : numpy.ndarray
+        the weight as an (out, in) matrix
+    block_size : Tuple(int, int)
+        Blocksize in BSR matrix, which divides the shape of the weight
+    simd_width : int
+        number of float32 lanes of the vector unit
+    block_overhead : float
+        cost of visiting a nonzero block, in vector multiply-adds
+
+    Returns
+    -------
+    ret : float
+        the estimated speedup
+    """
+    bs_r, bs_c = block_size
+    rows, cols = w_np.shape
+    blocks = w_np.reshape(rows // bs_r, bs_r, cols // bs_c, bs_c)
+    num_blocks = np.count_nonzero(np.any(blocks != 0, axis=(1, 3)))
+    dense_cost = rows * cols / simd_width
+    sparse_cost = num_blocks * (bs_c * -(-bs_r // simd_width) + block_overhead)
+    return dense_cost / max(sparse_cost, 1.0)
+
+
+def select_bsr_block_size(w_np, block_sizes, simd_width):
+    """Select the BSR block of a weight with the highest estimated speedup
+
+    Parameters
+    ----------
+    w_np : numpy.ndarray
+        the weight as an (out, in) matrix
+    block_sizes : List[Tuple(int, int)]
+        the candidate blocks, those not dividing the shape of the weight are skipped
+    simd_width : int
+        number of float32 lanes of the vector unit
+
+    Returns
+    -------
+    ret : Tuple(Tuple(int, int), float)
+        the best block and its estimated speedup, or (None, 0.0) without candidates
+    """
+    best = (None, 0.0)
+    for block_size in block_sizes:
+        if w_np.shape[0] % block_size[0] or w_np.shape[1] % block_size[1]:
+            continue
+        speedup = estimate_bsr_speedup(w_np, block_size, simd_width)
+        if speedup > best[1]:
+            best = (tuple(block_size), speedup)
+    return best
+
+
+def process_params_auto(expr, params, block_sizes, speedup_threshold, simd_width):
+    """Convert the dense weights which are estimated to run faster as BSR
+    matrices, each with its own block size
+
+    Parameters
+    ----------
+    expr : Relay.Expr
+        Expr of the network
+    params : Dict[String, tvm.nd.array]
+        parameters of the network
+    block_sizes : List[Tuple(int, int)]
+        the candidate blocks
+    speedup_threshold : float
+        Minimal estimated speedup for converting to sparse operation
+    simd_width : int
+        number of float32 lanes of the vector unit
+
+    Returns
+    -------
+    ret : Namedtuple[weight_name: Array[String], weight_shape: Array[Array[IntImm]]]
+        return names of qualified dense weight and the shape in BSR format
+    """
+    memo = SparseAnalysisResult(weight_name=[], weight_shape=[])
+    for name in _search_dense_op_weight(expr):
+        name = str(name)
+        if name in memo.weight_name:
+            continue
+        w_np = params[name].asnumpy()
+        block_size, speedup = select_bsr_block_size(w_np, block_sizes, simd_width)
+        if block_size is not None and speedup >= speedup_threshold:
+            memo.weight_name.append(name)
+            memo.weight_shape.append(_replace_with_bsr(params, name, w_np, block_size))
+    return SparseAnalysisResult(
+        weight_name=tvm.runtime.convert(memo.weight_name),
+        weight_shape=tvm.runtime.convert(memo.weight_shape),
+    )
@@ -18,4 +18,5 @@
 """Optimizations involves changing of paramters"""
 
 from . import bsr_dense
+from . import bsr_auto
 from . import simplify_fc_transpose
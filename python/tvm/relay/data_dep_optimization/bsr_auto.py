@@ -0,0 +1,84 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=unused-argument, not-context-manager
+"""Automatic convert model from dense and 1x1 conv2d to block sparse,
+with a block size selected per layer"""
+
+import tvm
+from tvm import relay
+from tvm.relay.analysis import sparse_conv2d, sparse_dense
+
+from .utils import _run_opt_pass
+
+
+def convert(func, params, block_sizes=None, speedup_threshold=1.5, simd_width=None):
+    """Convert the dense and the 1x1 NHWC conv2d of a func to block sparse,
+    when their weights are estimated to run faster as BSR matrices
+
+    Unlike ```bsr_dense.convert```, the block size of each weight is
+    selected among the candidates by the estimated speedup of the x86
+    sparse_dense schedule, which depends on how the nonzeros of the
+    weight cluster.
+
+    Parameters
+    ----------
+    func : relay.Expr
+        Expr will be optimized to sparse operation
+    params : Dict[Srting, tvm.nd.array]
+        Parameters of the Expr
+    block_sizes : List[Tuple(int, int)]
+        Candidate blocksizes for BSR matrix, ```sparse_dense.DEFAULT_BLOCK_SIZES``` if None
+    speedup_threshold : float
+        Minimal estimated speedup over dense for converting.
+    simd_width : int
+        Number of float32 lanes of the vector unit, from the current target if None
+
+    Returns
+    -------
+    new_func: relay.Expr
+        Mutated Expr with sparse operations
+
+    params: Dict[Srting, tvm.nd.array]
+        New params with BSR matrix for mutated Expr
+    """
+    if block_sizes is None:
+        block_sizes = sparse_dense.DEFAULT_BLOCK_SIZES
+    if simd_width is None:
+        # pylint: disable=import-outside-toplevel
+        from tvm.topi.x86.utils import get_fp32_len
+
+        simd_width = get_fp32_len()
+
+    dense_info = sparse_dense.process_params_auto(
+        func, params, block_sizes, speedup_threshold, simd_width
+    )
+    func = _run_opt_pass(
+        func, relay.transform.DenseToSparse(dense_info.weight_name, dense_info.weight_shape)
+    )
+    conv_info = sparse_conv2d.process_params(
+        func, params, block_sizes, speedup_threshold, simd_width
+    )
+    func = _run_opt_pass(
+        func,
+        tvm.transform.Sequential(
+            [
+                relay.transform.InferType(),
+                relay.transform.Conv2dToSparse(conv_info.weight_name, conv_info.weight_shape),
+            ]
+        ),
+    )
+    return func, params
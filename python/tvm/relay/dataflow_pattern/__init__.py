@@ -498,6 +498,25 @@ def match(pattern: "DFPattern", expr: Expr) -> bool:
     return ffi.match(pattern, expr)
 
 
+def match_patterns(patterns: List["DFPattern"], expr: Expr) -> List[List[Expr]]:
+    """
+    Find the matches of a number of patterns in an expression in one walk of its graph
+
+    Parameters
+    ----------
+    patterns: List[tvm.relay.dataflow_pattern.DFPattern]
+        The input patterns.
+    expr : tvm.relay.Expr
+        The expression to match.
+
+    Returns
+    -------
+    result : List[List[tvm.relay.Expr]]
+        For each pattern, the expressions where a match of the pattern is rooted.
+    """
+    return ffi.match_patterns(patterns, expr)
+
+
 @register_df_node
 class ExprPattern(DFPattern):
     """A pattern which matches a constant expression.
@@ -18,6 +18,8 @@
 """Backend compiler related feature registration"""
 from __future__ import absolute_import
 
+import re
+
 from tvm import topi
 from tvm.topi.utils import get_const_tuple
 
@@ -271,6 +273,13 @@ def convert_conv2d(attrs, inputs, tinfos, desired_layouts):
     elif desired_data_layout == "HWNC":
         new_attrs["kernel_layout"] = "HWOI"
         return relay.nn.conv2d(data, weight, **new_attrs)
+    elif re.match(r"^NCHW\d+c$", desired_data_layout) and attrs["groups"] == 1:
+        # Blocked layouts are computed by contrib_conv2d_NCHWc, with the
+        # same block for the input and the output channels.
+        block = int(desired_data_layout[4:-1])
+        new_attrs["kernel_layout"] = "OIHW%di%do" % (block, block)
+        new_attrs["out_layout"] = desired_data_layout
+        return relay.nn.contrib_conv2d_nchwc(data, weight, **new_attrs)
 
     raise ValueError("Layout %s is not yet supported." % desired_data_layout)
 
@@ -322,6 +322,26 @@ def register_legalize(op_name, legal_op=None, level=10):
     return tvm.ir.register_op_attr(op_name, "FTVMLegalize", legal_op, level)
 
 
+def register_mixed_precision_conversion(op_name, func=None, level=10):
+    """Register the mixed precision conversion function of an op
+
+    Parameters
+    ----------
+    op_name : str
+        The name of the operator
+
+    func: function (call_node: relay.Call, mixed_precision_type: str)
+            -> [category: int, accumulation_dtype: str, output_dtype: str]
+        The function returning the category of the call, 0 to always convert it,
+        1 to follow its inputs and 2 to never convert it, the dtype accumulated
+        by the ops with an out_dtype attribute, and the dtype of the output.
+
+    level : int
+        The priority level
+    """
+    return tvm.ir.register_op_attr(op_name, "FTVMMixedPrecisionConversionType", func, level)
+
+
 def register_pattern(op_name, pattern, level=10):
     """Register operator pattern for an op.
 
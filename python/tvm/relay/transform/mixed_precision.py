@@ -0,0 +1,153 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=unused-argument
+"""The default op lists of ToMixedPrecision.
+
+The conversion of an op can be refined by registering another function
+with a higher level, for example to accumulate a dense in the mixed
+precision type on a target where that is accurate enough.
+"""
+from ..op.op import register_mixed_precision_conversion
+
+MIXED_PRECISION_ALWAYS = 0
+MIXED_PRECISION_FOLLOW = 1
+MIXED_PRECISION_NEVER = 2
+
+# The compute heavy ops, which accumulate in float32.
+DEFAULT_ALLOW_LIST = [
+    "nn.conv1d",
+    "nn.conv2d",
+    "nn.conv3d",
+    "nn.conv1d_transpose",
+    "nn.conv2d_transpose",
+    "nn.conv3d_transpose",
+    "nn.contrib_conv2d_NCHWc",
+    "nn.dense",
+]
+
+# The elementwise and data movement ops, which lose no accuracy when their
+# inputs are already in the mixed precision type.
+DEFAULT_FOLLOW_LIST = [
+    "add",
+    "subtract",
+    "multiply",
+    "divide",
+    "negative",
+    "abs",
+    "maximum",
+    "minimum",
+    "where",
+    "clip",
+    "nn.relu",
+    "nn.leaky_relu",
+    "nn.prelu",
+    "nn.bias_add",
+    "nn.dropout",
+    "nn.pad",
+    "nn.max_pool1d",
+    "nn.max_pool2d",
+    "nn.max_pool3d",
+    "nn.global_max_pool2d",
+    "nn.adaptive_max_pool2d",
+    "nn.batch_flatten",
+    "nn.depth_to_space",
+    "nn.space_to_depth",
+    "nn.upsampling",
+    "reshape",
+    "transpose",
+    "squeeze",
+    "expand_dims",
+    "concatenate",
+    "split",
+    "strided_slice",
+    "take",
+    "tile",
+    "repeat",
+    "broadcast_to",
+    "broadcast_to_like",
+    "layout_transform",
+    "copy",
+    "max",
+    "min",
+    "zeros_like",
+    "ones_like",
+]
+
+# The numerically sensitive ops: exponentials, reductions which accumulate
+# over many elements and normalizations.
+DEFAULT_DENY_LIST = [
+    "exp",
+    "log",
+    "log2",
+    "log10",
+    "sqrt",
+    "rsqrt",
+    "power",
+    "erf",
+    "sigmoid",
+    "tanh",
+    "fast_exp",
+    "fast_tanh",
+    "fast_erf",
+    "nn.softmax",
+    "nn.fast_softmax",
+    "nn.log_softmax",
+    "sum",
+    "mean",
+    "prod",
+    "variance",
+    "nn.avg_pool1d",
+    "nn.avg_pool2d",
+    "nn.avg_pool3d",
+    "nn.global_avg_pool2d",
+    "nn.adaptive_avg_pool2d",
+    "nn.batch_norm",
+    "nn.layer_norm",
+    "nn.instance_norm",
+    "nn.group_norm",
+    "nn.l2_normalize",
+    "nn.lrn",
+    "nn.cross_entropy",
+    "nn.cross_entropy_with_logits",
+    # batch_matmul has no out_dtype, so it would accumulate in the mixed
+    # precision type.
+    "nn.batch_matmul",
+]
+
+
+def always_convert(call_node, mixed_precision_type):
+    return [MIXED_PRECISION_ALWAYS, "float32", mixed_precision_type]
+
+
+def follow_inputs(call_node, mixed_precision_type):
+    return [MIXED_PRECISION_FOLLOW, mixed_precision_type, mixed_precision_type]
+
+
+def never_convert(call_node, mixed_precision_type):
+    return [MIXED_PRECISION_NEVER, "float32", "float32"]
+
+
+def register_default_lists():
+    for op_name in DEFAULT_ALLOW_LIST:
+        register_mixed_precision_conversion(op_name, always_convert)
+    for op_name in DEFAULT_FOLLOW_LIST:
+        register_mixed_precision_conversion(op_name, follow_inputs)
+    for op_name in DEFAULT_DENY_LIST:
+        register_mixed_precision_conversion(op_name, never_convert)
+
+
+register_default_lists()
@@ -91,6 +91,12 @@ class FunctionPass(tvm.ir.transform.Pass):
 def InferType():
     """Infer the type of an expr.
 
+    With the ``relay.InferType.incremental`` config set, only what changed since
+    the last inference is inferred again: the functions whose expressions all
+    kept their checked types are skipped, and in the other functions the
+    unchanged subexpressions built from constants, annotated variables and
+    operator calls keep their types.
+
     Returns
     -------
     ret : tvm.transform.Pass
@@ -260,6 +266,9 @@ def FoldConstantExpr(expr, mod):
 def FoldConstant():
     """Fold the constant expressions in a Relay program.
 
+    The constant subgraphs are evaluated together in one module, unless the
+    relay.FoldConstant.batched config is False.
+
     Returns
     -------
     ret : tvm.transform.Pass
@@ -271,6 +280,10 @@ def FoldConstant():
 def FuseOps(fuse_opt_level=-1):
     """Fuse operators in an expr to a larger operator according to some rules.
 
+    When the relay.FuseOps.cost_model config is set, a fusion allowed by the
+    rules is only done when it does not increase the latency modeled from the
+    memory traffic, the recomputation and the kernel launches.
+
     Parameters
     ----------
     fuse_opt_level : int
@@ -392,6 +405,46 @@ def CombineParallelBatchMatmul(min_num_branches=3):
     return _ffi_api.CombineParallelBatchMatmul(min_num_branches)
 
 
+def HorizontalFusion(min_num_branches=3):
+    """Fuse independent operators of the same shape from different branches
+    into one batched operator. Unlike the CombineParallel passes, the operators
+    do not need to share an input. For example:
+
+    .. code-block
+
+        x0 (2, 3)  y0 (2, 3)      x1 (2, 3)  y1 (2, 3)
+              \    /                   \    /
+               add                      add
+                |                        |
+               relu                     relu
+
+    Would become:
+
+    .. code-block
+
+        stack(x0, x1) (2, 2, 3)   stack(y0, y1) (2, 2, 3)
+                        \          /
+                            add
+                             |
+                            relu
+                             |
+                       split, squeeze
+
+    Elementwise and broadcast operators, dense and batch_matmul are batched.
+
+    Parameters
+    ----------
+    min_num_branches : int
+        The minimum number of independent operators to batch.
+
+    Returns
+    -------
+    ret: tvm.transform.Pass
+        The registered pass that fuses independent operators horizontally.
+    """
+    return _ffi_api.HorizontalFusion(min_num_branches)
+
+
 def BatchingOps():
     """Batching parallel operators into one for Conv2D, Dense and BatchMatmul.
 
@@ -477,6 +530,81 @@ def ConvertLayout(desired_layouts):
     return _ffi_api.ConvertLayout(desired_layouts)
 
 
+def PlanLayout():
+    """Choose the data layout of every conv2d of a function together.
+
+    ConvertLayout converts every conv2d to one layout given by the user. This
+    pass instead chooses the layout of each conv2d among NCHW, NHWC and
+    NCHW[x]c, weighing the cost of the convolution in each layout against the
+    cost of the layout transforms between convolutions of different layouts.
+    The ops in between that adapt to the layout of their input, such as
+    elementwise ops and pooling, carry the layout from one conv2d to the next.
+    The assignment is solved by dynamic programming over the graph.
+
+    The costs are estimated by an analytic model, tuned with the
+    ``relay.PlanLayout.cost_model`` config, whose fields are ``blocks``, the
+    channel blocks of the candidate NCHW[x]c layouts, ``vector_bits`` and
+    ``register_bits``, the widths of a vector register and of all of them,
+    ``bandwidth`` in bytes per nanosecond, ``throughput`` in flops per
+    nanosecond and ``launch_overhead`` in nanoseconds.
+
+    Blocked layouts are computed by ``nn.contrib_conv2d_NCHWc``, and the
+    weights are expected to be constants, whose transforms are folded by
+    FoldConstant.
+
+    Returns
+    -------
+    pass: FunctionPass
+      The pass.
+    """
+    return _ffi_api.PlanLayout()
+
+
+def ToMixedPrecision(
+    mixed_precision_type="float16", allow_list=None, deny_list=None, follow_list=None
+):
+    """Rewrite a float32 graph to compute in a lower precision float type.
+
+    Ops in the allow list, such as convolutions and dense, are always computed
+    in the mixed precision type. Ops in the follow list, such as elementwise and
+    data movement ops, are computed in the mixed precision type when all their
+    floating point inputs are. Ops in the deny list, the numerically sensitive
+    ones such as softmax, reductions and normalizations, stay in float32.
+    Ops of the allow list accumulate in float32 through their ``out_dtype``,
+    and those without one, such as batch_matmul, stay in float32.
+
+    The default lists are registered in ``relay.transform.mixed_precision``,
+    and the lists passed here take precedence over them. Each expression is
+    cast at most once to each type, and casts back to the type of their input
+    are removed. FoldConstant should run after this pass to cast the weights
+    ahead of time.
+
+    Parameters
+    ----------
+    mixed_precision_type : str
+        The lower precision type, "float16" or "bfloat16".
+
+    allow_list : Optional[List[str]]
+        The names of the ops to always convert.
+
+    deny_list : Optional[List[str]]
+        The names of the ops to never convert.
+
+    follow_list : Optional[List[str]]
+        The names of the ops following the precision of their inputs.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass.
+    """
+    op_categories = {}
+    for ops, category in [(allow_list, 0), (follow_list, 1), (deny_list, 2)]:
+        for op in ops or []:
+            op_categories[op] = category
+    return _ffi_api.ToMixedPrecision(mixed_precision_type, op_categories)
+
+
 def Legalize(legalize_map_attr_name="FTVMLegalize"):
     """Legalizes an expression with another expression.
     This pass can be used to replace an expr with another expr for target
@@ -830,6 +958,29 @@ def FirstOrderGradient():
     return _ffi_api.FirstOrderGradient()
 
 
+def Rematerialize(memory_budget):
+    """Recompute cheap activations right before their late uses instead of keeping them
+    alive, until the storage the graph executor plans for the function fits the budget.
+
+    This lowers the peak memory of training graphs, in which the gradient passes keep the
+    forward activations alive until the backward computation. The budget can also be set
+    for relay.build with the relay.backend.memory_budget config. Functions with control
+    flow, closures or references are not changed.
+
+    Parameters
+    ----------
+    memory_budget : int
+        The number of bytes the storage may take, including the parameters and the
+        constants. The pass does nothing if it is 0.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered Rematerialize pass.
+    """
+    return _ffi_api.Rematerialize(memory_budget)
+
+
 def Defunctionalization(func, mod):
     """
     Performs defunctionalization on func,
@@ -1092,6 +1243,29 @@ def DenseToSparse(weight_name, weight_shape):
     return _ffi_api.DenseToSparse(weight_name, weight_shape)
 
 
+def Conv2dToSparse(weight_name, weight_shape):
+    """
+    Rewrite qualified 1x1 NHWC ```nn.conv2d operation``` to ```nn.sparse_dense```
+    on the pixels of the input reshaped into rows
+    This pass is used in ```data_dep_optimization.bsr_auto```
+    Parameters of this pass is generated by ```analysis.sparse_conv2d.process_params```
+
+    Parameters
+    ----------
+    weight_name: Array[String]
+      Names of weights which qualified sparse contrains
+
+    weight_shape: Array[Array[IntImm]]
+      Weights shape in BSR format.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered Conv2dToSparse pass.
+    """
+    return _ffi_api.Conv2dToSparse(weight_name, weight_shape)
+
+
 def SimplifyFCTranspose(target_weight_name):
     """
     Rewrite ```y = nn.dense(x, transpose(w, [1, 0]))``` to ```y = nn.dense(x, wt)```
@@ -1123,6 +1297,21 @@ def SimplifyExpr():
     return _ffi_api.SimplifyExpr()
 
 
+def SimplifyDataMovement():
+    """
+    Canonicalize the layout transforms, transposes, reshapes and device copies over the
+    whole graph: remove those which leave their input as it is, cancel those followed by
+    their inverse, and merge those in a row into one. The bytes written by these ops
+    before and after the pass are given by relay.analysis.data_movement_bytes.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered SimplifyDataMovement pass.
+    """
+    return _ffi_api.SimplifyDataMovement()
+
+
 def FoldExplicitPadding():
     """
     FoldExplicitPadding finds explict padding before an op that can support
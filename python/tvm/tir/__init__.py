@@ -55,3 +55,5 @@ from . import ir_builder
 from . import transform
 from . import analysis
 from . import stmt_functor
+from . import loop_profile
+from . import shape_profile
@@ -0,0 +1,92 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Profile-guided loop unrolling and partitioning.
+
+The loops are first instrumented with trip count and time counters, the
+instrumented module is run on representative inputs, and the same schedule
+is rebuilt with the recorded profile:
+
+.. code-block:: python
+
+    with tvm.transform.PassContext(config={"tir.LoopProfile": {"instrument": True}}):
+        f = tvm.build(s, args, "llvm")
+    tvm.tir.loop_profile.reset()
+    f(*inputs)
+    tvm.tir.loop_profile.save("profile.json")
+
+    profile = tvm.tir.loop_profile.load("profile.json")
+    with tvm.transform.PassContext(config={"tir.LoopProfile": {"profile": profile}}):
+        f = tvm.build(s, args, "llvm")
+
+The loops are keyed by the name of their function and their position in it,
+so the profile only applies to the same schedule lowered the same way.
+"""
+import json
+
+import tvm.runtime._ffi_api
+
+
+def collect():
+    """Collect the counters of the instrumented loops run in this process.
+
+    Returns
+    -------
+    profile : Dict[str, List[int]]
+        The number of entries, the number of iterations and the time in
+        nanoseconds of each loop.
+    """
+    return json.loads(tvm.runtime._ffi_api.LoopProfileDump())
+
+
+def reset():
+    """Reset the counters of the instrumented loops."""
+    tvm.runtime._ffi_api.LoopProfileReset()
+
+
+def save(path, profile=None):
+    """Save a loop profile to a json file.
+
+    Parameters
+    ----------
+    path : str
+        The path of the file.
+
+    profile : Optional[Dict[str, List[int]]]
+        The profile to save, the current counters by default.
+    """
+    profile = collect() if profile is None else profile
+    with open(path, "w") as f:
+        json.dump(profile, f, indent=2, sort_keys=True)
+
+
+def load(path):
+    """Load a loop profile saved with :py:func:`save`.
+
+    Parameters
+    ----------
+    path : str
+        The path of the file.
+
+    Returns
+    -------
+    profile : Dict[str, List[float]]
+        The profile, which can be passed as the "profile" field of the
+        "tir.LoopProfile" pass config.
+    """
+    with open(path) as f:
+        profile = json.load(f)
+    return {key: [float(x) for x in value] for key, value in profile.items()}
@@ -0,0 +1,61 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Learn the hot values of the symbolic shapes from the observed calls.
+
+The returned values feed the "tir.SpecializeShapes" pass config:
+
+.. code-block:: python
+
+    samples = [{"n": x.shape[0]} for x in observed_inputs]
+    config = {"tir.SpecializeShapes": {"hot_values": shape_profile.hot_values(samples)}}
+    with tvm.transform.PassContext(config=config):
+        f = tvm.build(s, [A, B], "llvm")
+"""
+from collections import Counter
+
+
+def hot_values(samples, max_values=2, min_share=0.1):
+    """Select the most frequent values of each symbolic shape.
+
+    Parameters
+    ----------
+    samples : List[Dict[str, int]]
+        The values of the symbolic shapes, keyed by the name of the
+        variable, one dict per observed call.
+
+    max_values : int
+        The maximum number of values of a shape.
+
+    min_share : float
+        The minimum fraction of the calls a value must cover.
+
+    Returns
+    -------
+    hot_values : Dict[str, List[int]]
+        The hot values of each shape, from the most frequent one.
+    """
+    counters = {}
+    for sample in samples:
+        for name, value in sample.items():
+            counters.setdefault(name, Counter())[int(value)] += 1
+    result = {}
+    for name, counter in counters.items():
+        total = sum(counter.values())
+        values = [v for v, c in counter.most_common(max_values) if c >= min_share * total]
+        if values:
+            result[name] = values
+    return result
@@ -73,6 +73,86 @@ def InjectPrefetch():
     return _ffi_api.InjectPrefetch()
 
 
+def LoopTiling():
+    """Tile and reorder the perfectly nested loops so that the data
+    touched by each tile fits into the L1/L2 cache.
+
+    The cache sizes can be configured with the "tir.LoopTiling"
+    pass config, e.g. ``{"l1_cache_bytes": 32768, "l2_cache_bytes": 262144}``.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.LoopTiling()
+
+
+def InjectSoftwarePrefetch():
+    """Prefetch the strided and indirect loads of the innermost loops
+    a few iterations ahead.
+
+    Only applies to the functions with an LLVM target. The parameters can be
+    configured with the "tir.InjectSoftwarePrefetch" pass config, e.g.
+    ``{"distance": 16, "cache_line_bytes": 64, "max_prefetch_per_loop": 4}``.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.InjectSoftwarePrefetch()
+
+
+def VectorizeReduction():
+    """Accumulate the commutative reductions of the innermost loops
+    into the lanes of a vector, and combine the lanes after the loop.
+
+    Only applies to the functions with an LLVM target. The accumulator width
+    can be configured with the "tir.VectorizeReduction" pass config, e.g.
+    ``{"vector_bits": 512}``.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.VectorizeReduction()
+
+
+def IndexStrengthReduction():
+    """Hoist the loop invariant index computations, and replace the
+    floordiv/floormod of the indices which are affine in the variable of
+    an innermost serial loop with incrementally updated counters.
+
+    The div/mod by powers of two are kept unless ``reduce_power_of_two``
+    is set in the "tir.IndexStrengthReduction" pass config.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.IndexStrengthReduction()
+
+
+def SpecializeShapes():
+    """Specialize the body of each function on the values of its symbolic
+    shapes, and dispatch among the variants and the generic body at call time.
+
+    The variants are read from the "tir.SpecializeShapes" pass config, e.g.
+    ``{"hot_values": {"n": [64, 128]}, "divisors": [8], "max_variants": 8}``.
+    The hot values can be learned from the observed shapes with
+    :py:func:`tvm.tir.shape_profile.hot_values`.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.SpecializeShapes()
+
+
 def StorageFlatten(cache_line_size, create_bound_attribute=False):
     """Flatten the multi-dimensional read/write to 1D.
 
@@ -140,6 +220,24 @@ def LiftAttrScope(attr_key):
     return _ffi_api.LiftAttrScope(attr_key)
 
 
+def LoopProfile():
+    """Profile-guided loop optimization.
+
+    The pass is configured with the "tir.LoopProfile" pass config. With
+    ``instrument`` set, the loops are wrapped with trip count and time counters,
+    which are read back with :py:func:`tvm.tir.loop_profile.collect`. With the
+    ``profile`` of an instrumented run, cold loops are kept rolled and
+    unpartitioned, while hot loops are unrolled or partitioned. See
+    :py:mod:`tvm.tir.loop_profile` for the end-to-end flow.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.LoopProfile()
+
+
 def LoopPartition():
     """Inject virtual thread loops.
 
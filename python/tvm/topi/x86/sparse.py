@@ -28,7 +28,7 @@ def schedule_sparse_dense(outs):
 
     def _callback(op):
         simd_width = get_fp32_len()
-        if op.tag == "sparse_dense_sp_lhs_csrmm" or op.tag == "sparse_dense_sp_lhs_csrmm":
+        if op.tag == "sparse_dense_sp_lhs_csrmm" or op.tag == "sparse_dense_sp_rhs_csrmm":
             (y_o, y_i) = s[op].split(s[op].op.axis[1], 2)
             fused = s[op].fuse(s[op].op.axis[0], y_o)
             s[op].parallel(fused)
@@ -43,7 +43,9 @@ def schedule_sparse_dense(outs):
             (m, num_blocks, b_r) = s[y_bsrmm].op.axis
             bs_r = get_const_int(b_r.dom.extent)
             (elem_idx, c) = s[y_bsrmm].op.reduce_axis
-            s[y_bsrmm].reorder(num_blocks, m, elem_idx, b_r, c)
+            s[y_bsrmm].reorder(num_blocks, m, elem_idx, c, b_r)
+            # Each column of a block is one vector multiply-add over its rows.
+            s[y_bsrmm].unroll(c)
             s[y_bsrmm].vectorize(b_r)
             (m_o, n_o) = s[y_reshape].op.axis
             (noo, noi) = s[y_reshape].split(n_o, bs_r)
@@ -25,6 +25,8 @@
 #include <tvm/tir/expr.h>
 #include <tvm/tir/op.h>
 
+#include "analyzer_memo.h"
+
 namespace tvm {
 namespace arith {
 
@@ -35,6 +37,20 @@ Analyzer::Analyzer()
       canonical_simplify(this),
       int_set(this) {}
 
+Analyzer::~Analyzer() {}
+
+void Analyzer::EnableMemo(bool enable) {
+  if (!enable) {
+    memo_.reset();
+  } else if (memo_ == nullptr) {
+    memo_.reset(new Memo());
+  }
+}
+
+void Analyzer::ClearMemo() {
+  if (memo_ != nullptr) memo_->Clear();
+}
+
 void Analyzer::Bind(const Var& var, const PrimExpr& expr, bool allow_override) {
   PrimExpr new_expr = expr;
   new_expr = this->canonical_simplify(new_expr);
@@ -69,11 +85,14 @@ void ConstraintContext::EnterWithScope() {
   auto f0 = analyzer_->const_int_bound.EnterConstraint(constraint_);
   auto f1 = analyzer_->modular_set.EnterConstraint(constraint_);
   auto f2 = analyzer_->rewrite_simplify.EnterConstraint(constraint_);
+  if (analyzer_->memo_ != nullptr) analyzer_->memo_->EnterScope();
   // recovery function.
-  exit_ = [f0, f1, f2]() {
+  Analyzer* analyzer = analyzer_;
+  exit_ = [f0, f1, f2, analyzer]() {
     if (f2 != nullptr) f2();
     if (f1 != nullptr) f1();
     if (f0 != nullptr) f0();
+    if (analyzer->memo_ != nullptr) analyzer->memo_->ExitScope();
   };
 }
 
@@ -124,6 +143,15 @@ bool Analyzer::CanProve(const PrimExpr& expr) {
 
 PrimExpr Analyzer::Simplify(const PrimExpr& expr, int steps) {
   if (tir::is_const_int(expr)) return expr;
+  if (memo_ != nullptr) {
+    return memo_->Memoize<PrimExpr>(
+        expr, [steps](Memo::Scope* scope) { return &scope->simplify[steps]; },
+        [this, &expr, steps]() { return this->SimplifyImpl(expr, steps); });
+  }
+  return SimplifyImpl(expr, steps);
+}
+
+PrimExpr Analyzer::SimplifyImpl(const PrimExpr& expr, int steps) {
   PrimExpr res = expr;
   for (int i = 0; i < steps; ++i) {
     res = this->rewrite_simplify(res);
@@ -176,6 +204,8 @@ TVM_REGISTER_GLOBAL("arith.CreateAnalyzer").set_body([](TVMArgs args, TVMRetValu
           self->Bind(args[0], args[1].operator PrimExpr());
         }
       });
+    } else if (name == "enable_memo") {
+      return PackedFunc([self](TVMArgs args, TVMRetValue* ret) { self->EnableMemo(args[0]); });
     } else if (name == "enter_constraint_context") {
       return PackedFunc([self](TVMArgs args, TVMRetValue* ret) {
         // can't use make_shared due to noexcept(false) decl in destructor,
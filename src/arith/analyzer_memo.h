@@ -0,0 +1,128 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file analyzer_memo.h
+ * \brief Memo table of the analyzer results keyed by the structure of the expressions.
+ */
+#ifndef TVM_ARITH_ANALYZER_MEMO_H_
+#define TVM_ARITH_ANALYZER_MEMO_H_
+
+#include <tvm/arith/analyzer.h>
+#include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace arith {
+
+/*!
+ * \brief Memo table of Simplify, canonical_simplify and const_int_bound.
+ *
+ *  The results only hold under the constraints in effect when they are computed,
+ *  so there is one table per constraint scope. Entering a scope starts an empty table
+ *  and exiting it restores the table of the enclosing scope.
+ */
+class Analyzer::Memo {
+ public:
+  template <typename T>
+  using ExprMap = std::unordered_map<PrimExpr, T, StructuralHash, StructuralEqual>;
+
+  /*! \brief The memoized results under one constraint scope. */
+  struct Scope {
+    /*! \brief Results of Simplify, indexed by the number of steps. */
+    std::unordered_map<int, ExprMap<PrimExpr>> simplify;
+    /*! \brief Results of canonical_simplify. */
+    ExprMap<PrimExpr> canonical_simplify;
+    /*! \brief Results of const_int_bound. */
+    ExprMap<ConstIntBound> const_int_bound;
+
+    void Clear() {
+      simplify.clear();
+      canonical_simplify.clear();
+      const_int_bound.clear();
+    }
+  };
+
+  Memo() : scopes_(1) {}
+
+  /*!
+   * \brief Look up the result of expr, compute and record it on a miss.
+   * \param expr The expression of interest.
+   * \param ftable Function that returns the table to use in a scope.
+   * \param fcompute Function that computes the result.
+   * \return The result.
+   */
+  template <typename T, typename FTable, typename FCompute>
+  T Memoize(const PrimExpr& expr, FTable ftable, FCompute fcompute) {
+    // Nested queries see intermediate expressions that are rarely repeated,
+    // hashing them would cost more than it saves.
+    if (depth_ != 0) return fcompute();
+    ExprMap<T>* table = ftable(&scopes_.back());
+    auto it = table->find(expr);
+    if (it != table->end()) return it->second;
+    T result;
+    {
+      DepthGuard guard(&depth_);
+      result = fcompute();
+    }
+    // look up the table again, fcompute may have entered and exited constraint scopes.
+    ftable(&scopes_.back())->emplace(expr, result);
+    return result;
+  }
+
+  /*! \brief Start a new table when entering a constraint scope. */
+  void EnterScope() { scopes_.emplace_back(); }
+
+  /*! \brief Drop the table of the innermost constraint scope. */
+  void ExitScope() {
+    if (scopes_.size() > 1) {
+      scopes_.pop_back();
+    } else {
+      // The scope was entered before the memo got enabled.
+      scopes_.back().Clear();
+    }
+  }
+
+  /*! \brief Clear the tables of all the scopes. */
+  void Clear() {
+    for (Scope& scope : scopes_) {
+      scope.Clear();
+    }
+  }
+
+ private:
+  /*! \brief Increase the query depth within its lifetime. */
+  struct DepthGuard {
+    explicit DepthGuard(int* depth) : depth(depth) { ++*depth; }
+    ~DepthGuard() { --*depth; }
+    int* depth;
+  };
+
+  /*! \brief The tables, one for each constraint scope. */
+  std::vector<Scope> scopes_;
+  /*! \brief The depth of the memoized queries in progress. */
+  int depth_{0};
+};
+
+}  // namespace arith
+}  // namespace tvm
+#endif  // TVM_ARITH_ANALYZER_MEMO_H_
@@ -25,6 +25,7 @@
 #include <tvm/tir/analysis.h>
 #include <tvm/tir/op.h>
 
+#include "analyzer_memo.h"
 #include "const_fold.h"
 #include "pattern_match.h"
 #include "rewrite_simplify.h"
@@ -1233,14 +1234,21 @@ PrimExpr CanonicalSimplifier::Impl::VisitExpr_(const CastNode* op) {
 }
 
 PrimExpr CanonicalSimplifier::operator()(const PrimExpr& expr) {
+  if (parent_->memo_ != nullptr) {
+    return parent_->memo_->Memoize<PrimExpr>(
+        expr, [](Analyzer::Memo::Scope* scope) { return &scope->canonical_simplify; },
+        [this, &expr]() { return impl_->CanonicalSimplify(expr); });
+  }
   return impl_->CanonicalSimplify(expr);
 }
 
 void CanonicalSimplifier::Update(const Var& var, const PrimExpr& info, bool override) {
   impl_->Update(var, info, override);
+  parent_->ClearMemo();
 }
 
-CanonicalSimplifier::CanonicalSimplifier(Analyzer* parent) : impl_(new Impl(parent)) {}
+CanonicalSimplifier::CanonicalSimplifier(Analyzer* parent)
+    : impl_(new Impl(parent)), parent_(parent) {}
 
 CanonicalSimplifier::~CanonicalSimplifier() { delete impl_; }
 
@@ -27,6 +27,7 @@
 
 #include <algorithm>
 
+#include "analyzer_memo.h"
 #include "int_operator.h"
 #include "pattern_match.h"
 
@@ -605,8 +606,15 @@ class ConstIntBoundAnalyzer::Impl
 };
 
 ConstIntBound ConstIntBoundAnalyzer::operator()(const PrimExpr& expr) {
-  Entry ret = impl_->VisitExpr(expr);
-  return ConstIntBound(ret.min_value, ret.max_value);
+  auto fcompute = [this, &expr]() {
+    Entry ret = impl_->VisitExpr(expr);
+    return ConstIntBound(ret.min_value, ret.max_value);
+  };
+  if (parent_->memo_ != nullptr) {
+    return parent_->memo_->Memoize<ConstIntBound>(
+        expr, [](Analyzer::Memo::Scope* scope) { return &scope->const_int_bound; }, fcompute);
+  }
+  return fcompute();
 }
 
 ConstIntBound ConstIntBoundAnalyzer::operator()(const PrimExpr& expr, BoundMapType* bound) {
@@ -618,17 +626,20 @@ ConstIntBound ConstIntBoundAnalyzer::operator()(const PrimExpr& expr, BoundMapTy
 
 void ConstIntBoundAnalyzer::Update(const Var& var, const ConstIntBound& info, bool allow_override) {
   impl_->Update(var, info, allow_override);
+  parent_->ClearMemo();
 }
 
 void ConstIntBoundAnalyzer::Bind(const Var& var, const Range& range, bool allow_override) {
   impl_->Bind(var, range, allow_override);
+  parent_->ClearMemo();
 }
 
 std::function<void()> ConstIntBoundAnalyzer::EnterConstraint(const PrimExpr& constraint) {
   return impl_->EnterConstraint(constraint);
 }
 
-ConstIntBoundAnalyzer::ConstIntBoundAnalyzer(Analyzer* parent) : impl_(new Impl()) {}
+ConstIntBoundAnalyzer::ConstIntBoundAnalyzer(Analyzer* parent)
+    : impl_(new Impl()), parent_(parent) {}
 
 ConstIntBoundAnalyzer::~ConstIntBoundAnalyzer() { delete impl_; }
 
@@ -100,6 +100,7 @@ class ModularSetAnalyzer::Impl : public ExprFunctor<ModularSetAnalyzer::Entry(co
       }
     }
     var_map_[var] = Entry(info->coeff, info->base);
+    parent_->ClearMemo();
   }
 
   // Detect useful constraints and use them in the analysis scope.
@@ -115,6 +115,7 @@ void RewriteSimplifier::Impl::Update(const Var& var, const PrimExpr& info, bool
     }
   }
   var_map_[var] = info;
+  analyzer_->ClearMemo();
 }
 
 PrimExpr RewriteSimplifier::Impl::VisitExpr_(const AddNode* op) {
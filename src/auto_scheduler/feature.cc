@@ -495,11 +495,201 @@ void ComputeRegion(const std::vector<std::vector<PrimExpr>>& indices, arith::Ana
   }
 }
 
+// An index expression compiled into the affine form
+//   base + sum_k coeffs[k] * (loop_var[k] - loop_min[k]),
+// where k is the position of the loop in the loop stack of a BufferStore.
+// It lets us compute the region, stride and reuse features with plain integer arithmetic
+// instead of running the arithmetic analyzer and visitors on every access for every loop.
+struct AffineIndex {
+  // The value of the index when all loop vars are at their minimums
+  int64_t base{0};
+  // The coefficient of each loop var
+  std::vector<int64_t> coeffs;
+  // Whether each loop var appears in the index
+  std::vector<bool> uses;
+  // The coefficient of each loop var reported by CoefficientExtractor
+  std::vector<int> strides;
+};
+
+// Compile the indices of buffer accesses into the affine form.
+// Only the indices the arithmetic analyzer bounds exactly are compiled, i.e., sums of integer
+// constants, loop vars and loop vars multiplied by integer constants, where every loop var
+// appears at most once and all loops have constant bounds. So the features computed from
+// the affine form are the same as the ones computed by ComputeRegion and ComputeStride.
+class AffineIndexCompiler {
+ public:
+  explicit AffineIndexCompiler(const std::vector<const ForNode*>& for_loop_stack) {
+    for (size_t i = 0; i < for_loop_stack.size(); ++i) {
+      const ForNode* node = for_loop_stack[i];
+      const auto* pmin = node->min.as<IntImmNode>();
+      const auto* pext = node->extent.as<IntImmNode>();
+      if (pmin != nullptr && pext != nullptr && pext->value >= 1) {
+        loop_level_[node->loop_var.get()] = i;
+        loop_mins_.push_back(pmin->value);
+      } else {
+        // The loop var can not appear in a compiled index
+        loop_level_[node->loop_var.get()] = -1;
+        loop_mins_.push_back(0);
+      }
+    }
+  }
+
+  // Compile the indices of all accesses to a buffer. Return false if any index is not affine.
+  bool Compile(const std::vector<std::vector<PrimExpr>>& indices,
+               std::vector<std::vector<AffineIndex>>* ret) {
+    size_t n_loops = loop_mins_.size();
+    ret->clear();
+    ret->reserve(indices.size());
+    for (const auto& access : indices) {
+      ret->emplace_back();
+      ret->back().reserve(access.size());
+      for (const auto& index : access) {
+        ret->back().emplace_back();
+        AffineIndex& aff = ret->back().back();
+        aff.coeffs.assign(n_loops, 0);
+        aff.uses.assign(n_loops, false);
+        aff.strides.assign(n_loops, 0);
+        visited_mul_.assign(n_loops, false);
+        visited_add_.assign(n_loops, false);
+        if (!Visit(index, 1, &aff)) {
+          return false;
+        }
+        for (size_t k = 0; k < n_loops; ++k) {
+          if (aff.uses[k] && !visited_mul_[k] && !visited_add_[k]) {
+            aff.strides[k] = 1;
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+ private:
+  // Accumulate `sign * expr` into `aff`. Besides the affine form, it also replays the state
+  // machine of CoefficientExtractor for all loop vars in the same visiting order.
+  bool Visit(const PrimExpr& expr, int64_t sign, AffineIndex* aff) {
+    if (const auto* op = expr.as<IntImmNode>()) {
+      aff->base += sign * op->value;
+      return true;
+    } else if (const auto* op = expr.as<VarNode>()) {
+      return VisitLoopVar(op, sign, aff);
+    } else if (const auto* op = expr.as<AddNode>()) {
+      if (!Visit(op->a, sign, aff) || !Visit(op->b, sign, aff)) {
+        return false;
+      }
+      for (size_t k = 0; k < aff->uses.size(); ++k) {
+        if (aff->uses[k] && !visited_mul_[k]) {
+          visited_add_[k] = true;
+          aff->strides[k] = 1;
+        }
+      }
+      return true;
+    } else if (const auto* op = expr.as<SubNode>()) {
+      return Visit(op->a, sign, aff) && Visit(op->b, -sign, aff);
+    } else if (const auto* op = expr.as<MulNode>()) {
+      const VarNode* var = op->a.as<VarNode>();
+      const IntImmNode* factor = op->b.as<IntImmNode>();
+      if (var == nullptr) {
+        var = op->b.as<VarNode>();
+        factor = op->a.as<IntImmNode>();
+      }
+      if (var == nullptr || factor == nullptr || !VisitLoopVar(var, sign * factor->value, aff)) {
+        return false;
+      }
+      for (size_t k = 0; k < aff->uses.size(); ++k) {
+        if (aff->uses[k] && !visited_add_[k]) {
+          visited_mul_[k] = true;
+          aff->strides[k] = factor->value;
+        }
+      }
+      return true;
+    }
+    return false;
+  }
+
+  bool VisitLoopVar(const VarNode* var, int64_t coeff, AffineIndex* aff) {
+    auto it = loop_level_.find(var);
+    if (it == loop_level_.end() || it->second < 0 || aff->uses[it->second]) {
+      return false;
+    }
+    int k = it->second;
+    aff->uses[k] = true;
+    aff->coeffs[k] = coeff;
+    aff->base += coeff * loop_mins_[k];
+    // The magic default stride of CoefficientExtractor
+    aff->strides[k] = 2;
+    return true;
+  }
+
+  // The position of each loop var in the loop stack, -1 for loops with non-constant bounds
+  std::unordered_map<const VarNode*, int> loop_level_;
+  // The minimum of each loop
+  std::vector<int64_t> loop_mins_;
+  // The state of CoefficientExtractor for each loop var
+  std::vector<bool> visited_mul_;
+  std::vector<bool> visited_add_;
+};
+
+// Compute stride for the accesses to a buffer in the affine form
+int64_t ComputeStride(const std::vector<std::vector<AffineIndex>>& indices,
+                      const std::vector<int>& shape, int loop_level) {
+  int64_t min_stride = std::numeric_limits<int64_t>::max();
+  bool find = false;
+
+  for (const auto& index : indices) {
+    int64_t shape_stride = 1;
+    for (int i = static_cast<int>(index.size()) - 1; i >= 0; i--) {
+      if (index[i].uses[loop_level]) {
+        find = true;
+        min_stride = std::min(min_stride, std::abs(index[i].strides[loop_level]) * shape_stride);
+        break;
+      }
+      shape_stride *= shape[i];
+    }
+  }
+
+  return find ? min_stride : 0;
+}
+
+// Compute touched region for accesses to a buffer in the affine form, where the loops
+// [loop_level, end) span their full ranges and the outer loops stay at their minimums
+void ComputeRegion(const std::vector<std::vector<AffineIndex>>& indices,
+                   const std::vector<int64_t>& loop_extents, int loop_level,
+                   std::vector<int>* region) {
+  region->clear();
+
+  if (indices.empty()) {
+    return;
+  }
+
+  region->reserve(indices[0].size());
+
+  for (size_t i = 0; i < indices[0].size(); ++i) {
+    int64_t minimum = ConstIntBound::kPosInf, maximum = ConstIntBound::kNegInf;
+    for (size_t j = 0; j < indices.size(); ++j) {
+      const AffineIndex& index = indices[j][i];
+      int64_t lower = index.base, upper = index.base;
+      for (size_t k = loop_level; k < loop_extents.size(); ++k) {
+        int64_t delta = index.coeffs[k] * (loop_extents[k] - 1);
+        if (delta > 0) {
+          upper += delta;
+        } else {
+          lower += delta;
+        }
+      }
+      minimum = std::min(minimum, lower);
+      maximum = std::max(maximum, upper);
+    }
+    region->push_back(maximum - minimum + 1);
+  }
+}
+
 // Compute reuse distance and reuse ratio for accesses to a buffer
+// `use_loop(i)` returns whether the indices of the accesses use the i-th loop of the stack
 // return values: reuse_type, reuse_dis_iter, reuse_dis_bytes, reuse_ct
+template <typename FUseLoop>
 std::tuple<ReuseType, float, float, float> ComputeReuse(
-    const Buffer& buf, const std::vector<std::vector<PrimExpr>>& indices,
-    const std::vector<const ForNode*>& for_loop_stack,
+    const Buffer& buf, FUseLoop use_loop, const std::vector<const ForNode*>& for_loop_stack,
     const std::unordered_map<const ForNode*,
                              BufferMap<std::vector<std::tuple<BufferAccessType, int64_t, int>>>>&
         for_touch_regions) {
@@ -508,19 +698,7 @@ std::tuple<ReuseType, float, float, float> ComputeReuse(
 
   for (int i = static_cast<int>(for_loop_stack.size()) - 1; i >= 0; --i) {
     const ForNode* cur_for = for_loop_stack[i];
-    bool find = false;
-
-    for (size_t j = 0; j < indices.size(); j++) {
-      for (size_t k = 0; k < indices[j].size(); k++) {
-        if (VarInExpr(cur_for->loop_var, indices[j][k])) {
-          find = true;
-          break;
-        }
-      }
-      if (find) {
-        break;
-      }
-    }
+    bool find = use_loop(i);
 
     int64_t extent = GetLoopExtent(for_loop_stack[i]);
     if (find) {
@@ -779,9 +957,30 @@ class PerStoreFeatureExtractor : public StmtExprVisitor {
     buf_extractor.InsertAccess(node->buffer, BufferAccessType::kWrite, node->indices);
     buf_extractor.ExtractReads(node->value);
 
+    // Compile the accesses into the affine form once for this loop nest.
+    // The accesses that can not be compiled fall back to the arithmetic analyzer.
+    AffineIndexCompiler affine_compiler(for_loop_stack_);
+    BufferMap<std::vector<std::vector<AffineIndex>>> affine_accesses;
+    bool need_analyzer = false;
+    for (const auto& x : buf_extractor.buf_accesses) {
+      std::vector<std::vector<AffineIndex>> indices;
+      if (affine_compiler.Compile(x.second.indices, &indices)) {
+        affine_accesses[x.first] = std::move(indices);
+      } else {
+        need_analyzer = true;
+      }
+    }
+    std::vector<int64_t> loop_extents;
+    loop_extents.reserve(for_loop_stack_.size());
+    for (const ForNode* p_for : for_loop_stack_) {
+      loop_extents.push_back(GetLoopExtent(p_for));
+    }
+
     // Compute touched region for all outer loops
-    for (auto x : for_loop_stack_) {
-      ana_.Bind(x->loop_var, Range::FromMinExtent(x->min, 1), true);
+    if (need_analyzer) {
+      for (auto x : for_loop_stack_) {
+        ana_.Bind(x->loop_var, Range::FromMinExtent(x->min, 1), true);
+      }
     }
 
     mem_bytes_list->reserve(for_loop_stack_.size());
@@ -796,8 +995,10 @@ class PerStoreFeatureExtractor : public StmtExprVisitor {
     for (int i = static_cast<int>(for_loop_stack_.size()) - 1; i >= 0; i--) {
       const ForNode* p_for = for_loop_stack_[i];
 
-      ana_.Bind(p_for->loop_var,
-                Range::FromMinExtent(for_loop_stack_[i]->min, for_loop_stack_[i]->extent), true);
+      if (need_analyzer) {
+        ana_.Bind(p_for->loop_var,
+                  Range::FromMinExtent(for_loop_stack_[i]->min, for_loop_stack_[i]->extent), true);
+      }
 
       // Note, here we do overwrite.
       // So if there are multiple BufferStoreNode, the last one will overwrite the first few.
@@ -810,7 +1011,12 @@ class PerStoreFeatureExtractor : public StmtExprVisitor {
         const Buffer& t = x.first;
         const BufferAccess& acc = x.second;
 
-        ComputeRegion(acc.indices, &ana_, &tmp_region);
+        auto it = affine_accesses.find(t);
+        if (it != affine_accesses.end()) {
+          ComputeRegion(it->second, loop_extents, i, &tmp_region);
+        } else {
+          ComputeRegion(acc.indices, &ana_, &tmp_region);
+        }
         int64_t touched_size = ElementProduct(tmp_region);
         buffer_regions_map[t].push_back(
             std::make_tuple(acc.acc_type, touched_size, t->dtype.bytes()));
@@ -826,6 +1032,9 @@ class PerStoreFeatureExtractor : public StmtExprVisitor {
     for (const auto& x : buf_extractor.buf_accesses) {
       const Buffer& t = x.first;
       const BufferAccess& acc = x.second;
+      auto affine_it = affine_accesses.find(t);
+      const std::vector<std::vector<AffineIndex>>* affine_indices =
+          affine_it != affine_accesses.end() ? &affine_it->second : nullptr;
 
       std::vector<int> int_shape;
       for (const auto& dim : t->shape) {
@@ -857,7 +1066,11 @@ class PerStoreFeatureExtractor : public StmtExprVisitor {
 
         int i;
         for (i = static_cast<int>(for_loop_stack_.size()) - 1; i >= 0; i--) {
-          stride = ComputeStride(acc.indices, int_shape, for_loop_stack_[i]->loop_var.get());
+          if (affine_indices != nullptr) {
+            stride = ComputeStride(*affine_indices, int_shape, i);
+          } else {
+            stride = ComputeStride(acc.indices, int_shape, for_loop_stack_[i]->loop_var.get());
+          }
           if (stride != 0) {
             break;
           }
@@ -886,8 +1099,29 @@ class PerStoreFeatureExtractor : public StmtExprVisitor {
 
       ReuseType reuse_type;
       float reuse_dis_iter, reuse_dis_bytes, reuse_ct;
+      auto use_loop = [this, &acc, affine_indices](int loop_level) {
+        if (affine_indices != nullptr) {
+          for (const auto& index : *affine_indices) {
+            for (const auto& dim : index) {
+              if (dim.uses[loop_level]) {
+                return true;
+              }
+            }
+          }
+        } else {
+          const Var& loop_var = for_loop_stack_[loop_level]->loop_var;
+          for (const auto& index : acc.indices) {
+            for (const auto& dim : index) {
+              if (VarInExpr(loop_var, dim)) {
+                return true;
+              }
+            }
+          }
+        }
+        return false;
+      };
       std::tie(reuse_type, reuse_dis_iter, reuse_dis_bytes, reuse_ct) =
-          ComputeReuse(t, acc.indices, for_loop_stack_, for_touch_regions_);
+          ComputeReuse(t, use_loop, for_loop_stack_, for_touch_regions_);
 
       acc_feas.emplace_back();
       BufferAccessFeature& acc_fea = acc_feas.back();
@@ -26,6 +26,13 @@
 #include <tvm/runtime/registry.h>
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 #include "search_policy/empty_policy.h"
 #include "search_policy/sketch_policy.h"
@@ -205,10 +212,110 @@ void PythonBasedMeasureCallbackNode::Callback(const SearchPolicy& policy,
   }
 }
 
+/********** BuildPipeline **********/
+/*!
+ * \brief Builds a sequence of measure batches on a background thread, so that the caller can run
+ * batch k while batch k+1 is being compiled.
+ * At most `capacity` built batches are kept waiting; after that the build thread blocks until
+ * the caller pops one (back-pressure).
+ * \note The builders are usually implemented in Python, so the caller waits on a WorkerEvent to
+ * let the build thread take the GIL.
+ */
+class BuildPipeline {
+ public:
+  BuildPipeline(ProgramBuilder builder, std::vector<Array<MeasureInput>> batches, int capacity,
+                int verbose)
+      : builder_(std::move(builder)),
+        batches_(std::move(batches)),
+        capacity_(capacity),
+        verbose_(verbose) {
+    ICHECK_GT(capacity_, 0);
+    worker_ = std::thread([this]() { this->BuildLoop(); });
+  }
+
+  ~BuildPipeline() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stopped_ = true;
+    cv_.notify_all();
+    event_.WaitUntil(&lock, [this]() { return finished_; });
+    lock.unlock();
+    worker_.join();
+  }
+
+  /*!
+   * \brief Wait for the next batch to be built and take it out of the queue.
+   * Errors thrown by the builder are rethrown here.
+   * \return The build results of the next batch.
+   */
+  Array<BuildResult> Pop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    event_.WaitUntil(&lock, [this]() { return !queue_.empty(); });
+    std::pair<Array<BuildResult>, std::exception_ptr> item = std::move(queue_.front());
+    queue_.pop_front();
+    cv_.notify_all();
+    lock.unlock();
+    if (item.second) {
+      std::rethrow_exception(item.second);
+    }
+    return item.first;
+  }
+
+  /*! \brief Set the verbosity of the batches built from now on. */
+  void SetVerbose(int verbose) { verbose_ = verbose; }
+
+ private:
+  void BuildLoop() {
+    for (const auto& batch : batches_) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock,
+                 [this]() { return stopped_ || static_cast<int>(queue_.size()) < capacity_; });
+        if (stopped_) {
+          break;
+        }
+      }
+      Array<BuildResult> build_results;
+      std::exception_ptr error = nullptr;
+      try {
+        build_results = builder_->Build(batch, verbose_);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.emplace_back(std::move(build_results), error);
+      }
+      event_.Notify();
+      if (error) {
+        break;
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      finished_ = true;
+    }
+    event_.Notify();
+  }
+
+  ProgramBuilder builder_;
+  std::vector<Array<MeasureInput>> batches_;
+  int capacity_;
+  std::atomic<int> verbose_;
+  std::mutex mutex_;
+  /*! \brief Wakes up the build thread once a built batch is popped. */
+  std::condition_variable cv_;
+  /*! \brief Wakes up the caller once a batch is built. */
+  WorkerEvent event_;
+  std::deque<std::pair<Array<BuildResult>, std::exception_ptr>> queue_;
+  bool stopped_{false};
+  bool finished_{false};
+  std::thread worker_;
+};
+
 /********** ProgramMeasurer **********/
 ProgramMeasurer::ProgramMeasurer(ProgramBuilder builder, ProgramRunner runner,
                                  Optional<Array<MeasureCallback>> callbacks, int verbose,
-                                 int max_continuous_error) {
+                                 int max_continuous_error, int async_queue_size) {
   auto node = make_object<ProgramMeasurerNode>();
   node->builder = std::move(builder);
   node->runner = std::move(runner);
@@ -217,6 +324,7 @@ ProgramMeasurer::ProgramMeasurer(ProgramBuilder builder, ProgramRunner runner,
   node->max_continuous_error = max_continuous_error < 0
                                    ? ProgramMeasurerNode::DEFAULT_MAX_CONTINUOUS_ERROR
                                    : max_continuous_error;
+  node->async_queue_size = async_queue_size;
   data_ = std::move(node);
 }
 
@@ -246,13 +354,27 @@ Array<MeasureResult> ProgramMeasurerNode::Measure(const SearchTask& task,
 
   StdCout(verbose) << "Get " << inputs.size() << " programs to measure:" << std::endl;
 
+  std::vector<Array<MeasureInput>> input_batches;
   for (size_t i = 0; i < inputs.size(); i += batch_size) {
-    Array<MeasureInput> input_batch(inputs.begin() + i,
-                                    inputs.begin() + std::min(i + batch_size, inputs.size()));
+    input_batches.emplace_back(inputs.begin() + i,
+                               inputs.begin() + std::min(i + batch_size, inputs.size()));
+  }
+
+  // Overlap the building of the next batch with the running of the current one
+  std::unique_ptr<BuildPipeline> pipeline;
+  if (async_queue_size > 0 && input_batches.size() > 1) {
+    pipeline = std::make_unique<BuildPipeline>(builder, input_batches, async_queue_size, verbose);
+  }
+
+  for (const Array<MeasureInput>& input_batch : input_batches) {
     Array<MeasureResult> result_batch;
 
     // build and run
-    SilentMeasure(task, input_batch, &result_batch);
+    if (pipeline) {
+      SilentMeasure(task, input_batch, &result_batch, pipeline->Pop());
+    } else {
+      SilentMeasure(task, input_batch, &result_batch);
+    }
 
     // update current best state according to the new measure result
     for (size_t j = 0; j < input_batch.size(); ++j) {
@@ -302,6 +424,9 @@ Array<MeasureResult> ProgramMeasurerNode::Measure(const SearchTask& task,
     } else {
       verbose = old_verbosity;
     }
+    if (pipeline) {
+      pipeline->SetVerbose(verbose);
+    }
   }
 
   PrintTimeElapsed(t_begin, "measurement", verbose);
@@ -310,12 +435,15 @@ Array<MeasureResult> ProgramMeasurerNode::Measure(const SearchTask& task,
 }
 
 void ProgramMeasurerNode::SilentMeasure(const SearchTask& task, const Array<MeasureInput>& inputs,
-                                        Array<MeasureResult>* results) {
+                                        Array<MeasureResult>* results,
+                                        Optional<Array<BuildResult>> build_results) {
   results->clear();
   results->reserve(inputs.size());
 
   // Call builder and runner
-  Array<BuildResult> build_res_batch = builder->Build(inputs, verbose);
+  Array<BuildResult> build_res_batch =
+      build_results ? build_results.value() : builder->Build(inputs, verbose);
+  ICHECK_EQ(build_res_batch.size(), inputs.size());
   Array<MeasureResult> result_batch = runner->Run(inputs, build_res_batch, verbose);
 
   // Store result batch
@@ -389,8 +517,16 @@ TVM_REGISTER_GLOBAL("auto_scheduler.PythonBasedMeasureCallback")
 
 TVM_REGISTER_GLOBAL("auto_scheduler.ProgramMeasurer")
     .set_body_typed([](ProgramBuilder builder, ProgramRunner runner,
-                       Array<MeasureCallback> callbacks, int verbose, int max_continuous_error) {
-      return ProgramMeasurer(builder, runner, callbacks, verbose, max_continuous_error);
+                       Array<MeasureCallback> callbacks, int verbose, int max_continuous_error,
+                       int async_queue_size) {
+      return ProgramMeasurer(builder, runner, callbacks, verbose, max_continuous_error,
+                             async_queue_size);
+    });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.ProgramMeasurerMeasure")
+    .set_body_typed([](ProgramMeasurer measurer, SearchTask task, SearchPolicy policy,
+                       Array<MeasureInput> inputs, int batch_size) {
+      return measurer->Measure(task, policy, inputs, batch_size);
     });
 
 TVM_REGISTER_GLOBAL("auto_scheduler.ProgramBuilderBuild")
@@ -26,6 +26,18 @@
 #include <tvm/auto_scheduler/search_policy.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 #include "utils.h"
 
 namespace tvm {
@@ -81,6 +93,201 @@ void SearchPolicyNode::PreloadMeasuredStates(const String& log_file) {
   }
 }
 
+/*!
+ * \brief Split a workload key "[name, arg0, arg1, ...]" into the name (a function name or a
+ * ComputeDAG hash) and the printed arguments.
+ * \return Whether the workload key has the expected form.
+ */
+static bool ParseWorkloadKey(const std::string& workload_key, std::string* name,
+                             std::vector<std::string>* args) {
+  size_t begin = workload_key.find('[');
+  size_t end = workload_key.rfind(']');
+  if (begin == std::string::npos || end == std::string::npos || end <= begin) {
+    return false;
+  }
+  args->clear();
+  std::string token;
+  int depth = 0;
+  for (size_t i = begin + 1; i < end; ++i) {
+    char c = workload_key[i];
+    if (c == '[' || c == '(') {
+      depth++;
+    } else if (c == ']' || c == ')') {
+      depth--;
+    }
+    if (c == ',' && depth == 0) {
+      args->push_back(std::move(token));
+      token.clear();
+    } else if (!std::isspace(static_cast<unsigned char>(c))) {
+      token.push_back(c);
+    }
+  }
+  if (!token.empty()) {
+    args->push_back(std::move(token));
+  }
+  if (args->empty()) {
+    return false;
+  }
+  *name = args->front();
+  args->erase(args->begin());
+  return true;
+}
+
+/*!
+ * \brief Compute the shape distance between the arguments of two workloads with the same name.
+ * It is the product of max(a, b) / min(a, b) over all differing integer arguments, so 1 means
+ * identical workloads. Non-integer arguments have to be equal.
+ * \return The distance, or infinity if the two workloads are not comparable.
+ */
+static double WorkloadDistance(const std::vector<std::string>& lhs,
+                               const std::vector<std::string>& rhs) {
+  if (lhs.size() != rhs.size()) {
+    return std::numeric_limits<double>::infinity();
+  }
+  double distance = 1.0;
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    if (lhs[i] == rhs[i]) {
+      continue;
+    }
+    char* lhs_end;
+    char* rhs_end;
+    int64_t a = std::strtoll(lhs[i].c_str(), &lhs_end, 10);
+    int64_t b = std::strtoll(rhs[i].c_str(), &rhs_end, 10);
+    if (*lhs_end != '\0' || *rhs_end != '\0' || a <= 0 || b <= 0) {
+      return std::numeric_limits<double>::infinity();
+    }
+    distance *= static_cast<double>(std::max(a, b)) / std::min(a, b);
+  }
+  return distance;
+}
+
+/*!
+ * \brief Adapt a SplitStep recorded on another workload to the extent of the iterator in the
+ * current state. Every split factor is replaced by the largest divisor of the remaining extent
+ * that does not exceed it, starting from the innermost one.
+ */
+static Step AdaptSplitStep(const SplitStepNode* ps, const State& state) {
+  const Iterator& it = state->stages[ps->stage_id]->iters[ps->iter_id];
+  if (!it->range.defined() || !it->range->extent->IsInstance<IntImmNode>()) {
+    return GetRef<Step>(ps);
+  }
+  int64_t extent = GetIntImm(it->range->extent);
+  if (ps->extent && GetIntImm(ps->extent.value()) == extent) {
+    return GetRef<Step>(ps);
+  }
+
+  std::vector<Optional<Integer>> lengths(ps->lengths.begin(), ps->lengths.end());
+  int64_t remaining = extent;
+  for (int i = static_cast<int>(lengths.size()) - 1; i >= 0; --i) {
+    if (!lengths[i]) {
+      continue;
+    }
+    int64_t factor = std::max<int64_t>(std::min(GetIntImm(lengths[i].value()), remaining), 1);
+    while (remaining % factor != 0) {
+      factor--;
+    }
+    lengths[i] = Integer(factor);
+    remaining /= factor;
+  }
+  return SplitStep(ps->stage_id, ps->iter_id, it->range->extent,
+                   Array<Optional<Integer>>(lengths.begin(), lengths.end()), ps->inner_to_outer);
+}
+
+std::pair<Array<MeasureInput>, Array<MeasureResult>> SearchPolicyNode::PreloadSimilarStates(
+    const String& log_file, int num_states) {
+  std::string task_name;
+  std::vector<std::string> task_args;
+  if (!ParseWorkloadKey(search_task->workload_key, &task_name, &task_args)) {
+    StdCout(verbose) << "SearchPolicy: Cannot parse the workload key "
+                     << search_task->workload_key << ", skip loading similar states." << std::endl;
+    return {};
+  }
+
+  // The cost model extracts features from the ComputeDAG of each record, so only the
+  // workloads that can be recovered from their keys are returned for pretraining
+  const auto* workload_key_to_tensors =
+      runtime::Registry::Get("auto_scheduler.workload_key_to_tensors");
+  std::unordered_map<std::string, bool> recoverable;
+
+  RecordReader reader = RecordReader(log_file);
+  const auto& res = reader->ReadLines(-1);
+  ICHECK_EQ(res.first.size(), res.second.size());
+
+  // Collect the records of similar workloads, sorted by (shape distance, cost)
+  std::vector<std::tuple<double, double, size_t>> candidates;
+  for (size_t i = 0; i < res.first.size(); ++i) {
+    const auto& inp = res.first[i];
+    if (inp->task->workload_key == search_task->workload_key ||
+        inp->task->target->kind->name.compare(search_task->target->kind->name) != 0) {
+      continue;
+    }
+    std::string name;
+    std::vector<std::string> args;
+    if (!ParseWorkloadKey(inp->task->workload_key, &name, &args) || name != task_name) {
+      continue;
+    }
+    double distance = WorkloadDistance(task_args, args);
+    if (std::isinf(distance)) {
+      continue;
+    }
+    double cost = res.second[i]->error_no == 0 ? FloatArrayMean(res.second[i]->costs)
+                                               : std::numeric_limits<double>::max();
+    candidates.emplace_back(distance, cost, i);
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  Array<MeasureInput> inputs;
+  Array<MeasureResult> results;
+  std::unordered_set<std::string> transferred_set;
+  for (const auto& candidate : candidates) {
+    size_t i = std::get<2>(candidate);
+    const auto& inp = res.first[i];
+    const std::string& workload_key = inp->task->workload_key;
+    if (workload_key_to_tensors != nullptr && !recoverable.count(workload_key)) {
+      try {
+        (*workload_key_to_tensors)(workload_key);
+        recoverable[workload_key] = true;
+      } catch (std::exception& e) {
+        recoverable[workload_key] = false;
+      }
+    }
+    if (workload_key_to_tensors != nullptr && recoverable[workload_key]) {
+      inputs.push_back(inp);
+      results.push_back(res.second[i]);
+    }
+
+    if (static_cast<int>(transferred_states_.size()) >= num_states ||
+        res.second[i]->error_no != 0) {
+      continue;
+    }
+    // Replay the steps on the current ComputeDAG
+    State state = search_task->compute_dag->init_state;
+    try {
+      for (const auto& step : inp->state->transform_steps) {
+        Step new_step = step;
+        if (auto ps = step.as<SplitStepNode>()) {
+          new_step = AdaptSplitStep(ps, state);
+        }
+        state.CopyOnWrite()->transform_steps.push_back(new_step);
+        StepApplyToState(new_step, &state, search_task->compute_dag);
+      }
+      state = search_task->compute_dag.InferBound(state);
+    } catch (Error& e) {
+      continue;
+    }
+    const auto& state_str = state.ToStr();
+    if (!measured_states_set_.count(state_str) && !transferred_set.count(state_str)) {
+      transferred_set.insert(state_str);
+      transferred_states_.push_back(std::move(state));
+    }
+  }
+
+  StdCout(verbose) << "SearchPolicy: Transferred " << transferred_states_.size()
+                   << " states from similar workloads in " << log_file << " for "
+                   << search_task->workload_key << std::endl;
+  return std::make_pair(std::move(inputs), std::move(results));
+}
+
 void SearchPolicyNode::RunCallbacks(const Array<SearchCallback>& callbacks) {
   for (const auto& callback : callbacks) {
     callback->Callback(this);
@@ -112,6 +319,9 @@ TVM_REGISTER_GLOBAL("auto_scheduler.SearchPolicyContinueSearchOneRound")
       return Array<ObjectRef>{inputs, results};
     });
 
+TVM_REGISTER_GLOBAL("auto_scheduler.SearchPolicyGetTransferredStates")
+    .set_body_typed([](SearchPolicy policy) { return policy->GetTransferredStates(); });
+
 TVM_REGISTER_GLOBAL("auto_scheduler.SearchPolicySetVerbose")
     .set_body_typed([](SearchPolicy policy, int verbose) { policy->verbose = verbose; });
 
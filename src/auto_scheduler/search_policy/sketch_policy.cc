@@ -51,6 +51,7 @@ static RuleSkipStage rule_skip_stage;
 static RuleAlwaysInline rule_always_inline;
 static RuleMultiLevelTiling rule_multi_level_tiling;
 static RuleMultiLevelTilingWithFusion rule_multi_level_tiling_with_fusion;
+static RuleMultiLevelTilingX86DotProduct rule_multi_level_tiling_x86_dot_product;
 static RuleAddCacheRead rule_add_cache_read_stage;
 static RuleAddCacheWrite rule_add_cache_write_stage;
 static RuleAddRfactor rule_add_rfactor;
@@ -63,6 +64,7 @@ static InitFillTileSize init_fill_tile_size;
 static InitChangeComputeLocation init_change_compute_location;
 static InitParallel init_parallel;
 static InitUnroll init_unroll;
+static InitX86DotProduct init_x86_dot_product;
 static InitVectorization init_vectorization;
 static InitThreadBind init_thread_bind;
 
@@ -88,6 +90,8 @@ SketchPolicy::SketchPolicy(SearchTask task, CostModel program_cost_model,
     //   `measured_states_set_`, `measured_states_vector_` and `measured_states_throughputs_`.
     // - auto_scheduler.PreloadCustomSketchRule: Add user custom sketch rules to `sketch_rules`,
     //   these rules will be processed prior to the default rules.
+    // - auto_scheduler.PreloadSimilarStates: Load the best states of similar workloads to
+    //   `transferred_states_` and pretrain the cost model on their records.
     node->RunCallbacks(init_search_callbacks.value());
   }
 
@@ -99,6 +103,7 @@ SketchPolicy::SketchPolicy(SearchTask task, CostModel program_cost_model,
     node->sketch_rules.push_back(&rule_simplify_compute_with_const_tensor);
     node->sketch_rules.push_back(&rule_add_rfactor);
     node->sketch_rules.push_back(&rule_add_cache_write_stage);
+    node->sketch_rules.push_back(&rule_multi_level_tiling_x86_dot_product);
     node->sketch_rules.push_back(&rule_multi_level_tiling_with_fusion);
     node->sketch_rules.push_back(&rule_multi_level_tiling);
     node->sketch_rules.push_back(&rule_skip_stage);
@@ -108,6 +113,7 @@ SketchPolicy::SketchPolicy(SearchTask task, CostModel program_cost_model,
     node->init_rules.push_back(&init_change_compute_location);
     node->init_rules.push_back(&init_parallel);
     node->init_rules.push_back(&init_unroll);
+    node->init_rules.push_back(&init_x86_dot_product);
     node->init_rules.push_back(&init_vectorization);
 
     // Mutation Rules for Evolutionary Search
@@ -284,11 +290,13 @@ std::pair<Array<MeasureInput>, Array<MeasureResult>> SketchPolicyNode::ContinueS
 Array<State> SketchPolicyNode::SearchOneRound(int num_random_states, Array<State>* random_states) {
   // Get parameters
   int population = GetIntParam(params, SketchParamKey::EvolutionarySearch::population);
-  int num_use_measured = std::min(
-      static_cast<int>(measured_states_vector_.size()),
-      static_cast<int>(
-          GetDoubleParam(params, SketchParamKey::SampleInitPopulation::use_measured_ratio) *
-          population));
+  int max_use_measured = static_cast<int>(
+      GetDoubleParam(params, SketchParamKey::SampleInitPopulation::use_measured_ratio) *
+      population);
+  int num_use_measured =
+      std::min(static_cast<int>(measured_states_vector_.size()), max_use_measured);
+  int num_use_transferred =
+      std::min(static_cast<int>(transferred_states_.size()), max_use_measured - num_use_measured);
 
   // 1. Generate sketches
   if (sketch_cache_.empty()) {
@@ -304,6 +312,11 @@ Array<State> SketchPolicyNode::SearchOneRound(int num_random_states, Array<State
   for (int i = 0; i < num_use_measured; i++) {
     init_population.push_back(measured_states_vector_[indices[i]]);
   }
+  // Fill the rest of the quota with states transferred from similar workloads. They are phased
+  // out as more states of this task get measured.
+  for (int i = 0; i < num_use_transferred; i++) {
+    init_population.push_back(transferred_states_[i]);
+  }
   // Sample some random states for eps-greedy
   if (num_random_states > 0 && random_states != nullptr) {
     *random_states = RandomSampleStates(init_population, &rand_gen, num_random_states);
@@ -691,6 +704,30 @@ void PreloadCustomSketchRuleNode::Callback(SearchPolicyNode* policy) {
   StdCout(policy->verbose) << "Custom sketch rule \"" << rule_name << "\" added." << std::endl;
 }
 
+/********** PreloadSimilarStates **********/
+TVM_REGISTER_OBJECT_TYPE(PreloadSimilarStatesNode);
+
+PreloadSimilarStates::PreloadSimilarStates(String filename, int num_states) {
+  auto node = make_object<PreloadSimilarStatesNode>();
+  node->filename = std::move(filename);
+  node->num_states = num_states;
+  data_ = std::move(node);
+}
+
+void PreloadSimilarStatesNode::Callback(SearchPolicyNode* policy) {
+  CHECK(policy->IsInstance<SketchPolicyNode>());
+  auto sketch_policy = dynamic_cast<SketchPolicyNode*>(policy);
+  Array<MeasureInput> inputs;
+  Array<MeasureResult> results;
+  std::tie(inputs, results) = sketch_policy->PreloadSimilarStates(filename, num_states);
+  if (!inputs.empty()) {
+    auto t_begin = std::chrono::high_resolution_clock::now();
+    PrintTitle("Pretrain cost model", policy->verbose);
+    sketch_policy->program_cost_model->Update(inputs, results);
+    PrintTimeElapsed(t_begin, "pretraining", policy->verbose);
+  }
+}
+
 TVM_REGISTER_GLOBAL("auto_scheduler.SketchPolicy")
     .set_body_typed([](SearchTask task, CostModel program_cost_model, Map<String, ObjectRef> params,
                        int seed, int verbose,
@@ -724,5 +761,10 @@ TVM_REGISTER_GLOBAL("auto_scheduler.PreloadCustomSketchRule")
       return PreloadCustomSketchRule(meet_condition_func, apply_func, rule_name);
     });
 
+TVM_REGISTER_GLOBAL("auto_scheduler.PreloadSimilarStates")
+    .set_body_typed([](String filename, int num_states) {
+      return PreloadSimilarStates(filename, num_states);
+    });
+
 }  // namespace auto_scheduler
 }  // namespace tvm
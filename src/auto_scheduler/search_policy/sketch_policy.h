@@ -231,6 +231,41 @@ class PreloadCustomSketchRule : public SearchCallback {
                                         PreloadCustomSketchRuleNode);
 };
 
+/*!
+ * \brief Pre-search callback function to warm-start the search from the measured records of
+ * similar workloads. The transferred best states join the initial population of the evolutionary
+ * search, and the cost model is pretrained on the records of the similar workloads.
+ */
+class PreloadSimilarStatesNode : public SearchCallbackNode {
+ public:
+  /*! \brief The name of the record log file. */
+  String filename;
+  /*! \brief The maximum number of states to transfer. */
+  int num_states;
+
+  void Callback(SearchPolicyNode* policy) final;
+
+  static constexpr const char* _type_key = "auto_scheduler.PreloadSimilarStates";
+  TVM_DECLARE_FINAL_OBJECT_INFO(PreloadSimilarStatesNode, SearchCallbackNode);
+};
+
+/*!
+ * \brief Managed reference to PreloadSimilarStatesNode.
+ * \sa PreloadSimilarStatesNode
+ */
+class PreloadSimilarStates : public SearchCallback {
+ public:
+  /*!
+   * \brief The constructor.
+   * \param filename The name of the record log file.
+   * \param num_states The maximum number of states to transfer.
+   */
+  PreloadSimilarStates(String filename, int num_states);
+
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(PreloadSimilarStates, SearchCallback,
+                                        PreloadSimilarStatesNode);
+};
+
 }  // namespace auto_scheduler
 }  // namespace tvm
 
@@ -154,6 +154,83 @@ std::vector<std::pair<State, int>> RuleMultiLevelTilingWithFusion::Apply(
   return ret;
 }
 
+/********** RuleMultiLevelTilingX86DotProduct **********/
+
+// The number of int32 lanes of vpdpbusd on 512-bit registers
+static const int kX86DotProductLanes = 16;
+// The number of products of int8 summed up in every lane of vpdpbusd
+static const int kX86DotProductGroup = 4;
+
+// Find the spatial iterator to map onto the lanes and the reduction iterator to map onto the
+// groups of vpdpbusd. The innermost ones with divisible extents are selected.
+bool GetX86DotProductIters(const Stage& stage, int* spatial_iter_id, int* reduce_iter_id) {
+  if (!IsInt8DotProduct(stage) || IsTiled(stage)) {
+    return false;
+  }
+  *spatial_iter_id = *reduce_iter_id = -1;
+  for (int i = static_cast<int>(stage->iters.size()) - 1; i >= 0; --i) {
+    const Iterator& it = stage->iters[i];
+    int64_t extent = GetExtent(it);
+    if (it->iter_kind == IteratorKind::kSpatial) {
+      if (*spatial_iter_id < 0 && extent > 0 && extent % kX86DotProductLanes == 0) {
+        *spatial_iter_id = i;
+      }
+    } else if (it->iter_kind == IteratorKind::kReduction) {
+      if (*reduce_iter_id < 0 && extent > 0 && extent % kX86DotProductGroup == 0) {
+        *reduce_iter_id = i;
+      }
+    }
+  }
+  return *spatial_iter_id >= 0 && *reduce_iter_id >= 0;
+}
+
+SketchGenerationRule::ConditionKind RuleMultiLevelTilingX86DotProduct::MeetCondition(
+    const SketchPolicyNode& policy, const State& state, int stage_id) const {
+  int spatial_iter_id, reduce_iter_id;
+  if (IsX86VNNITask(policy.search_task) &&
+      NeedsMultilevelTiling(policy.search_task, state, stage_id) &&
+      GetX86DotProductIters(state->stages[stage_id], &spatial_iter_id, &reduce_iter_id)) {
+    // Also keep the sketches of the general multi-level tiling rules
+    return ConditionKind::kApply;
+  }
+  return ConditionKind::kSkip;
+}
+
+std::vector<std::pair<State, int>> RuleMultiLevelTilingX86DotProduct::Apply(
+    const SketchPolicyNode& policy, const State& state, int stage_id) const {
+  int spatial_iter_id, reduce_iter_id;
+  ICHECK(GetX86DotProductIters(state->stages[stage_id], &spatial_iter_id, &reduce_iter_id));
+  const Stage& stage = state->stages[stage_id];
+
+  // Split out the lanes and the groups of the instruction, then tile the other iterators
+  State tmp_s = state;
+  Iterator lane_iter = tmp_s.split(stage_id, stage->iters[spatial_iter_id],
+                                   Array<Optional<Integer>>{Integer(kX86DotProductLanes)})[1];
+  Iterator group_iter = tmp_s.split(stage_id, stage->iters[reduce_iter_id],
+                                    Array<Optional<Integer>>{Integer(kX86DotProductGroup)})[1];
+  tmp_s = DoMultiLevelTiling(
+      tmp_s, stage_id,
+      GetStringParam(policy.params, SketchParamKey::MultiLevelTiling::cpu_structure), nullptr,
+      {lane_iter->name, group_iter->name});
+
+  // Move the groups and the lanes to the innermost
+  Array<Iterator> order;
+  for (const auto& it : tmp_s->stages[stage_id]->iters) {
+    if (it->name == lane_iter->name) {
+      lane_iter = it;
+    } else if (it->name == group_iter->name) {
+      group_iter = it;
+    } else {
+      order.push_back(it);
+    }
+  }
+  order.push_back(group_iter);
+  order.push_back(lane_iter);
+  tmp_s.reorder(stage_id, order);
+
+  return {std::make_pair(std::move(tmp_s), stage_id - 1)};
+}
+
 /********** RuleAddCacheRead **********/
 
 SketchGenerationRule::ConditionKind RuleAddCacheRead::MeetCondition(const SketchPolicyNode& policy,
@@ -694,6 +771,43 @@ PopulationGenerationRule::ResultKind InitUnroll::Apply(SketchPolicyNode* policy,
   return ResultKind::kValid;
 }
 
+PopulationGenerationRule::ResultKind InitX86DotProduct::Apply(SketchPolicyNode* policy,
+                                                              State* state,
+                                                              std::mt19937* rand_gen) const {
+  if (!IsX86VNNITask(policy->search_task)) {
+    return ResultKind::kValid;
+  }
+
+  for (size_t stage_id = 0; stage_id < (*state)->stages.size(); ++stage_id) {
+    const Stage& stage = (*state)->stages[stage_id];
+    // Skip the inlined stage and placeholder stage
+    if (stage->compute_at == ComputeAtKind::kInlined || stage->op_type == StageKind::kPlaceholder ||
+        !IsInt8DotProduct(stage) || stage->iters.size() < 2) {
+      continue;
+    }
+
+    // Match the innermost iterators generated by RuleMultiLevelTilingX86DotProduct
+    int lane_iter_id = static_cast<int>(stage->iters.size()) - 1;
+    Iterator lane_iter = stage->iters[lane_iter_id];
+    Iterator group_iter = stage->iters[lane_iter_id - 1];
+    if (lane_iter->iter_kind != IteratorKind::kSpatial ||
+        group_iter->iter_kind != IteratorKind::kReduction ||
+        lane_iter->annotation != IteratorAnnotation::kNone ||
+        group_iter->annotation != IteratorAnnotation::kNone ||
+        GetExtent(lane_iter) != kX86DotProductLanes ||
+        GetExtent(group_iter) != kX86DotProductGroup ||
+        (*state)->attach_map->iter_to_attached_stages.count(
+            std::make_pair(stage_id, lane_iter_id))) {
+      continue;
+    }
+
+    state->vectorize(stage_id, lane_iter);
+    state->pragma(stage_id, group_iter, "x86_vnni");
+  }
+
+  return ResultKind::kValid;
+}
+
 PopulationGenerationRule::ResultKind InitVectorization::Apply(SketchPolicyNode* policy,
                                                               State* state,
                                                               std::mt19937* rand_gen) const {
@@ -110,6 +110,11 @@ DEFINE_SKETCH_GENERATION_RULE(RuleMultiLevelTiling);
 /*! \brief The rule that performs multi-level tiling and fuses later consumers. */
 DEFINE_SKETCH_GENERATION_RULE(RuleMultiLevelTilingWithFusion);
 
+/*! \brief The rule that performs multi-level tiling for int8 dot-products on x86 CPUs with VNNI.
+ * It keeps groups of 4 reduction elements by 16 spatial lanes as the innermost iterators, so that
+ * they can be mapped onto the instruction vpdpbusd by the code generator. */
+DEFINE_SKETCH_GENERATION_RULE(RuleMultiLevelTilingX86DotProduct);
+
 /*! \brief The rule that adds a cache read stage. Mainly used for GPU cooperative fetching,
  * Currently only support 1 to 1 match cache read. */
 DEFINE_SKETCH_GENERATION_RULE(RuleAddCacheRead);
@@ -196,6 +201,10 @@ DEFINE_INIT_POPULATION_RULE(InitParallel);
 /*! \brief The rule that annotates unroll. */
 DEFINE_INIT_POPULATION_RULE(InitUnroll);
 
+/*! \brief The rule that annotates the innermost iterators generated by
+ * RuleMultiLevelTilingX86DotProduct to be mapped onto the x86 VNNI instructions. */
+DEFINE_INIT_POPULATION_RULE(InitX86DotProduct);
+
 /*! \brief The rule that annotates vectorization. */
 DEFINE_INIT_POPULATION_RULE(InitVectorization);
 
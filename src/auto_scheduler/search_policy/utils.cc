@@ -147,7 +147,8 @@ std::vector<std::pair<int, int>> GetComputeLocationCandidates(const SearchTask&
 }
 
 State DoMultiLevelTiling(const State& state, int stage_id, const std::string& format,
-                         std::vector<int>* spatial_split_step_ids) {
+                         std::vector<int>* spatial_split_step_ids,
+                         const std::set<std::string>& no_split_names) {
   // Temporal object to be used if the input pointer is nullptr
   std::vector<int> temp_split_step_ids;
   if (spatial_split_step_ids == nullptr) {
@@ -174,10 +175,11 @@ State DoMultiLevelTiling(const State& state, int stage_id, const std::string& fo
 
   State tmp_s = state;
   const Stage& stage = state->stages[stage_id];
-  const std::set<std::string>& no_split_at_inner_name_set =
+  std::set<std::string> no_split_at_inner_name_set =
       stage->op->attrs.count(SearchPolicyKey::no_split_at_inner)
           ? GetIterNameSetParam(stage->op->attrs, SearchPolicyKey::no_split_at_inner)
           : std::set<std::string>();
+  no_split_at_inner_name_set.insert(no_split_names.begin(), no_split_names.end());
 
   for (const auto& iter : state->stages[stage_id]->iters) {
     if (!no_split_at_inner_name_set.count(iter->name)) {
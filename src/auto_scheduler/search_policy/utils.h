@@ -71,6 +71,29 @@ inline bool IsOpenCLTask(const SearchTask& task) {
   return (task)->target->kind->device_type == kDLOpenCL;
 }
 
+/*! \brief Return whether the search task is targeting a x86 CPU with the VNNI instructions. */
+inline bool IsX86VNNITask(const SearchTask& task) {
+  if (!IsCPUTask(task)) {
+    return false;
+  }
+  static const std::set<std::string> vnni_mcpus = {"cascadelake",    "cooperlake",
+                                                   "icelake-client", "icelake-server",
+                                                   "tigerlake",      "sapphirerapids"};
+  if (auto mcpu = task->target->GetAttr<String>("mcpu")) {
+    if (vnni_mcpus.count(mcpu.value())) {
+      return true;
+    }
+  }
+  if (auto mattr = task->target->GetAttr<Array<String>>("mattr")) {
+    for (const auto& attr : mattr.value()) {
+      if (attr == "+avx512vnni") {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 /*! \brief Argsort. Order: largest to smallest */
 template <typename T>
 inline std::vector<int> Argsort(const std::vector<T>& scores) {
@@ -481,6 +504,37 @@ inline bool IsTiled(const Stage& stage) {
   return stage->iters.size() != op->axis.size() + op->reduce_axis.size();
 }
 
+/*!
+ * \brief Return whether a stage computes the sum of products of a uint8 and an int8 operand in
+ * int32, which can be mapped onto the x86 VNNI instructions.
+ */
+inline bool IsInt8DotProduct(const Stage& stage) {
+  auto op = stage->op.as<te::ComputeOpNode>();
+  if (op == nullptr || op->body.size() != 1) {
+    return false;
+  }
+  auto reduce = op->body[0].as<tir::ReduceNode>();
+  if (reduce == nullptr || reduce->source.size() != 1 ||
+      !reduce->combiner->result[0]->IsInstance<tir::AddNode>() || !tir::is_one(reduce->condition)) {
+    return false;
+  }
+  auto mul = reduce->source[0].as<tir::MulNode>();
+  if (mul == nullptr || !mul->dtype.is_int() || mul->dtype.bits() != 32) {
+    return false;
+  }
+  auto get_int8_type = [](const PrimExpr& expr) {
+    if (auto cast = expr.as<tir::CastNode>()) {
+      const DataType& dtype = cast->value.dtype();
+      if ((dtype.is_int() || dtype.is_uint()) && dtype.bits() == 8) {
+        return dtype;
+      }
+    }
+    return DataType::Void();
+  };
+  DataType a = get_int8_type(mul->a), b = get_int8_type(mul->b);
+  return (a.is_uint() && b.is_int()) || (a.is_int() && b.is_uint());
+}
+
 /*! \brief Extract primitive iterators from a nested fused or splitted iterator's name. */
 inline void ExtractOriginalIterators(const std::string& name, std::set<std::string>* rets) {
   size_t last_pos = 0;
@@ -698,8 +752,10 @@ std::vector<std::pair<int, int>> GetComputeLocationCandidates(const SearchTask&
 // For example, if apply "SSRSRS" to matrix multiplication,
 // we have space iterators i and j, reduce iterator k.
 // Then the tiling structure is : i0, j0, i1, j1, k0, i2, j2, k1, i3, j3
+// The iterators in `no_split_names` are not split and are put into the innermost levels.
 State DoMultiLevelTiling(const State& state, int stage_id, const std::string& format,
-                         std::vector<int>* spatial_split_step_ids = nullptr);
+                         std::vector<int>* spatial_split_step_ids = nullptr,
+                         const std::set<std::string>& no_split_names = std::set<std::string>());
 
 // Apply tiling structure: space, space, space, ..., with tile sizes from other SplitStep
 State FollowTiling(const State& state, int stage_id, const std::vector<int>& split_step_ids,
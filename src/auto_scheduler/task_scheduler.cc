@@ -0,0 +1,549 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file auto_scheduler/task_scheduler.cc
+ * \brief The task scheduler that allocates the measurement trials when tuning multiple tasks.
+ */
+
+#include <tvm/auto_scheduler/task_scheduler.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/te/operation.h>
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+#include "utils.h"
+
+namespace tvm {
+namespace auto_scheduler {
+
+TVM_REGISTER_NODE_TYPE(TaskSchedulerNode);
+
+/*! \brief The latency of a task that has no valid schedule yet. */
+static constexpr double kInvalidCost = 1e10;
+
+/*!
+ * \brief Derive the tag for similarity check from a ComputeDAG.
+ * The tag format is <op1-tag>_<op2-tag> ... <log(flop)>, where the op tags come from the
+ * "auto_scheduler_task_scheduler_tag" attribute. An empty tag means no similar task.
+ */
+static std::string DeriveSimilarityTag(const ComputeDAG& dag, double log_base = 1.618) {
+  std::string ret;
+  for (const auto& op : dag->ops) {
+    auto it = op->attrs.find("auto_scheduler_task_scheduler_tag");
+    if (it != op->attrs.end()) {
+      ret += Downcast<String>((*it).second);
+      ret += "_";
+    }
+  }
+  if (!ret.empty()) {
+    ret += std::to_string(static_cast<int>(std::log(dag->flop_ct + 1) / std::log(log_base)));
+  }
+  return ret;
+}
+
+/*! \brief Unlock a locked mutex within a scope, and lock it again when leaving the scope. */
+class ScopedUnlock {
+ public:
+  explicit ScopedUnlock(std::mutex* mutex) : mutex_(mutex) { mutex_->unlock(); }
+  ~ScopedUnlock() { mutex_->lock(); }
+
+ private:
+  std::mutex* mutex_;
+};
+
+/*! \brief A ProgramBuilder that releases the search lock of the rounds while building. */
+class UnlockedBuilderNode : public ProgramBuilderNode {
+ public:
+  /*! \brief The builder to call. */
+  ProgramBuilder builder;
+  /*! \brief The search lock, held by the calling thread. */
+  std::mutex* search_mutex;
+
+  Array<BuildResult> Build(const Array<MeasureInput>& inputs, int verbose) final {
+    ScopedUnlock unlock(search_mutex);
+    return builder->Build(inputs, verbose);
+  }
+
+  static constexpr const char* _type_key = "auto_scheduler.UnlockedBuilder";
+  TVM_DECLARE_FINAL_OBJECT_INFO(UnlockedBuilderNode, ProgramBuilderNode);
+};
+
+TVM_REGISTER_OBJECT_TYPE(UnlockedBuilderNode);
+
+/*! \brief A ProgramRunner that releases the search lock of the rounds while running. */
+class UnlockedRunnerNode : public ProgramRunnerNode {
+ public:
+  /*! \brief The runner to call. */
+  ProgramRunner runner;
+  /*! \brief The search lock, held by the calling thread. */
+  std::mutex* search_mutex;
+
+  Array<MeasureResult> Run(const Array<MeasureInput>& inputs,
+                           const Array<BuildResult>& build_results, int verbose) final {
+    ScopedUnlock unlock(search_mutex);
+    return runner->Run(inputs, build_results, verbose);
+  }
+
+  static constexpr const char* _type_key = "auto_scheduler.UnlockedRunner";
+  TVM_DECLARE_FINAL_OBJECT_INFO(UnlockedRunnerNode, ProgramRunnerNode);
+};
+
+TVM_REGISTER_OBJECT_TYPE(UnlockedRunnerNode);
+
+/*!
+ * \brief Runs the search rounds of up to `num_parallel_tasks` different tasks at a time.
+ * With one task at a time, a round runs inline when it is launched. Otherwise each round runs on
+ * a thread with a ProgramMeasurer of its task. The search policies may share a cost model and use
+ * parallel_for, which can not run on two threads at once, so the rounds hold a common search lock
+ * except while building and running the programs.
+ */
+class TaskRounds {
+ public:
+  /*! \brief A finished round. */
+  struct Round {
+    int task_idx;
+    Array<MeasureInput> inputs;
+    Array<MeasureResult> results;
+    std::exception_ptr error{nullptr};
+  };
+
+  TaskRounds(const TaskSchedulerNode* scheduler, const TuningOptions& tuning_options,
+             int num_measures_per_round)
+      : scheduler_(scheduler),
+        tuning_options_(tuning_options),
+        num_measures_per_round_(num_measures_per_round),
+        threads_(scheduler->tasks.size()) {
+    if (scheduler_->num_parallel_tasks == 1) {
+      measurers_.emplace_back(tuning_options->builder, tuning_options->runner,
+                              tuning_options->measure_callbacks, tuning_options->verbose, -1,
+                              tuning_options->async_measure_queue_size);
+    }
+  }
+
+  ~TaskRounds() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    event_.WaitUntil(&lock, [this]() { return finished_.size() == running_.size(); });
+    lock.unlock();
+    for (auto& thread : threads_) {
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+  }
+
+  /*! \brief Start a round of a task whose last round has been taken by WaitOne. */
+  void Launch(int task_idx) {
+    ICHECK(!running_.count(task_idx));
+    running_.insert(task_idx);
+    if (scheduler_->num_parallel_tasks == 1) {
+      finished_.push_back(RunRound(task_idx, measurers_[0]));
+      return;
+    }
+    if (measurers_.empty()) {
+      CreateMeasurers();
+    }
+    if (threads_[task_idx].joinable()) {
+      threads_[task_idx].join();
+    }
+    threads_[task_idx] = std::thread([this, task_idx]() {
+      Round round;
+      {
+        std::lock_guard<std::mutex> search_lock(search_mutex_);
+        round = RunRound(task_idx, measurers_[task_idx]);
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finished_.push_back(std::move(round));
+      }
+      event_.Notify();
+    });
+  }
+
+  /*!
+   * \brief Wait for a round to finish and take it. Errors thrown by the round are rethrown here.
+   * \return The finished round.
+   */
+  Round WaitOne() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    event_.WaitUntil(&lock, [this]() { return !finished_.empty(); });
+    Round round = std::move(finished_.front());
+    finished_.pop_front();
+    lock.unlock();
+    running_.erase(round.task_idx);
+    if (round.error) {
+      std::rethrow_exception(round.error);
+    }
+    return round;
+  }
+
+  /*! \return The tasks whose rounds have not been taken by WaitOne. */
+  const std::unordered_set<int>& running() const { return running_; }
+
+ private:
+  Round RunRound(int task_idx, const ProgramMeasurer& measurer) {
+    Round round;
+    round.task_idx = task_idx;
+    try {
+      std::tie(round.inputs, round.results) =
+          scheduler_->search_policies[task_idx]->ContinueSearchOneRound(num_measures_per_round_,
+                                                                        measurer);
+    } catch (...) {
+      round.error = std::current_exception();
+    }
+    return round;
+  }
+
+  void CreateMeasurers() {
+    auto builder = make_object<UnlockedBuilderNode>();
+    builder->n_parallel = tuning_options_->builder->n_parallel;
+    builder->timeout = tuning_options_->builder->timeout;
+    builder->builder = tuning_options_->builder;
+    builder->search_mutex = &search_mutex_;
+    auto runner = make_object<UnlockedRunnerNode>();
+    runner->timeout = tuning_options_->runner->timeout;
+    runner->number = tuning_options_->runner->number;
+    runner->repeat = tuning_options_->runner->repeat;
+    runner->min_repeat_ms = tuning_options_->runner->min_repeat_ms;
+    runner->cooldown_interval = tuning_options_->runner->cooldown_interval;
+    runner->enable_cpu_cache_flush = tuning_options_->runner->enable_cpu_cache_flush;
+    runner->runner = tuning_options_->runner;
+    runner->search_mutex = &search_mutex_;
+    for (size_t i = 0; i < scheduler_->tasks.size(); ++i) {
+      measurers_.emplace_back(ProgramBuilder(builder), ProgramRunner(runner),
+                              tuning_options_->measure_callbacks, tuning_options_->verbose, -1, 0);
+    }
+  }
+
+  const TaskSchedulerNode* scheduler_;
+  TuningOptions tuning_options_;
+  int num_measures_per_round_;
+  /*! \brief One measurer per task, or a single shared one with one task at a time. */
+  std::vector<ProgramMeasurer> measurers_;
+  std::vector<std::thread> threads_;
+  std::unordered_set<int> running_;
+  /*! \brief Held by the rounds while searching, updating the cost model and the callbacks. */
+  std::mutex search_mutex_;
+  /*! \brief Guards finished_. */
+  std::mutex mutex_;
+  WorkerEvent event_;
+  std::deque<Round> finished_;
+};
+
+TaskScheduler::TaskScheduler(Array<SearchTask> tasks, Array<SearchPolicy> search_policies,
+                             Array<FloatImm> task_weights, String strategy, double alpha,
+                             double beta, int backward_window_size, int per_task_early_stopping,
+                             double plateau_threshold, int num_parallel_tasks, int seed) {
+  ICHECK(!tasks.empty()) << "No tasks";
+  ICHECK_EQ(tasks.size(), search_policies.size()) << "Expect one search policy per task";
+  ICHECK(task_weights.empty() || task_weights.size() == tasks.size());
+  ICHECK(strategy == "gradient" || strategy == "round-robin") << "Invalid strategy: " << strategy;
+  ICHECK_GT(num_parallel_tasks, 0);
+
+  auto node = make_object<TaskSchedulerNode>();
+  size_t num_tasks = tasks.size();
+  node->tasks = std::move(tasks);
+  node->search_policies = std::move(search_policies);
+  for (size_t i = 0; i < num_tasks; ++i) {
+    node->task_weights.push_back(task_weights.empty() ? 1.0 : task_weights[i]->value);
+  }
+  node->strategy = std::move(strategy);
+  node->alpha = alpha;
+  node->beta = beta;
+  node->backward_window_size = backward_window_size;
+  node->per_task_early_stopping = per_task_early_stopping;
+  node->plateau_threshold = plateau_threshold;
+  node->num_parallel_tasks = std::min(num_parallel_tasks, static_cast<int>(num_tasks));
+  node->task_cts.assign(num_tasks, 0);
+  node->task_best_cts.assign(num_tasks, 0);
+  node->task_costs_history.resize(num_tasks);
+  node->best_costs.assign(num_tasks, kInvalidCost);
+  node->ct = 0;
+  node->num_measures_per_round_ = 0;
+  node->verbose_ = 0;
+  node->rand_gen_ = std::mt19937(seed);
+
+  // Build similarity groups
+  for (size_t i = 0; i < num_tasks; ++i) {
+    std::string tag = DeriveSimilarityTag(node->tasks[i]->compute_dag);
+    if (!tag.empty()) {
+      node->tag_to_task_ids_[tag].push_back(i);
+    }
+    node->task_tags_.push_back(std::move(tag));
+  }
+  data_ = std::move(node);
+}
+
+double TaskSchedulerNode::ComputeScore(const std::vector<double>& costs) const {
+  double score = 0;
+  for (size_t i = 0; i < costs.size(); ++i) {
+    score += task_weights[i] * costs[i];
+  }
+  return score;
+}
+
+void TaskSchedulerNode::Tune(const TuningOptions& tuning_options) {
+  verbose_ = tuning_options->verbose;
+  int early_stopping_all = tuning_options->early_stopping < 0 ? std::numeric_limits<int>::max()
+                                                              : tuning_options->early_stopping;
+
+  // Make sure every task is tuned at least once
+  num_measures_per_round_ =
+      std::min(tuning_options->num_measures_per_round,
+               tuning_options->num_measure_trials / static_cast<int>(tasks.size()));
+  ICHECK_GT(num_measures_per_round_, 0)
+      << "num_measure_trials is too small. Please set it to a higher value.";
+
+  TaskRounds rounds(this, tuning_options, num_measures_per_round_);
+
+  // Do a round robin first to warm up
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    if (task_cts[i]) {
+      continue;
+    }
+    if (static_cast<int>(rounds.running().size()) == num_parallel_tasks) {
+      TaskRounds::Round round = rounds.WaitOne();
+      UpdateTask(round.task_idx, round.inputs, round.results);
+    }
+    rounds.Launch(i);
+  }
+  while (!rounds.running().empty()) {
+    TaskRounds::Round round = rounds.WaitOne();
+    UpdateTask(round.task_idx, round.inputs, round.results);
+  }
+  int best_ct = ct;
+  double best_score = ComputeScore(best_costs);
+
+  // Use the specific strategy to choose the task to tune. Launch rounds as long as the trials
+  // they will take are in the budget and there are idle live tasks, otherwise finish a round.
+  int task_idx = -1;
+  while (true) {
+    int num_running = rounds.running().size();
+    int next_idx = -1;
+    if (num_running < num_parallel_tasks &&
+        ct + num_running * num_measures_per_round_ < tuning_options->num_measure_trials) {
+      next_idx = strategy == "round-robin" ? PickTaskByRoundRobin(task_idx, rounds.running())
+                                           : PickTaskByGradient(rounds.running());
+    }
+    if (next_idx >= 0) {
+      task_idx = next_idx;
+      rounds.Launch(task_idx);
+      continue;
+    }
+    if (num_running == 0) {
+      break;
+    }
+
+    TaskRounds::Round round = rounds.WaitOne();
+    UpdateTask(round.task_idx, round.inputs, round.results);
+    AdjustSimilarityGroup(round.task_idx);
+
+    double score = ComputeScore(best_costs);
+    if (score < best_score) {
+      best_score = score;
+      best_ct = ct;
+    } else if (ct - best_ct >= early_stopping_all &&
+               std::all_of(best_costs.begin(), best_costs.end(),
+                           [](double cost) { return cost < kInvalidCost; })) {
+      StdCout(verbose_) << "TaskScheduler: Stop early since no performance improvement in the "
+                        << "last " << early_stopping_all << " measurement trials." << std::endl;
+      break;
+    }
+  }
+  // Finish the rounds still running
+  while (!rounds.running().empty()) {
+    TaskRounds::Round round = rounds.WaitOne();
+    UpdateTask(round.task_idx, round.inputs, round.results);
+  }
+  StdCout(verbose_) << "TaskScheduler: Done. Total trials: " << ct
+                    << "\tEstimated latency: " << ComputeScore(best_costs) * 1e3 << " ms"
+                    << std::endl;
+}
+
+void TaskSchedulerNode::UpdateTask(int task_idx, const Array<MeasureInput>& inputs,
+                                   const Array<MeasureResult>& results) {
+  task_cts[task_idx]++;
+  for (const auto& res : results) {
+    if (res->error_no != static_cast<int>(MeasureErrorNO::kNoError)) {
+      continue;
+    }
+    double cost = FloatArrayMean(res->costs);
+    if (cost < best_costs[task_idx]) {
+      task_best_cts[task_idx] = task_cts[task_idx];
+      best_costs[task_idx] = cost;
+    }
+  }
+  std::vector<double>& history = task_costs_history[task_idx];
+  history.push_back(best_costs[task_idx]);
+
+  // Stop tuning this task if its search space has been fully explored, it has no improvement for
+  // a long while, or its improvement over the last rounds has plateaued.
+  int no_change_trials =
+      (task_cts[task_idx] - task_best_cts[task_idx]) * static_cast<int>(inputs.size());
+  bool plateaued = false;
+  if (plateau_threshold > 0 && static_cast<int>(history.size()) > backward_window_size) {
+    double prev = history[history.size() - 1 - backward_window_size];
+    if (prev < kInvalidCost) {
+      plateaued = (prev - history.back()) / prev < plateau_threshold;
+    }
+  }
+  if (inputs.empty() || plateaued ||
+      (per_task_early_stopping >= 0 && no_change_trials > per_task_early_stopping)) {
+    dead_tasks.insert(task_idx);
+  }
+
+  ct += inputs.size();
+  StdCout(verbose_) << "TaskScheduler: Task " << task_idx << "\tRound: " << task_cts[task_idx]
+                    << "\tLatency: " << best_costs[task_idx] * 1e3 << " ms"
+                    << "\tTotal trials: " << ct
+                    << "\tEstimated latency: " << ComputeScore(best_costs) * 1e3 << " ms"
+                    << (dead_tasks.count(task_idx) ? "\t(stopped)" : "") << std::endl;
+}
+
+int TaskSchedulerNode::PickTaskByRoundRobin(int last_idx, const std::unordered_set<int>& busy) {
+  int num_tasks = tasks.size();
+  for (int i = 1; i <= num_tasks; ++i) {
+    int task_idx = (last_idx + i) % num_tasks;
+    if (!dead_tasks.count(task_idx) && !busy.count(task_idx)) {
+      return task_idx;
+    }
+  }
+  return -1;
+}
+
+int TaskSchedulerNode::PickTaskByGradient(const std::unordered_set<int>& busy) {
+  std::vector<int> candidates;
+  std::vector<double> gradients;
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    if (dead_tasks.count(i) || busy.count(i)) {
+      continue;
+    }
+
+    // The objective is linear in the task latencies, so the chain rule term is the task weight
+    double chain_grad = task_weights[i];
+
+    // (g_i(t_i) - g_i(t_i - \Delta t)) / (\Delta t)
+    double backward_grad = 0;
+    const std::vector<double>& history = task_costs_history[i];
+    int last = task_cts[i] - 1;
+    if (last < static_cast<int>(history.size()) && last - backward_window_size >= 0) {
+      backward_grad = (history[last] - history[last - backward_window_size]) / backward_window_size;
+    }
+
+    // (g_i(t_i + \Delta t) - g_i(t_i)) / (\Delta t)
+    double g_next_1 = best_costs[i] - best_costs[i] / task_cts[i];
+    double g_next_2 = beta * 1e30;
+    const std::string& tag = task_tags_[i];
+    if (!tag.empty() && tag_to_task_ids_[tag].size() > 1) {
+      double best_flops = 0;
+      for (int j : tag_to_task_ids_[tag]) {
+        best_flops = std::max(best_flops, tasks[j]->compute_dag->flop_ct / best_costs[j]);
+      }
+      g_next_2 = beta * tasks[i]->compute_dag->flop_ct / best_flops;
+    }
+    double forward_grad = std::min(g_next_1, g_next_2) - best_costs[i];
+
+    candidates.push_back(i);
+    gradients.push_back(chain_grad * (alpha * backward_grad + (1 - alpha) * forward_grad));
+  }
+  if (candidates.empty()) {
+    return -1;
+  }
+
+  auto min_it = std::min_element(gradients.begin(), gradients.end());
+  auto max_it = std::max_element(gradients.begin(), gradients.end());
+  if (*min_it == *max_it) {
+    // No task looks more promising than the others, pick one randomly
+    return candidates[rand_gen_() % candidates.size()];
+  }
+  return candidates[min_it - gradients.begin()];
+}
+
+void TaskSchedulerNode::AdjustSimilarityGroup(int task_idx) {
+  const std::string& tag = task_tags_[task_idx];
+  if (tag.empty() || tag_to_task_ids_[tag].size() <= 1) {
+    return;
+  }
+  std::vector<int>& group = tag_to_task_ids_[tag];
+  double best_group_flops = 0;
+  int max_other_ct = 0;
+  for (int j : group) {
+    best_group_flops = std::max(best_group_flops, tasks[j]->compute_dag->flop_ct / best_costs[j]);
+    if (j != task_idx) {
+      max_other_ct = std::max(max_other_ct, task_cts[j]);
+    }
+  }
+  double cur_flops = tasks[task_idx]->compute_dag->flop_ct / best_costs[task_idx];
+
+  // If we tune a task for many times but it still cannot achieve a similar speed to the fastest
+  // one in its group, this task is actually not similar to the other tasks in its group.
+  if (cur_flops < best_group_flops / beta && task_cts[task_idx] > 5 + max_other_ct) {
+    FindAndDeleteItem(&group, task_idx);
+    task_tags_[task_idx] = "";
+  }
+}
+
+TVM_REGISTER_GLOBAL("auto_scheduler.TaskScheduler")
+    .set_body_typed([](Array<SearchTask> tasks, Array<SearchPolicy> search_policies,
+                       Array<FloatImm> task_weights, String strategy, double alpha, double beta,
+                       int backward_window_size, int per_task_early_stopping,
+                       double plateau_threshold, int num_parallel_tasks, int seed) {
+      return TaskScheduler(tasks, search_policies, task_weights, strategy, alpha, beta,
+                           backward_window_size, per_task_early_stopping, plateau_threshold,
+                           num_parallel_tasks, seed);
+    });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.TaskSchedulerTune")
+    .set_body_typed([](TaskScheduler scheduler, TuningOptions tuning_options) {
+      scheduler->Tune(tuning_options);
+    });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.TaskSchedulerUpdateTask")
+    .set_body_typed([](TaskScheduler scheduler, int task_idx, Array<MeasureInput> inputs,
+                       Array<MeasureResult> results) {
+      scheduler->UpdateTask(task_idx, inputs, results);
+    });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.TaskSchedulerDeadTasks")
+    .set_body_typed([](TaskScheduler scheduler) {
+      Array<Integer> ret;
+      for (int task_idx : scheduler->dead_tasks) {
+        ret.push_back(task_idx);
+      }
+      return ret;
+    });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.TaskSchedulerBestCosts")
+    .set_body_typed([](TaskScheduler scheduler) {
+      Array<FloatImm> ret;
+      for (double cost : scheduler->best_costs) {
+        ret.push_back(FloatImm(DataType::Float(64), cost));
+      }
+      return ret;
+    });
+
+}  // namespace auto_scheduler
+}  // namespace tvm
@@ -26,13 +26,16 @@
 #define TVM_AUTO_SCHEDULER_UTILS_H_
 
 #include <dmlc/common.h>
+#include <tvm/runtime/registry.h>
 #include <tvm/tir/expr.h>
 
 #include <algorithm>
+#include <condition_variable>
 #include <deque>
 #include <exception>
 #include <future>
 #include <iomanip>
+#include <mutex>
 #include <numeric>
 #include <random>
 #include <string>
@@ -296,6 +299,62 @@ inline void ParseKernelLayout(const String& layout, Array<PrimExpr>* shape,
 /*! \brief Get the base name before '_' of an axis */
 inline std::string AxisBaseName(const std::string& str) { return str.substr(0, str.rfind("_")); }
 
+/*!
+ * \brief An event for a thread to wait for worker threads which call python functions, such as
+ * the builders, runners and cost models.
+ * The waiting thread may hold the GIL, which the workers need, so it waits on the python event
+ * created by "auto_scheduler.measure_pipeline_event" if it is registered, as waiting on it
+ * releases the GIL. Otherwise it waits on a condition variable.
+ */
+class WorkerEvent {
+ public:
+  WorkerEvent() {
+    if (const auto* f = runtime::Registry::Get("auto_scheduler.measure_pipeline_event")) {
+      event_ = (*f)();
+    }
+  }
+
+  /*! \brief Wake up the waiting thread. Must be called without holding the mutex it waits with. */
+  void Notify() {
+    cv_.notify_all();
+    if (event_ != nullptr) {
+      event_(static_cast<int>(kSet));
+    }
+  }
+
+  /*!
+   * \brief Block the calling thread until pred() holds.
+   * \param lock The lock of the mutex guarding the state checked by pred, held by the caller.
+   * \param pred The condition to wait for.
+   */
+  template <typename FPred>
+  void WaitUntil(std::unique_lock<std::mutex>* lock, FPred pred) {
+    if (event_ == nullptr) {
+      cv_.wait(*lock, pred);
+      return;
+    }
+    while (true) {
+      // Clear the event before checking, so that a notification after the check is not lost
+      lock->unlock();
+      event_(static_cast<int>(kClear));
+      lock->lock();
+      if (pred()) {
+        return;
+      }
+      lock->unlock();
+      event_(static_cast<int>(kWait));
+      lock->lock();
+    }
+  }
+
+ private:
+  /*! \brief The operations of the python event. */
+  enum EventOp : int { kClear = 0, kSet = 1, kWait = 2 };
+
+  runtime::PackedFunc event_;
+  std::condition_variable cv_;
+};
+
 }  // namespace auto_scheduler
 }  // namespace tvm
 
@@ -43,6 +43,11 @@ TVM_REGISTER_PASS_CONFIG_OPTION("tir.detect_global_barrier", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.instrument_bound_checkers", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.disable_assert", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.disable_vectorize", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.enable_loop_tiling", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.enable_software_prefetch", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.enable_vectorize_reduction", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.enable_vectorize_gather", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.enable_index_strength_reduction", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.add_lower_pass", Array<Array<ObjectRef>>);
 
 using runtime::PackedFunc;
@@ -149,6 +154,10 @@ IRModule lower(te::Schedule sch, const Array<te::Tensor>& args, const std::strin
 
   bool noalias = pass_ctx->GetConfig<Bool>("tir.noalias", Bool(true)).value();
   bool disable_vectorize = pass_ctx->GetConfig<Bool>("tir.disable_vectorize", Bool(false)).value();
+  bool enable_loop_tiling =
+      pass_ctx->GetConfig<Bool>("tir.enable_loop_tiling", Bool(false)).value();
+  bool enable_index_strength_reduction =
+      pass_ctx->GetConfig<Bool>("tir.enable_index_strength_reduction", Bool(false)).value();
   bool instrument_bound_checkers =
       pass_ctx->GetConfig<Bool>("tir.instrument_bound_checkers", Bool(false)).value();
 
@@ -161,11 +170,16 @@ IRModule lower(te::Schedule sch, const Array<te::Tensor>& args, const std::strin
 
   // Phase 0
   pass_list.push_back(tir::transform::InjectPrefetch());
+  if (enable_loop_tiling) {
+    pass_list.push_back(tir::transform::LoopTiling());
+  }
   pass_list.push_back(tir::transform::StorageFlatten(64, instrument_bound_checkers));
+  pass_list.push_back(tir::transform::SpecializeShapes());
   // Phase 1
   pass_list.push_back(tir::transform::BF16Legalize());
   pass_list.push_back(tir::transform::NarrowDataType(32));
   pass_list.push_back(tir::transform::Simplify());
+  pass_list.push_back(tir::transform::LoopProfile());
   pass_list.push_back(tir::transform::LoopPartition());
   pass_list.push_back(tir::transform::VectorizeLoop(!disable_vectorize));
   pass_list.push_back(tir::transform::InjectVirtualThread());
@@ -176,6 +190,9 @@ IRModule lower(te::Schedule sch, const Array<te::Tensor>& args, const std::strin
   pass_list.push_back(tir::transform::Simplify());
   pass_list.push_back(tir::transform::RemoveNoOp());
   pass_list.push_back(tir::transform::RewriteUnsafeSelect());
+  if (enable_index_strength_reduction) {
+    pass_list.push_back(tir::transform::IndexStrengthReduction());
+  }
   if (instrument_bound_checkers) {
     pass_list.push_back(tir::transform::InstrumentBoundCheckers());
   }
@@ -193,6 +210,13 @@ std::pair<IRModule, IRModule> SplitDevHostFuncs(IRModule mod_mixed, const Target
   Array<tvm::transform::Pass> mixed_pass_list = {BindTarget(target),
                                                  tir::transform::VerifyMemory()};
 
+  if (pass_ctx->GetConfig<Bool>("tir.enable_vectorize_reduction", Bool(false)).value()) {
+    mixed_pass_list.push_back(tir::transform::VectorizeReduction());
+  }
+  if (pass_ctx->GetConfig<Bool>("tir.enable_software_prefetch", Bool(false)).value()) {
+    mixed_pass_list.push_back(tir::transform::InjectSoftwarePrefetch());
+  }
+
   if (pass_ctx->GetConfig<Bool>("tir.detect_global_barrier", Bool(false)).value()) {
     mixed_pass_list.push_back(tir::transform::ThreadSync("global"));
   }
@@ -319,6 +319,14 @@ class RelayBuildModule : public runtime::ModuleNode {
     pass_seqs.push_back(transform::FastMath());
     pass_seqs.push_back(transform::FoldConstant());
 
+    // Recompute activations to fit the memory budget, after the passes
+    // which would eliminate the recomputations as common subexpressions.
+    int64_t memory_budget = backend::GetMemoryBudget();
+    if (memory_budget > 0) {
+      pass_seqs.push_back(transform::InferType());
+      pass_seqs.push_back(transform::Rematerialize(Integer(memory_budget)));
+    }
+
     // Create a sequential pass and perform optimizations.
     transform::Pass seq = transform::Sequential(pass_seqs);
     if (targets.size() == 1) {
@@ -28,6 +28,7 @@
 #include <tvm/tir/op.h>
 
 #include "../../support/arena.h"
+#include "utils.h"
 
 namespace tvm {
 namespace relay {
@@ -197,6 +198,7 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
 
   // Run storage allocation for a function.
   Map<Expr, Array<IntegerArray> > Plan(const Function& func) {
+    enable_inplace_ = backend::IsInplaceEnabled();
     prototype_ = StorageAllocaInit(&arena_).GetInitTokenMap(func);
     this->Run(func);
 
@@ -260,7 +262,9 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
       }
     }
     // create token for the call node.
-    CreateToken(op, true);
+    if (!ReuseInput(op, args)) {
+      CreateToken(op, true);
+    }
     // check if there is orphaned output that can be released immediately.
     for (StorageToken* tok : token_map_.at(op)) {
       CheckForRelease(tok);
@@ -270,6 +274,37 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
       CheckForRelease(tok);
     }
   }
+  /*!
+   * \brief Write the output of an elementwise call into an input which is
+   *  last used by the call.
+   * \param op The call node.
+   * \param args The tokens of the arguments.
+   * \return Whether an input is reused.
+   */
+  bool ReuseInput(const CallNode* op, const std::vector<StorageToken*>& args) {
+    const auto* func = op->op.as<FunctionNode>();
+    if (!enable_inplace_ || func == nullptr) return false;
+    auto it = prototype_.find(op);
+    ICHECK(it != prototype_.end());
+    if (it->second.size() != 1) return false;
+    StorageToken* prototype = it->second[0];
+    for (size_t i : backend::GetInplaceParams(GetRef<Function>(func))) {
+      const std::vector<StorageToken*>& tokens = token_map_.at(op->args[i].operator->());
+      if (tokens.size() != 1) continue;
+      StorageToken* tok = tokens[0];
+      int uses = static_cast<int>(std::count(args.begin(), args.end(), tok));
+      // parameters, constants and outputs hold an extra reference.
+      if (tok->ref_counter != uses || tok->device_type != prototype->device_type ||
+          tok->max_bytes < GetMemorySize(prototype)) {
+        continue;
+      }
+      // the references of the arguments are released after the call.
+      tok->ref_counter = prototype->ref_counter + uses;
+      token_map_[op] = {tok};
+      return true;
+    }
+    return false;
+  }
   /*!
    * \brief ceil(size/word_size) to get number of words.
    * \param size The original size.
@@ -367,6 +402,8 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
   support::Arena arena_;
   // scale used for rough match
   size_t match_range_{16};
+  // whether to write the outputs of elementwise calls into their inputs
+  bool enable_inplace_{false};
   // free list of storage entry
   std::multimap<size_t, StorageToken*> free_;
   // all the storage resources available
@@ -381,5 +418,18 @@ Map<Expr, Array<IntegerArray> > GraphPlanMemory(const Function& func) {
 
 TVM_REGISTER_GLOBAL("relay.backend.GraphPlanMemory").set_body_typed(GraphPlanMemory);
 
+namespace backend {
+
+int64_t GraphPlanMemoryBytes(const Function& func) {
+  StorageAllocator allocator;
+  allocator.Plan(func);
+  return static_cast<int64_t>(allocator.TotalAllocBytes());
+}
+
+}  // namespace backend
+
+TVM_REGISTER_GLOBAL("relay.backend.GraphPlanMemoryBytes")
+    .set_body_typed(backend::GraphPlanMemoryBytes);
+
 }  // namespace relay
 }  // namespace tvm
@@ -28,6 +28,7 @@
 #include <tvm/driver/driver_api.h>
 #include <tvm/relay/expr.h>
 #include <tvm/relay/expr_functor.h>
+#include <tvm/relay/op_attr_types.h>
 #include <tvm/relay/transform.h>
 #include <tvm/relay/type.h>
 #include <tvm/target/codegen.h>
@@ -312,6 +313,73 @@ inline bool IsCompileEngineCacheDisabled() {
       .value();
 }
 
+/*!
+ * \brief Return whether the outputs of elementwise operators can be written
+ *  into their dead inputs, as set in the pass context.
+ */
+inline bool IsInplaceEnabled() {
+  return transform::PassContext::Current()
+      ->GetConfig<Bool>("relay.backend.enable_inplace", Bool(false))
+      .value();
+}
+
+/*!
+ * \brief Return the number of bytes the storage of a function may take, as
+ *  set in the pass context. Zero means there is no budget.
+ */
+inline int64_t GetMemoryBudget() {
+  return transform::PassContext::Current()
+      ->GetConfig<Integer>("relay.backend.memory_budget", Integer(0))
+      .value()
+      ->value;
+}
+
+/*!
+ * \brief Get the number of bytes of the storage planned for a function by
+ *  GraphPlanMemory, including the storage of its parameters and constants.
+ *
+ * \param func The function, with checked types.
+ * \return The total number of bytes.
+ */
+int64_t GraphPlanMemoryBytes(const Function& func);
+
+/*!
+ * \brief Get the parameters of a primitive function whose buffer can hold
+ *  the output of the function.
+ *
+ *  The function must only contain elementwise and broadcast operators, in
+ *  which the parameters with the type of the output are read at the index
+ *  of the element being written.
+ *
+ * \param func The primitive function.
+ * \return The indices of the parameters.
+ */
+inline std::vector<size_t> GetInplaceParams(const Function& func) {
+  std::vector<size_t> params;
+  if (func->GetAttr<String>(attr::kCompiler).defined()) return params;
+  const auto* out_type = func->body->checked_type().as<TensorTypeNode>();
+  if (out_type == nullptr) return params;
+  static auto fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
+  bool elemwise = true;
+  PostOrderVisit(func->body, [&](const Expr& expr) {
+    if (const auto* call = expr.as<CallNode>()) {
+      const auto* op = call->op.as<OpNode>();
+      elemwise &= op != nullptr && fpattern.count(GetRef<Op>(op)) &&
+                  fpattern[GetRef<Op>(op)] <= kBroadcast;
+    } else {
+      elemwise &= expr->IsInstance<VarNode>() || expr->IsInstance<ConstantNode>() ||
+                  expr->IsInstance<OpNode>();
+    }
+  });
+  if (!elemwise) return params;
+  for (size_t i = 0; i < func->params.size(); ++i) {
+    if (StructuralEqual()(func->params[i]->checked_type(), GetRef<Type>(out_type))) {
+      params.push_back(i);
+    }
+  }
+  return params;
+}
+
 }  // namespace backend
 }  // namespace relay
 }  // namespace tvm
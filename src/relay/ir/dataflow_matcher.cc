@@ -27,7 +27,9 @@
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/transform.h>
 
+#include <algorithm>
 #include <stack>
+#include <vector>
 
 #include "indexed_graph.h"
 
@@ -533,6 +535,245 @@ bool MatchPattern(DFPattern pattern, Expr expr) {
 
 TVM_REGISTER_GLOBAL("relay.dataflow_pattern.match").set_body_typed(MatchPattern);
 
+// Pattern Index
+
+/*!
+ * \brief The expressions the root of a pattern can match.
+ *
+ * It is a necessary condition of a match, used to prune the nodes tried against a pattern
+ * without running the matcher on them.
+ */
+struct PatternRoot {
+  /*! \brief Whether the root matches any kind of expression. */
+  bool any_kind{true};
+  /*! \brief The type index of the matched expressions. */
+  uint32_t type_index{0};
+  /*! \brief Whether a matched call can have any callee. */
+  bool any_op{true};
+  /*! \brief The operators of the matched calls. */
+  std::vector<const Object*> ops;
+  /*! \brief The number of arguments of a matched call or fields of a matched tuple, -1 for any. */
+  int arity{-1};
+
+  static PatternRoot Kind(uint32_t type_index, int arity = -1) {
+    PatternRoot root;
+    root.any_kind = false;
+    root.type_index = type_index;
+    root.arity = arity;
+    return root;
+  }
+
+  /*! \return The root matching the expressions of both roots. */
+  static PatternRoot Union(const PatternRoot& lhs, const PatternRoot& rhs) {
+    if (lhs.any_kind || rhs.any_kind || lhs.type_index != rhs.type_index) return PatternRoot();
+    PatternRoot root = Kind(lhs.type_index, lhs.arity == rhs.arity ? lhs.arity : -1);
+    root.any_op = lhs.any_op || rhs.any_op;
+    if (!root.any_op) {
+      root.ops = lhs.ops;
+      for (const Object* op : rhs.ops) {
+        if (std::find(root.ops.begin(), root.ops.end(), op) == root.ops.end()) {
+          root.ops.push_back(op);
+        }
+      }
+    }
+    return root;
+  }
+
+  /*! \return Whether the expression can match the root. */
+  bool Admits(const Expr& expr) const {
+    if (any_kind) return true;
+    if (expr->type_index() != type_index) return false;
+    if (const auto* call = expr.as<CallNode>()) {
+      if (arity >= 0 && static_cast<int>(call->args.size()) != arity) return false;
+      return any_op || std::find(ops.begin(), ops.end(), call->op.get()) != ops.end();
+    }
+    if (const auto* tuple = expr.as<TupleNode>()) {
+      return arity < 0 || static_cast<int>(tuple->fields.size()) == arity;
+    }
+    return true;
+  }
+};
+
+/*! \brief Find the root of a pattern. */
+class PatternRootFinder : public DFPatternFunctor<PatternRoot(const DFPattern&)> {
+ public:
+  PatternRoot VisitDFPattern_(const AltPatternNode* op) final {
+    return PatternRoot::Union(VisitDFPattern(op->left), VisitDFPattern(op->right));
+  }
+  PatternRoot VisitDFPattern_(const AttrPatternNode* op) final {
+    return VisitDFPattern(op->pattern);
+  }
+  PatternRoot VisitDFPattern_(const CallPatternNode* op) final {
+    PatternRoot root = PatternRoot::Kind(CallNode::RuntimeTypeIndex(),
+                                         op->args.defined() ? op->args.size() : -1);
+    root.any_op = !CalleeOps(op->op, &root.ops);
+    // the matcher reassociates products and quotients, so either operator can be the root.
+    static const Op& multiply = Op::Get("multiply");
+    static const Op& divide = Op::Get("divide");
+    auto has = [&root](const Op& op) {
+      return std::find(root.ops.begin(), root.ops.end(), op.get()) != root.ops.end();
+    };
+    if (has(multiply) && !has(divide)) root.ops.push_back(divide.get());
+    if (has(divide) && !has(multiply)) root.ops.push_back(multiply.get());
+    return root;
+  }
+  PatternRoot VisitDFPattern_(const ConstantPatternNode* op) final {
+    return PatternRoot::Kind(ConstantNode::RuntimeTypeIndex());
+  }
+  PatternRoot VisitDFPattern_(const DataTypePatternNode* op) final {
+    return VisitDFPattern(op->pattern);
+  }
+  PatternRoot VisitDFPattern_(const DominatorPatternNode* op) final {
+    return VisitDFPattern(op->child);
+  }
+  PatternRoot VisitDFPattern_(const ExprPatternNode* op) final {
+    return PatternRoot::Kind(op->expr->type_index());
+  }
+  PatternRoot VisitDFPattern_(const FunctionPatternNode* op) final {
+    return PatternRoot::Kind(FunctionNode::RuntimeTypeIndex());
+  }
+  PatternRoot VisitDFPattern_(const IfPatternNode* op) final {
+    return PatternRoot::Kind(IfNode::RuntimeTypeIndex());
+  }
+  PatternRoot VisitDFPattern_(const LetPatternNode* op) final {
+    return PatternRoot::Kind(LetNode::RuntimeTypeIndex());
+  }
+  PatternRoot VisitDFPattern_(const ShapePatternNode* op) final {
+    return VisitDFPattern(op->pattern);
+  }
+  PatternRoot VisitDFPattern_(const TupleGetItemPatternNode* op) final {
+    return PatternRoot::Kind(TupleGetItemNode::RuntimeTypeIndex());
+  }
+  PatternRoot VisitDFPattern_(const TuplePatternNode* op) final {
+    return PatternRoot::Kind(TupleNode::RuntimeTypeIndex(),
+                             op->fields.defined() ? op->fields.size() : -1);
+  }
+  PatternRoot VisitDFPattern_(const TypePatternNode* op) final {
+    return VisitDFPattern(op->pattern);
+  }
+  PatternRoot VisitDFPattern_(const VarPatternNode* op) final {
+    return PatternRoot::Kind(VarNode::RuntimeTypeIndex());
+  }
+  PatternRoot VisitDFPattern_(const WildcardPatternNode* op) final { return PatternRoot(); }
+
+ private:
+  // Collect the operators the callee pattern can match, return false if it can match others.
+  static bool CalleeOps(const DFPattern& callee, std::vector<const Object*>* ops) {
+    if (const auto* expr_pattern = callee.as<ExprPatternNode>()) {
+      if (expr_pattern->expr.as<OpNode>() == nullptr) return false;
+      ops->push_back(expr_pattern->expr.get());
+      return true;
+    }
+    if (const auto* alt = callee.as<AltPatternNode>()) {
+      return CalleeOps(alt->left, ops) && CalleeOps(alt->right, ops);
+    }
+    if (const auto* attr = callee.as<AttrPatternNode>()) {
+      return CalleeOps(attr->pattern, ops);
+    }
+    return false;
+  }
+};
+
+/*!
+ * \brief An index of the nodes of an expression graph, keyed on the operator of the calls and
+ *  on the kind of the other expressions.
+ */
+class ExprIndex {
+ public:
+  explicit ExprIndex(const IndexedGraph<Expr>& graph) : graph_(graph) {
+    for (size_t i = 0; i < graph.topological_order_.size(); ++i) {
+      const Expr& expr = graph.topological_order_[i]->ref_;
+      if (const auto* call = expr.as<CallNode>()) {
+        calls_[call->op.get()].push_back(i);
+      }
+      kinds_[expr->type_index()].push_back(i);
+    }
+  }
+
+  /*!
+   * \brief Find the nodes whose expressions can match the root of a pattern.
+   * \return The candidate nodes, in topological order.
+   */
+  std::vector<size_t> Candidates(const PatternRoot& root) const {
+    std::vector<size_t> candidates;
+    auto add = [&](const std::vector<size_t>& nodes) {
+      for (size_t i : nodes) {
+        if (root.Admits(graph_.topological_order_[i]->ref_)) candidates.push_back(i);
+      }
+    };
+    if (root.any_kind) {
+      candidates.resize(graph_.topological_order_.size());
+      for (size_t i = 0; i < candidates.size(); ++i) candidates[i] = i;
+    } else if (root.type_index == CallNode::RuntimeTypeIndex() && !root.any_op) {
+      for (const Object* op : root.ops) {
+        auto it = calls_.find(op);
+        if (it != calls_.end()) add(it->second);
+      }
+      std::sort(candidates.begin(), candidates.end());
+    } else {
+      auto it = kinds_.find(root.type_index);
+      if (it != kinds_.end()) add(it->second);
+    }
+    return candidates;
+  }
+
+  /*! \return The nodes whose expressions have the type index, in topological order. */
+  const std::vector<size_t>& Kind(uint32_t type_index) const {
+    static const std::vector<size_t> empty;
+    auto it = kinds_.find(type_index);
+    return it != kinds_.end() ? it->second : empty;
+  }
+
+ private:
+  const IndexedGraph<Expr>& graph_;
+  // the calls of each operator
+  std::unordered_map<const Object*, std::vector<size_t>> calls_;
+  // the expressions of each kind
+  std::unordered_map<uint32_t, std::vector<size_t>> kinds_;
+};
+
+Array<Array<Expr>> MatchPatterns(const Array<DFPattern>& patterns, const Expr& expr) {
+  DFPatternMatcher matcher(expr);
+  // dispatch the nodes to the patterns whose root can match them.
+  std::vector<PatternRoot> roots;
+  std::unordered_map<const Object*, std::vector<size_t>> by_op;
+  std::unordered_map<uint32_t, std::vector<size_t>> by_kind;
+  std::vector<size_t> by_any;
+  for (size_t i = 0; i < patterns.size(); ++i) {
+    roots.push_back(PatternRootFinder().VisitDFPattern(patterns[i]));
+    const PatternRoot& root = roots.back();
+    if (root.any_kind) {
+      by_any.push_back(i);
+    } else if (root.type_index == CallNode::RuntimeTypeIndex() && !root.any_op) {
+      for (const Object* op : root.ops) by_op[op].push_back(i);
+    } else {
+      by_kind[root.type_index].push_back(i);
+    }
+  }
+  std::vector<Array<Expr>> matches(patterns.size());
+  auto match = [&](const Expr& current, const std::vector<size_t>& candidates) {
+    for (size_t i : candidates) {
+      if (roots[i].Admits(current) && matcher.Match(patterns[i], current)) {
+        matches[i].push_back(current);
+      }
+    }
+  };
+  const auto& order = matcher.expr_graph_.topological_order_;
+  for (size_t i = order.size(); i != 0; --i) {
+    const Expr& current = order[i - 1]->ref_;
+    if (const auto* call = current.as<CallNode>()) {
+      auto it = by_op.find(call->op.get());
+      if (it != by_op.end()) match(current, it->second);
+    }
+    auto it = by_kind.find(current->type_index());
+    if (it != by_kind.end()) match(current, it->second);
+    match(current, by_any);
+  }
+  return Array<Array<Expr>>(matches.begin(), matches.end());
+}
+
+TVM_REGISTER_GLOBAL("relay.dataflow_pattern.match_patterns").set_body_typed(MatchPatterns);
+
 /*!
  * \brief PatternGrouper does pre-rewriting pattern matching and analysis
  *
@@ -567,6 +808,8 @@ class PatternGrouper {
     pattern_graph_ = CreateIndexedGraph(pattern_);
     auto matcher = DFPatternMatcher(pre);
     matcher_ = &matcher;
+    ExprIndex index(matcher.expr_graph_);
+    index_ = &index;
     this->VisitExprs();
     return this->groups_;
   }
@@ -579,20 +822,25 @@ class PatternGrouper {
    * the graph may also match the pattern. With post-order traversal, we mark the smaller subgraph
    * as matched and fail to catch the larger subgraph. This problem is fixed by using pre-order
    * traversal.
+   *
+   * Only the nodes whose operator and arity fit the root of the pattern are visited.
    */
   void VisitExprs() {
+    const auto& order = matcher_->expr_graph_.topological_order_;
     std::unordered_set<Expr, ObjectPtrHash, ObjectPtrEqual> pre_partitioned;
-    for (size_t i = matcher_->expr_graph_.topological_order_.size(); i != 0; --i) {
-      size_t index = i - 1;
-      Expr current = matcher_->expr_graph_.topological_order_.at(index)->ref_;
+    for (size_t index : index_->Kind(FunctionNode::RuntimeTypeIndex())) {
+      auto op = order.at(index)->ref_.as<FunctionNode>();
+      if (op->attrs.defined() && op->attrs->dict.count(attr::kPartitionedFromPattern) != 0) {
+        pre_partitioned.insert(GetRef<Expr>(op));
+        PostOrderVisit(op->body,
+                       [&pre_partitioned](const Expr& expr) { pre_partitioned.insert(expr); });
+      }
+    }
+    std::vector<size_t> candidates =
+        index_->Candidates(PatternRootFinder().VisitDFPattern(pattern_));
+    for (auto it = candidates.rbegin(); it != candidates.rend(); ++it) {
+      Expr current = order.at(*it)->ref_;
       if (gid_assignments_.count(current) == 0) {  // Don't visit nodes we've already grouped
-        if (auto op = current.as<FunctionNode>()) {
-          if (op->attrs.defined() && op->attrs->dict.count(attr::kPartitionedFromPattern) != 0) {
-            pre_partitioned.insert(current);
-            PostOrderVisit(op->body,
-                           [&pre_partitioned](const Expr& expr) { pre_partitioned.insert(expr); });
-          }
-        }
         if (pre_partitioned.count(current) == 0 && matcher_->Match(pattern_, current)) {
           CreateGroup(current);
         }
@@ -827,6 +1075,7 @@ class PatternGrouper {
   std::unordered_map<int, Group> groups_;
   std::unordered_map<Expr, int, ObjectPtrHash, ObjectPtrEqual> gid_assignments_;
   DFPatternMatcher* matcher_ = nullptr;
+  const ExprIndex* index_ = nullptr;
   IndexedGraph<DFPattern> pattern_graph_;
   int gid_ = 0;
   int graph_number_ = 0;
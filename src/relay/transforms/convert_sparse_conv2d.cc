@@ -0,0 +1,188 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ *
+ * \file convert_sparse_conv2d.cc
+ *
+ * \brief Mutate 1x1 conv2d operator to sparse dense operator
+ *
+ * A 1x1 NHWC convolution multiplies each pixel by the (out, in) weight
+ * matrix, so it is a sparse_dense of the pixels reshaped into rows.
+ */
+#include <tvm/ir/expr.h>
+#include <tvm/relay/analysis.h>
+#include <tvm/relay/attrs/nn.h>
+#include <tvm/relay/attrs/transform.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/op_attr_types.h>
+#include <tvm/relay/transform.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../op/make_op.h"
+
+namespace tvm {
+namespace relay {
+
+// Check whether a conv2d is a 1x1 NHWC convolution which is a matrix product
+bool IsPointwiseNHWCConv2d(const CallNode* n) {
+  const auto* attrs = n->attrs.as<Conv2DAttrs>();
+  if (attrs->data_layout != "NHWC" || attrs->groups != 1) return false;
+  if (attrs->kernel_layout != "HWIO" && attrs->kernel_layout != "OHWI") return false;
+  auto is_all = [](const Array<IndexExpr>& values, int64_t expected) {
+    for (const auto& value : values) {
+      const auto* imm = value.as<IntImmNode>();
+      if (imm == nullptr || imm->value != expected) return false;
+    }
+    return true;
+  };
+  if (!is_all(attrs->strides, 1) || !is_all(attrs->dilation, 1) || !is_all(attrs->padding, 0)) {
+    return false;
+  }
+  return attrs->kernel_size.defined() && is_all(attrs->kernel_size, 1);
+}
+
+// Search 1x1 conv2d op weight name from Expr
+class Conv2dOpWeightVisitor : private ExprVisitor {
+ public:
+  Conv2dOpWeightVisitor() : conv2d_op_(Op::Get("nn.conv2d")) {}
+
+  Array<Array<String> > Search(const Expr& expr) {
+    VisitExpr(expr);
+    return memo_;
+  }
+
+ private:
+  void VisitExpr_(const CallNode* n) final {
+    if (n->op == conv2d_op_ && IsPointwiseNHWCConv2d(n)) {
+      const auto weight = n->args[1].as<VarNode>();
+      if (weight) {
+        const auto* attrs = n->attrs.as<Conv2DAttrs>();
+        memo_.push_back({weight->name_hint(), attrs->kernel_layout});
+      }
+    }
+    for (const auto& arg : n->args) {
+      VisitExpr(arg);
+    }
+  }
+  // Cache op
+  const Op& conv2d_op_;
+
+  Array<Array<String> > memo_;
+};  // SearchConv2dOpWeight
+
+Array<Array<String> > SearchConv2dOpWeight(const Expr& e) {
+  return Conv2dOpWeightVisitor().Search(e);
+}
+
+TVM_REGISTER_GLOBAL("relay.analysis.search_conv2d_op_weight").set_body_typed(SearchConv2dOpWeight);
+
+// Mutate ```nn.conv2d``` to ```reshape(nn.sparse_dense(reshape(data)))```
+class Conv2dToSparseDenseMutator : public ExprRewriter {
+ public:
+  Conv2dToSparseDenseMutator(const Array<ObjectRef>& weight_name,
+                             const Array<Array<PrimExpr> >& weight_shape)
+      : conv2d_op_(Op::Get("nn.conv2d")), sparse_dense_op_(Op::Get("nn.sparse_dense")) {
+    ICHECK_EQ(weight_name.size(), weight_shape.size());
+    for (size_t i = 0; i < weight_name.size(); ++i) {
+      ICHECK(weight_name[i]->IsInstance<runtime::StringObj>());
+      std::string k = weight_name[i].as<runtime::StringObj>()->data;
+      const auto& ws = weight_shape[i];
+      std::vector<int> v(ws.size());
+      for (size_t j = 0; j < ws.size(); ++j) {
+        v[j] = ws[j].as<IntImmNode>()->value;
+      }
+      target_weights_.emplace(k, v);
+    }
+  }
+
+  Expr Rewrite_(const CallNode* pre, const Expr& post) override {
+    if (pre->op != conv2d_op_ || !IsPointwiseNHWCConv2d(pre)) return post;
+    const auto weight = pre->args[1].as<VarNode>();
+    if (!weight || !target_weights_.count(weight->name_hint())) return post;
+    // The rows of the reshaped data need the static shape of the data
+    const auto* data_type = pre->args[0]->checked_type_.as<TensorTypeNode>();
+    if (data_type == nullptr) return post;
+    Array<Integer> data_shape;
+    for (const auto& dim : data_type->shape) {
+      const auto* imm = dim.as<IntImmNode>();
+      if (imm == nullptr) return post;
+      data_shape.push_back(Integer(imm->value));
+    }
+
+    const auto& prefix = weight->name_hint();
+    const auto& ws = target_weights_.at(prefix);
+    const auto data = post.as<CallNode>()->args[0];
+    auto ws_data_type = relay::TensorType({ws.at(0), ws.at(1), ws.at(2)}, DataType::Float(32));
+    auto ws_indices_type = relay::TensorType({ws.at(3)}, DataType::Int(32));
+    auto ws_indptr_type = relay::TensorType({ws.at(4)}, DataType::Int(32));
+    Var weight_data(prefix + ".data", ws_data_type);
+    Var weight_indices(prefix + ".indices", ws_indices_type);
+    Var weight_indptr(prefix + ".indptr", ws_indptr_type);
+    auto attrs = make_object<SparseDenseAttrs>();
+    attrs->sparse_lhs = false;
+
+    int64_t out_channels = static_cast<int64_t>(ws.at(4) - 1) * ws.at(1);
+    Expr rows = MakeReshape(data, {-1, data_shape[3]});
+    Expr out = Call(sparse_dense_op_, {rows, weight_data, weight_indices, weight_indptr},
+                    Attrs(attrs));
+    return MakeReshape(out, {data_shape[0], data_shape[1], data_shape[2], Integer(out_channels)});
+  }
+
+ private:
+  // Cached op
+  const Op& conv2d_op_;
+  const Op& sparse_dense_op_;
+  std::unordered_map<std::string, std::vector<int> > target_weights_;
+};  // class Conv2dToSparseDenseAlter
+
+Expr Conv2dToSparse(const Expr& e, const Array<ObjectRef>& weight_name,
+                    const Array<Array<PrimExpr> >& weight_shape) {
+  auto rewriter = Conv2dToSparseDenseMutator(weight_name, weight_shape);
+  return PostOrderRewrite(e, &rewriter);
+}
+
+namespace transform {
+
+Pass Conv2dToSparse(const Array<ObjectRef>& weight_name,
+                    const Array<Array<PrimExpr> >& weight_shape) {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        // Remove FreeVar warnings
+        auto f0 = Downcast<Function>(Conv2dToSparse(f, weight_name, weight_shape));
+        Array<Var> sparse_params = FreeVars(f0);
+        auto f1 = Function(sparse_params, f0->body, f0->ret_type, f0->type_params, f0->attrs);
+        Array<Var> params = FreeVars(f1);
+        for (const auto& var : sparse_params) {
+          params.push_back(var);
+        }
+        return Function(params, f1->body, f1->ret_type, f1->type_params, f1->attrs);
+      };
+  return CreateFunctionPass(pass_func, 4, "Conv2dToSparse", {"DeadCodeElimination"});
+}
+
+TVM_REGISTER_GLOBAL("relay._transform.Conv2dToSparse").set_body_typed(Conv2dToSparse);
+
+}  // namespace transform
+
+}  // namespace relay
+}  // namespace tvm
@@ -31,6 +31,8 @@
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/object.h>
 
+#include <unordered_set>
+
 #include "pattern_utils.h"
 
 namespace tvm {
@@ -73,6 +75,116 @@ bool ConstantCheck(const Expr& e) { return ConstantChecker().Check(e); }
 
 TVM_REGISTER_GLOBAL("relay.analysis.check_constant").set_body_typed(ConstantCheck);
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.FoldConstant.batched", Bool);
+
+/*!
+ * \brief Whether a call can be evaluated once its arguments are constant.
+ *  The ops which ConstantFolder evaluates without running them are excluded.
+ */
+bool IsEvaluableCall(const CallNode* call) {
+  static auto op_stateful = Op::GetAttrMap<TOpIsStateful>("TOpIsStateful");
+  static auto fnoncomputational = Op::GetAttrMap<TNonComputational>("TNonComputational");
+  static const Op& device_copy_op = Op::Get("device_copy");
+  static const Op& shape_of_op = Op::Get("shape_of");
+  static const Op& vm_shape_of_op = Op::Get("vm.shape_of");
+  static const Op& ndarray_size_op = Op::Get("ndarray_size");
+  // functions with zero arguments, like ones(shape=(4, 5)), are not folded.
+  if (call->args.size() == 0) return false;
+  const OpNode* op_node = call->op.as<OpNode>();
+  if (op_node == nullptr) return false;
+  Op op = GetRef<Op>(op_node);
+  if (op_stateful.get(op, false) || fnoncomputational.get(op, false)) return false;
+  return op != device_copy_op && op != shape_of_op && op != vm_shape_of_op &&
+         op != ndarray_size_op;
+}
+
+/*!
+ * \brief Collect the roots of the maximal constant subgraphs of an expression,
+ *  which ConstantFolder evaluates together.
+ *
+ *  A root is an evaluable call with constant inputs, which is used by an
+ *  expression that cannot be folded.
+ */
+class ConstantSubgraphCollector : private MixedModeVisitor {
+ public:
+  Array<Expr> Collect(const Expr& expr) {
+    this->VisitExpr(expr);
+    MarkRoot(expr);
+    return roots_;
+  }
+
+ private:
+  using MixedModeVisitor::VisitExpr_;
+
+  bool IsConstant(const Expr& expr) const {
+    return expr.as<ConstantNode>() != nullptr || foldable_.count(expr.get()) != 0;
+  }
+
+  void MarkRoot(const Expr& expr) {
+    if (const auto* tuple = expr.as<TupleNode>()) {
+      if (foldable_.count(tuple)) {
+        for (const Expr& field : tuple->fields) {
+          MarkRoot(field);
+        }
+      }
+    } else if (expr.as<CallNode>() && foldable_.count(expr.get()) &&
+               root_set_.insert(expr.get()).second) {
+      roots_.push_back(expr);
+    }
+  }
+
+  void VisitExpr_(const CallNode* call) final {
+    bool foldable = IsEvaluableCall(call);
+    for (const Expr& arg : call->args) {
+      foldable = foldable && IsConstant(arg);
+    }
+    if (foldable) {
+      foldable_.insert(call);
+    } else {
+      for (const Expr& arg : call->args) {
+        MarkRoot(arg);
+      }
+    }
+  }
+
+  void VisitExpr_(const TupleNode* tuple) final {
+    bool foldable = true;
+    for (const Expr& field : tuple->fields) {
+      foldable = foldable && IsConstant(field);
+    }
+    // a constant tuple is folded with its users.
+    if (foldable) foldable_.insert(tuple);
+  }
+
+  void VisitExpr_(const TupleGetItemNode* op) final { MarkRoot(op->tuple); }
+
+  void VisitExpr_(const FunctionNode* op) final {
+    // the calls of primitive functions are not folded.
+    if (op->HasNonzeroAttr(attr::kPrimitive)) return;
+    ExprVisitor::VisitExpr_(op);
+    MarkRoot(op->body);
+  }
+
+  void VisitExpr_(const LetNode* op) final {
+    ExprVisitor::VisitExpr_(op);
+    MarkRoot(op->value);
+    MarkRoot(op->body);
+  }
+
+  void VisitExpr_(const IfNode* op) final {
+    ExprVisitor::VisitExpr_(op);
+    MarkRoot(op->cond);
+    MarkRoot(op->true_branch);
+    MarkRoot(op->false_branch);
+  }
+
+  // the evaluable calls and tuples with constant inputs.
+  std::unordered_set<const Object*> foldable_;
+  // the roots in post order.
+  Array<Expr> roots_;
+  std::unordered_set<const Object*> root_set_;
+};
+
 // TODO(tvm-team) consider combine dead-code with constant folder.
 // or make a more powerful partial evaluator.
 class ConstantFolder : public MixedModeMutator {
@@ -87,6 +199,26 @@ class ConstantFolder : public MixedModeMutator {
 
   using MixedModeMutator::VisitExpr_;
 
+  /*!
+   * \brief Evaluate all the constant subgraphs of the expression in one module,
+   *  instead of one module for each call, and fold the expression.
+   */
+  Expr BatchFold(const Expr& expr) {
+    Array<Expr> roots = ConstantSubgraphCollector().Collect(expr);
+    if (roots.size() > 1) {
+      Expr values = ConstEvaluate(Tuple(roots));
+      const auto* tuple = values.as<TupleNode>();
+      ICHECK(tuple != nullptr && tuple->fields.size() == roots.size());
+      for (size_t i = 0; i < roots.size(); ++i) {
+        // the memo replaces each root with its value.
+        memo_[roots[i]] = tuple->fields[i];
+      }
+    }
+    // the remaining expressions, e.g. the ones which only become constant
+    // through a let binding or a branch, are folded one by one.
+    return this->Mutate(expr);
+  }
+
   Expr VisitExpr_(const LetNode* op) final {
     auto pre_visit = [this](const LetNode* op) {
       // Rely on the Memoizer to cache pre-visit values
@@ -371,6 +503,12 @@ class ConstantFolder : public MixedModeMutator {
 };
 
 Expr FoldConstant(const Expr& expr, const IRModule& mod) {
+  bool batched = transform::PassContext::Current()
+                     ->GetConfig<Bool>("relay.FoldConstant.batched", Bool(true))
+                     .value();
+  if (batched) {
+    return ConstantFolder(mod).BatchFold(expr);
+  }
   return ConstantFolder(mod).Mutate(expr);
 }
 
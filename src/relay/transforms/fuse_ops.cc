@@ -30,6 +30,8 @@
 #include <tvm/relay/transform.h>
 #include <tvm/tir/op.h>
 
+#include <algorithm>
+
 #include "../../support/arena.h"
 #include "pass_utils.h"
 #include "pattern_utils.h"
@@ -75,6 +77,13 @@ namespace relay {
       will still run correctly.
   - CommitFuse: mark all the nodes between source and post-dominator as the same group.
   - We use an Union-Find data structure to manage the groups.
+
+  When relay.FuseOps.cost_model is set, each fusion allowed by the rules above is
+  also checked with an analytic model of the latency of the kernels. The fusion saves
+  the traffic of the tensors which become internal to the group and the launches of
+  the merged kernels. It costs the recomputation of the producers which are read
+  through a broadcast, and the strided access of the injective ops fused into a
+  reduction. A fusion is only committed when it does not increase the modeled latency.
 */
 using support::LinkedList;
 using support::LinkNode;
@@ -85,6 +94,109 @@ static const Op& stop_fusion_op = Op::Get("annotation.stop_fusion");
 
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.FuseOps.max_depth", Integer);
 
+struct FuseOpsCostModelConfigNode : public tvm::AttrsNode<FuseOpsCostModelConfigNode> {
+  double bandwidth;
+  double throughput;
+  double launch_overhead;
+  double injective_penalty;
+
+  TVM_DECLARE_ATTRS(FuseOpsCostModelConfigNode, "relay.transform.FuseOpsCostModelConfig") {
+    TVM_ATTR_FIELD(bandwidth)
+        .describe("The memory bandwidth of the device in bytes per nanosecond")
+        .set_default(20.0);
+    TVM_ATTR_FIELD(throughput)
+        .describe("The throughput of the device in elementwise operations per nanosecond")
+        .set_default(50.0);
+    TVM_ATTR_FIELD(launch_overhead)
+        .describe("The overhead of launching a kernel in nanoseconds")
+        .set_default(1000.0);
+    TVM_ATTR_FIELD(injective_penalty)
+        .describe("The extra traffic, relative to the size of its output, of an injective op "
+                  "fused into a reduction, which reads its inputs with a strided pattern")
+        .set_default(1.0);
+  }
+};
+
+class FuseOpsCostModelConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(FuseOpsCostModelConfig, Attrs,
+                                            FuseOpsCostModelConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(FuseOpsCostModelConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.FuseOps.cost_model", FuseOpsCostModelConfig);
+
+/*! \brief Analytic roofline model of the kernels of a fused program. */
+class FusionCostModel {
+ public:
+  explicit FusionCostModel(const FuseOpsCostModelConfigNode* cfg) : cfg_(cfg) {}
+
+  /*!
+   * \brief Get the number of elements and the size of a type.
+   * \return false if the type has a symbolic shape or is not made of tensors.
+   */
+  static bool TensorSize(const Type& type, double* numel, double* bytes) {
+    *numel = 0;
+    *bytes = 0;
+    if (const auto* ttype = type.as<TensorTypeNode>()) {
+      double n = 1;
+      for (const PrimExpr& dim : ttype->shape) {
+        const auto* imm = dim.as<IntImmNode>();
+        if (imm == nullptr) return false;
+        n *= static_cast<double>(imm->value);
+      }
+      *numel = n;
+      *bytes = n * ttype->dtype.bytes() * ttype->dtype.lanes();
+      return true;
+    } else if (const auto* tuple = type.as<TupleTypeNode>()) {
+      for (const Type& field : tuple->fields) {
+        double n, b;
+        if (!TensorSize(field, &n, &b)) return false;
+        *numel += n;
+        *bytes += b;
+      }
+      return true;
+    }
+    return false;
+  }
+
+  /*!
+   * \brief Get the number of elementwise operations of a call to an op.
+   * \return false if it is unknown.
+   */
+  static bool Work(const CallNode* call, double* work) {
+    static auto fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
+    *work = 0;
+    if (!call->checked_type_.defined()) return false;
+    double bytes;
+    Type type = call->checked_type();
+    if (const auto* op = call->op.as<OpNode>()) {
+      // a reduction does one operation per element of its input.
+      if (fpattern.get(GetRef<Op>(op), kOpaque) == kCommReduce && call->args.size() != 0 &&
+          call->args[0]->checked_type_.defined()) {
+        type = call->args[0]->checked_type();
+      }
+    }
+    return TensorSize(type, work, &bytes);
+  }
+
+  /*! \return The latency of a kernel in nanoseconds. */
+  double KernelTime(double bytes, double work) const {
+    return cfg_->launch_overhead + std::max(bytes / cfg_->bandwidth, work / cfg_->throughput);
+  }
+
+  /*! \return The time to move the bytes in nanoseconds. */
+  double TrafficTime(double bytes) const { return bytes / cfg_->bandwidth; }
+
+  /*! \return The time of the operations in nanoseconds. */
+  double ComputeTime(double work) const { return work / cfg_->throughput; }
+
+  const FuseOpsCostModelConfigNode* config() const { return cfg_; }
+
+ private:
+  const FuseOpsCostModelConfigNode* cfg_;
+};
+
 /*!
  * \brief Indexed data flow graph in forward direction.
  *  This is a temporary data structure used for operator fusion analysis.
@@ -507,8 +619,12 @@ DominatorTree DominatorTree::PostDom(support::Arena* arena, const IndexedForward
  */
 class GraphPartitioner {
  public:
-  explicit GraphPartitioner(support::Arena* arena, int opt_level, size_t max_fuse_depth)
-      : arena_(arena), opt_level_(opt_level), max_fuse_depth_(max_fuse_depth) {}
+  explicit GraphPartitioner(support::Arena* arena, int opt_level, size_t max_fuse_depth,
+                            const FuseOpsCostModelConfigNode* cost_model = nullptr)
+      : arena_(arena),
+        opt_level_(opt_level),
+        max_fuse_depth_(max_fuse_depth),
+        cost_model_(cost_model) {}
   /*!
    * \brief Group as a union find data structure.
    */
@@ -562,6 +678,20 @@ class GraphPartitioner {
   int opt_level_;
   /*! \brief The maximum number of operations in one fused function */
   size_t max_fuse_depth_;
+  /*! \brief The cost model deciding whether a fusion is profitable, nullptr to always fuse. */
+  FusionCostModel cost_model_;
+  /*! \brief The modeled size of each node, only set with a cost model. */
+  struct NodeCost {
+    /*! \brief Whether the size of the node is known. */
+    bool known{false};
+    /*! \brief The number of elements of the output. */
+    double numel{0};
+    /*! \brief The size of the output in bytes. */
+    double bytes{0};
+    /*! \brief The number of operations. */
+    double work{0};
+  };
+  std::vector<NodeCost> node_costs_;
   /*! \brief The internal groups. */
   std::vector<Group*> groups_;
   /*! \brief internal field used for deduplication */
@@ -656,6 +786,66 @@ class GraphPartitioner {
     CommitFuse_(src, sink, target);
   }
 
+  /*! \return The number of operations of the nodes in a group. */
+  double GroupWork(Group* group) {
+    double work = 0;
+    for (size_t nid = 0; nid < groups_.size(); ++nid) {
+      if (groups_[nid]->FindRoot() == group) work += node_costs_[nid].work;
+    }
+    return work;
+  }
+
+  // Internal implementation of FusionGain, returns false if a size is unknown.
+  bool FusionGain_(IndexedForwardGraph::Node* src, IndexedForwardGraph::Node* sink, Group* target,
+                   std::unordered_set<Group*>* merged, double* gain) {
+    if (src == sink || visited_.count(src)) return true;
+    visited_.insert(src);
+    const NodeCost& cost = node_costs_[src->index];
+    if (!cost.known) return false;
+    Group* group = groups_[src->index]->FindRoot();
+    if (group != target) merged->insert(group);
+    bool crossing = false;
+    for (auto link = src->outputs.head; link != nullptr; link = link->next) {
+      IndexedForwardGraph::Node* dst = link->value.node;
+      const NodeCost& dst_cost = node_costs_[dst->index];
+      if (!dst_cost.known) return false;
+      if (groups_[dst->index]->FindRoot() == group) continue;
+      // the output is no longer written by src and read by dst.
+      crossing = true;
+      *gain += cost_model_.TrafficTime(cost.bytes);
+      // a broadcast reads each element of src several times, which recomputes src.
+      OpPatternKind pattern = link->value.pattern;
+      if ((pattern == kBroadcast || pattern == kInjective) && dst_cost.numel > cost.numel &&
+          cost.numel > 0) {
+        *gain -= cost_model_.ComputeTime(GroupWork(group) * (dst_cost.numel / cost.numel - 1));
+      }
+    }
+    if (crossing) *gain += cost_model_.TrafficTime(cost.bytes);
+    // the injective ops fused into a reduction read their inputs with a strided pattern.
+    if (src->pattern == kInjective && target->pattern == kCommReduce) {
+      *gain -= cost_model_.TrafficTime(cost.bytes * cost_model_.config()->injective_penalty);
+    }
+    for (auto link = src->outputs.head; link != nullptr; link = link->next) {
+      if (!FusionGain_(link->value.node, sink, target, merged, gain)) return false;
+    }
+    return true;
+  }
+  /*!
+   * \brief Check with the cost model whether fusing src into its post-dominator sink
+   *  does not increase the modeled latency.
+   * \note Always true without a cost model, or when a size is unknown.
+   */
+  bool IsProfitable(IndexedForwardGraph::Node* src, IndexedForwardGraph::Node* sink) {
+    if (cost_model_.config() == nullptr) return true;
+    Group* target = groups_[sink->index]->FindRoot();
+    std::unordered_set<Group*> merged;
+    double gain = 0;
+    visited_.clear();
+    if (!FusionGain_(src, sink, target, &merged, &gain)) return true;
+    gain += cost_model_.config()->launch_overhead * merged.size();
+    return gain >= 0;
+  }
+
   size_t CountNodesUptoSink_(IndexedForwardGraph::Node* src, IndexedForwardGraph::Node* sink) {
     if (src == sink || visited_.count(src)) return 0;
     visited_.insert(src);
@@ -696,6 +886,18 @@ class GraphPartitioner {
       }
       groups_[nid] = group_node;
     }
+    if (cost_model_.config() == nullptr) return;
+    node_costs_.resize(graph.post_dfs_order.size());
+    for (size_t nid = 0; nid < node_costs_.size(); ++nid) {
+      const auto* expr = static_cast<const RelayExprNode*>(graph.post_dfs_order[nid]->ref);
+      NodeCost& cost = node_costs_[nid];
+      if (!expr->checked_type_.defined()) continue;
+      cost.known = FusionCostModel::TensorSize(expr->checked_type_, &cost.numel, &cost.bytes);
+      if (expr->IsInstance<CallNode>()) {
+        const auto* call = static_cast<const CallNode*>(expr);
+        cost.known = cost.known && FusionCostModel::Work(call, &cost.work);
+      }
+    }
   }
 
   // execute the fusion algorithm.
@@ -729,7 +931,8 @@ class GraphPartitioner {
           auto fcond = [](OpPatternKind kind, bool is_sink) { return kind <= kInjective; };
           // dom_root_group can also be tuple, as in inception layers
           // CheckPath is needed to avoid fusing two intermediate tuples
-          if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
+          if (CheckPath(graph_node, dom_node->parent->gnode, fcond) &&
+              IsProfitable(graph_node, dom_node->parent->gnode)) {
             CommitFuse(graph_node, dom_node->parent->gnode);
           }
         }
@@ -752,7 +955,8 @@ class GraphPartitioner {
           ICHECK(dom_node->parent->gnode != nullptr);
           // The fuse can be executed if all the intermediate ops are still broadcast.
           auto fcond = [](OpPatternKind kind, bool is_sink) { return kind <= kBroadcast; };
-          if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
+          if (CheckPath(graph_node, dom_node->parent->gnode, fcond) &&
+              IsProfitable(graph_node, dom_node->parent->gnode)) {
             CommitFuse(graph_node, dom_node->parent->gnode);
           }
         }
@@ -772,7 +976,8 @@ class GraphPartitioner {
                       kind == kOutEWiseFusable);
             }
           };
-          if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
+          if (CheckPath(graph_node, dom_node->parent->gnode, fcond) &&
+              IsProfitable(graph_node, dom_node->parent->gnode)) {
             CommitFuse(graph_node, dom_node->parent->gnode);
           }
         }
@@ -782,7 +987,8 @@ class GraphPartitioner {
         if (phase != 1) continue;
         // Check if all path are injective.
         auto fcond = [](OpPatternKind kind, bool is_sink) { return kind <= kInjective; };
-        if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
+        if (CheckPath(graph_node, dom_node->parent->gnode, fcond) &&
+            IsProfitable(graph_node, dom_node->parent->gnode)) {
           CommitFuse(graph_node, dom_node->parent->gnode);
         }
       } else {
@@ -809,10 +1015,12 @@ std::vector<GraphPartitioner::Group*> GraphPartitioner::Partition(
 class FuseMutator : private MixedModeMutator {
  public:
   // Run the transform
-  Expr Transform(const Expr& body, int fuse_opt_level, size_t max_fuse_depth) {
+  Expr Transform(const Expr& body, int fuse_opt_level, size_t max_fuse_depth,
+                 const FuseOpsCostModelConfigNode* cost_model) {
     // setup the group map.
     auto graph = IndexedForwardGraph::Create(&arena_, body);
-    auto groups = GraphPartitioner(&arena_, fuse_opt_level, max_fuse_depth).Partition(graph);
+    auto groups =
+        GraphPartitioner(&arena_, fuse_opt_level, max_fuse_depth, cost_model).Partition(graph);
     for (size_t nid = 0; nid < graph.post_dfs_order.size(); ++nid) {
       ICHECK(graph.post_dfs_order[nid]->ref != nullptr);
       gmap_[graph.post_dfs_order[nid]->ref] = groups[nid];
@@ -991,10 +1199,68 @@ class FuseMutator : private MixedModeMutator {
   }
 };
 
-Expr FuseOps(const Expr& expr, int fuse_opt_level, size_t max_fuse_depth, const IRModule& module) {
-  return FuseMutator().Transform(expr, fuse_opt_level, max_fuse_depth);
+Expr FuseOps(const Expr& expr, int fuse_opt_level, size_t max_fuse_depth,
+             const FuseOpsCostModelConfigNode* cost_model, const IRModule& module) {
+  return FuseMutator().Transform(expr, fuse_opt_level, max_fuse_depth, cost_model);
+}
+
+/*!
+ * \brief Sum the modeled latency of the primitive functions called by a fused program.
+ */
+class FusedLatencyEstimator : private ExprVisitor {
+ public:
+  explicit FusedLatencyEstimator(const FuseOpsCostModelConfigNode* cfg) : model_(cfg) {}
+
+  double Estimate(const Expr& expr) {
+    this->VisitExpr(expr);
+    return latency_;
+  }
+
+ private:
+  void VisitExpr_(const CallNode* call) final {
+    const auto* func = call->op.as<FunctionNode>();
+    if (func == nullptr || !func->HasNonzeroAttr(attr::kPrimitive)) {
+      ExprVisitor::VisitExpr_(call);
+      return;
+    }
+    double numel, bytes, traffic = 0, work = 0;
+    for (const Expr& arg : call->args) {
+      if (arg->checked_type_.defined() && FusionCostModel::TensorSize(arg->checked_type(), &numel,
+                                                                      &bytes)) {
+        traffic += bytes;
+      }
+    }
+    if (call->checked_type_.defined() &&
+        FusionCostModel::TensorSize(call->checked_type(), &numel, &bytes)) {
+      traffic += bytes;
+    }
+    PostOrderVisit(func->body, [&work](const Expr& e) {
+      double op_work;
+      if (const auto* op_call = e.as<CallNode>()) {
+        if (FusionCostModel::Work(op_call, &op_work)) work += op_work;
+      }
+    });
+    latency_ += model_.KernelTime(traffic, work);
+    for (const Expr& arg : call->args) {
+      this->VisitExpr(arg);
+    }
+  }
+
+  FusionCostModel model_;
+  double latency_{0};
+};
+
+double EstimateFusedLatency(const Expr& expr) {
+  auto cfg = transform::PassContext::Current()->GetConfig<FuseOpsCostModelConfig>(
+      "relay.FuseOps.cost_model");
+  if (!cfg.defined()) {
+    cfg = AttrsWithDefaultValues<FuseOpsCostModelConfig>();
+  }
+  return FusedLatencyEstimator(cfg.value().get()).Estimate(expr);
 }
 
+TVM_REGISTER_GLOBAL("relay.analysis.EstimateFusedLatency").set_body_typed(EstimateFusedLatency);
+
 namespace transform {
 
 Pass FuseOps(int fuse_opt_level) {
@@ -1002,7 +1268,9 @@ Pass FuseOps(int fuse_opt_level) {
       [=](Function f, IRModule m, PassContext pc) {
         int opt_level = fuse_opt_level == -1 ? pc->opt_level : fuse_opt_level;
         auto max_fuse_depth = pc->GetConfig("relay.FuseOps.max_depth", Integer(kMaxFusedOps));
-        return Downcast<Function>(FuseOps(f, opt_level, max_fuse_depth.value(), m));
+        auto cost_model = pc->GetConfig<FuseOpsCostModelConfig>("relay.FuseOps.cost_model");
+        const FuseOpsCostModelConfigNode* cfg = cost_model ? cost_model.value().get() : nullptr;
+        return Downcast<Function>(FuseOps(f, opt_level, max_fuse_depth.value(), cfg, m));
       };
   return CreateFunctionPass(pass_func, 1, "FuseOps", {"InferType"});
 }
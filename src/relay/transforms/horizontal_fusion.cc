@@ -0,0 +1,345 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ *
+ * \file horizontal_fusion.cc
+ * \brief Fuse independent ops of the same shape from different branches
+ * into a single batched op.
+ *
+ * Unlike the CombineParallel passes, the fused ops do not need to share an
+ * input. The calls at the same depth of the graph cannot depend on each other,
+ * and those with the same operator, attributes and argument types are batched
+ * by stacking their arguments along a new leading axis:
+ *
+ *      x0  y0    x1  y1              stack(x0, x1)  stack(y0, y1)
+ *       \  /      \  /                          \    /
+ *       add       add         ==>                add
+ *        |         |                              |
+ *       relu      relu                           relu
+ *                                                 |
+ *                                           split, squeeze
+ *
+ * A batched call whose arguments are the outputs of another batched call,
+ * in the same order, takes the batched output as it is, so chains of ops
+ * stay batched between one stack and one split. Elementwise and broadcast
+ * ops are batched as they are, dense becomes batch_matmul, and the batch
+ * axis of batch_matmul is merged into the stacked axis.
+ *
+ * This saves the kernel launches of models with many small independent ops,
+ * such as the per-head projections of attention.
+ */
+
+#include <tvm/relay/analysis.h>
+#include <tvm/relay/attrs/nn.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/op_attr_types.h>
+#include <tvm/relay/transform.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../op/make_op.h"
+#include "pattern_utils.h"
+
+namespace tvm {
+namespace relay {
+
+/*! \brief Check whether an expression is made of dataflow nodes only. */
+class DataflowChecker : public MixedModeVisitor {
+ public:
+  bool Check(const Expr& expr) {
+    VisitExpr(expr);
+    return dataflow_;
+  }
+
+  using MixedModeVisitor::VisitExpr_;
+
+  void VisitExpr_(const FunctionNode* op) final { dataflow_ = false; }
+  void VisitExpr_(const LetNode* op) final { dataflow_ = false; }
+  void VisitExpr_(const IfNode* op) final { dataflow_ = false; }
+  void VisitExpr_(const MatchNode* op) final { dataflow_ = false; }
+  void VisitExpr_(const RefCreateNode* op) final { dataflow_ = false; }
+  void VisitExpr_(const RefReadNode* op) final { dataflow_ = false; }
+  void VisitExpr_(const RefWriteNode* op) final { dataflow_ = false; }
+
+ private:
+  bool dataflow_{true};
+};
+
+class HorizontalFuser : private MixedModeMutator {
+ public:
+  explicit HorizontalFuser(uint64_t min_num_branches) : min_num_branches_(min_num_branches) {}
+
+  Expr Fuse(const Function& func) {
+    if (!DataflowChecker().Check(func->body)) return func;
+    FindGroups(func->body);
+    if (groups_.empty()) return func;
+    return Function(func->params, VisitExpr(func->body), func->ret_type, func->type_params,
+                    func->attrs, func->span);
+  }
+
+ private:
+  /*! \brief How a group of calls is batched. */
+  enum class BatchKind { kElemWise, kBroadcast, kDense, kBatchMatmul };
+
+  /*! \brief Independent calls batched into one. */
+  struct Group {
+    std::vector<const CallNode*> calls;
+    BatchKind kind;
+    /*! \brief The batched call, its output stacks the outputs of the calls. */
+    Expr batched;
+    /*! \brief The batched output split into the outputs of the calls. */
+    Expr split;
+  };
+
+  using MixedModeMutator::VisitExpr_;
+
+  /*! \brief Group the batchable calls at the same depth of the graph. */
+  void FindGroups(const Expr& body) {
+    std::unordered_map<const Object*, size_t> depth;
+    std::vector<std::vector<const CallNode*>> levels;
+    PostOrderVisit(body, [&](const Expr& expr) {
+      size_t d = 0;
+      auto input = [&](const Expr& arg) {
+        auto it = depth.find(arg.get());
+        if (it != depth.end()) d = std::max(d, it->second);
+      };
+      if (const auto* call = expr.as<CallNode>()) {
+        for (const Expr& arg : call->args) input(arg);
+        d += 1;
+        BatchKind kind;
+        if (Batchable(call, &kind)) {
+          if (levels.size() <= d) levels.resize(d + 1);
+          levels[d].push_back(call);
+        }
+      } else if (const auto* tuple = expr.as<TupleNode>()) {
+        for (const Expr& field : tuple->fields) input(field);
+      } else if (const auto* get = expr.as<TupleGetItemNode>()) {
+        input(get->tuple);
+      }
+      depth[expr.get()] = d;
+    });
+
+    for (const auto& level : levels) {
+      std::vector<std::vector<const CallNode*>> buckets;
+      std::unordered_map<const Object*, std::vector<size_t>> buckets_of_op;
+      for (const CallNode* call : level) {
+        auto& candidates = buckets_of_op[call->op.get()];
+        auto it = std::find_if(candidates.begin(), candidates.end(), [&](size_t i) {
+          return Compatible(buckets[i][0], call);
+        });
+        if (it != candidates.end()) {
+          buckets[*it].push_back(call);
+        } else {
+          candidates.push_back(buckets.size());
+          buckets.push_back({call});
+        }
+      }
+      for (auto& bucket : buckets) {
+        if (bucket.size() < min_num_branches_) continue;
+        Group group;
+        Batchable(bucket[0], &group.kind);
+        for (size_t i = 0; i < bucket.size(); ++i) {
+          members_[bucket[i]] = {groups_.size(), i};
+        }
+        group.calls = std::move(bucket);
+        groups_.push_back(std::move(group));
+      }
+    }
+  }
+
+  /*! \brief Check whether a call can be batched with others, and how. */
+  static bool Batchable(const CallNode* call, BatchKind* kind) {
+    static const Op& dense = Op::Get("nn.dense");
+    static const Op& batch_matmul = Op::Get("nn.batch_matmul");
+    static auto fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
+    const auto* op = call->op.as<OpNode>();
+    if (op == nullptr || !IsStaticTensor(call->checked_type_)) return false;
+    for (const Expr& arg : call->args) {
+      if (!IsStaticTensor(arg->checked_type_)) return false;
+    }
+    if (call->op == dense) {
+      const auto* attrs = call->attrs.as<DenseAttrs>();
+      const auto* data = call->args[0]->type_as<TensorTypeNode>();
+      if (data->shape.size() == 2 &&
+          (attrs->out_dtype.is_void() || attrs->out_dtype == data->dtype)) {
+        *kind = BatchKind::kDense;
+        return true;
+      }
+      return false;
+    }
+    if (call->op == batch_matmul) {
+      // the batch axes are merged, so neither operand may be broadcast along it.
+      const auto* attrs = call->attrs.as<BatchMatmulAttrs>();
+      const auto* x = call->args[0]->type_as<TensorTypeNode>();
+      const auto* y = call->args[1]->type_as<TensorTypeNode>();
+      if (attrs->auto_scheduler_rewritten_layout.size() != 0 ||
+          Downcast<Integer>(x->shape[0])->value != Downcast<Integer>(y->shape[0])->value) {
+        return false;
+      }
+      *kind = BatchKind::kBatchMatmul;
+      return true;
+    }
+    if (!fpattern.count(GetRef<Op>(op)) || fpattern[GetRef<Op>(op)] > kBroadcast) return false;
+    // the output of an op without tensor arguments is not stacked along the new axis.
+    if (call->args.empty()) return false;
+    // a new leading axis would shift the axes the attributes refer to, and the
+    // static output shapes in the attributes would not have it.
+    if (call->attrs.defined()) {
+      for (const auto& info : call->attrs->ListFieldInfo()) {
+        std::string name = info->name;
+        if (name.find("axis") != std::string::npos || name.find("axes") != std::string::npos ||
+            name.find("shape") != std::string::npos) {
+          return false;
+        }
+      }
+    }
+    *kind = fpattern[GetRef<Op>(op)] == kElemWise ? BatchKind::kElemWise : BatchKind::kBroadcast;
+    return true;
+  }
+
+  static bool IsStaticTensor(const Type& type) {
+    const auto* tensor = type.as<TensorTypeNode>();
+    if (tensor == nullptr) return false;
+    for (const PrimExpr& dim : tensor->shape) {
+      if (dim.as<IntImmNode>() == nullptr) return false;
+    }
+    return true;
+  }
+
+  static bool Compatible(const CallNode* a, const CallNode* b) {
+    if (!a->op.same_as(b->op) || a->args.size() != b->args.size()) return false;
+    StructuralEqual equal;
+    if (!equal(a->attrs, b->attrs) || !equal(a->checked_type_, b->checked_type_)) return false;
+    for (size_t i = 0; i < a->args.size(); ++i) {
+      if (!equal(a->args[i]->checked_type_, b->args[i]->checked_type_)) return false;
+    }
+    return true;
+  }
+
+  Expr Rewrite_(const CallNode* pre, const Expr& post) final {
+    auto it = members_.find(pre);
+    if (it == members_.end()) return post;
+    size_t gid = it->second.first;
+    if (!groups_[gid].batched.defined()) Batch(gid);
+    Expr slice = MakeSqueeze(TupleGetItem(groups_[gid].split, it->second.second), {Integer(0)});
+    slices_[slice.get()] = it->second;
+    return slice;
+  }
+
+  /*! \brief Create the batched call of a group. */
+  void Batch(size_t gid) {
+    Group& group = groups_[gid];
+    const CallNode* first = group.calls[0];
+    int64_t n = static_cast<int64_t>(group.calls.size());
+    Array<Expr> args;
+    for (size_t j = 0; j < first->args.size(); ++j) {
+      std::vector<Expr> column;
+      for (const CallNode* call : group.calls) {
+        column.push_back(VisitExpr(call->args[j]));
+      }
+      args.push_back(BatchArg(group, column, first->args[j]->type_as<TensorTypeNode>()));
+    }
+    const auto* out_type = first->type_as<TensorTypeNode>();
+    if (group.kind == BatchKind::kDense) {
+      group.batched = MakeBatchMatmul(args[0], args[1]);
+    } else if (group.kind == BatchKind::kBatchMatmul) {
+      Array<Integer> shape{Integer(n)};
+      for (const PrimExpr& dim : out_type->shape) shape.push_back(Downcast<Integer>(dim));
+      group.batched = MakeReshape(MakeBatchMatmul(args[0], args[1]), shape);
+    } else {
+      group.batched = Call(first->op, args, first->attrs, first->type_args, first->span);
+    }
+    group.split = MakeSplit(group.batched, Integer(n), 0);
+  }
+
+  /*! \brief Batch the arguments of the calls of a group at one position. */
+  Expr BatchArg(const Group& group, const std::vector<Expr>& column, const TensorTypeNode* type) {
+    int64_t n = static_cast<int64_t>(group.calls.size());
+    Expr batched = BatchedOutput(column);
+    if (!batched.defined()) {
+      bool shared = std::all_of(column.begin(), column.end(),
+                                [&column](const Expr& arg) { return arg.same_as(column[0]); });
+      // the shared argument of a broadcast is broadcast along the batch axis.
+      if (shared && group.kind == BatchKind::kBroadcast) return column[0];
+      batched = MakeStack(Tuple(column), 0);
+    }
+    int rank = static_cast<int>(type->shape.size());
+    if (group.kind == BatchKind::kBatchMatmul) {
+      // merge the batch axis of the calls into the stacked axis.
+      Array<Integer> shape{Integer(n * type->shape[0].as<IntImmNode>()->value)};
+      shape.push_back(Downcast<Integer>(type->shape[1]));
+      shape.push_back(Downcast<Integer>(type->shape[2]));
+      return MakeReshape(batched, shape);
+    }
+    if (group.kind == BatchKind::kElemWise || group.kind == BatchKind::kBroadcast) {
+      int out_rank = static_cast<int>(group.calls[0]->type_as<TensorTypeNode>()->shape.size());
+      // keep the lower rank arguments aligned to the trailing axes after the batch axis.
+      if (rank < out_rank) batched = MakeExpandDims(batched, 1, out_rank - rank);
+    }
+    return batched;
+  }
+
+  /*! \return The batched call whose outputs are the arguments in order, if any. */
+  Expr BatchedOutput(const std::vector<Expr>& column) {
+    auto first = slices_.find(column[0].get());
+    if (first == slices_.end()) return Expr();
+    size_t gid = first->second.first;
+    if (groups_[gid].calls.size() != column.size()) return Expr();
+    for (size_t i = 0; i < column.size(); ++i) {
+      auto it = slices_.find(column[i].get());
+      if (it == slices_.end() || it->second != std::make_pair(gid, i)) return Expr();
+    }
+    return groups_[gid].batched;
+  }
+
+  // the minimum number of calls in a group
+  uint64_t min_num_branches_;
+  // the groups of calls to batch
+  std::vector<Group> groups_;
+  // the group and the position in the group of the batched calls
+  std::unordered_map<const CallNode*, std::pair<size_t, size_t>> members_;
+  // the group and the position in the group of the outputs of the batched calls
+  std::unordered_map<const Object*, std::pair<size_t, size_t>> slices_;
+};
+
+Expr HorizontalFusion(const Function& func, uint64_t min_num_branches) {
+  return HorizontalFuser(min_num_branches).Fuse(func);
+}
+
+namespace transform {
+
+Pass HorizontalFusion(uint64_t min_num_branches) {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        return Downcast<Function>(HorizontalFusion(f, min_num_branches));
+      };
+  return CreateFunctionPass(pass_func, 4, "HorizontalFusion", {"InferType"});
+}
+
+TVM_REGISTER_GLOBAL("relay._transform.HorizontalFusion").set_body_typed(HorizontalFusion);
+
+}  // namespace transform
+
+}  // namespace relay
+}  // namespace tvm
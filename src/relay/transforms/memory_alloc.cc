@@ -37,10 +37,12 @@
 #include <cstdint>
 #include <cstdio>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include "../backend/compile_engine.h"
+#include "../backend/utils.h"
 #include "../op/memory/memory.h"
 #include "../op/vm/vm.h"
 #include "let_list.h"
@@ -99,10 +101,36 @@ bool IsReshapeOnly(const Expr& expr) {
   return check.reshape_only;
 }
 
+// Count the uses of each variable, the bindings are not counted.
+class VarUseCounter : public ExprVisitor {
+ public:
+  void VisitExpr(const Expr& expr) final {
+    if (const auto* var = expr.as<VarNode>()) {
+      ++use_count[var];
+    }
+    ExprVisitor::VisitExpr(expr);
+  }
+
+  void VisitExpr_(const LetNode* ln) final {
+    Expr body = GetRef<Let>(ln);
+    while (const auto* let = body.as<LetNode>()) {
+      this->VisitExpr(let->value);
+      body = let->body;
+    }
+    this->VisitExpr(body);
+  }
+
+  void VisitExpr_(const FunctionNode* fn) final { this->VisitExpr(fn->body); }
+
+  std::unordered_map<const VarNode*, int> use_count;
+};
+
 class DialectRewriter : public ExprMutator {
  public:
   DialectRewriter(const Target& target_host, const AnalysisResultMap& context_analysis_map)
-      : target_host_(target_host), context_analysis_map_(context_analysis_map) {}
+      : target_host_(target_host),
+        context_analysis_map_(context_analysis_map),
+        enable_inplace_(backend::IsInplaceEnabled()) {}
 
   // Get the device of an expression.
   Device GetDevice(const Expr& expr) const {
@@ -113,6 +141,11 @@ class DialectRewriter : public ExprMutator {
   }
 
   Function Rewrite(const Function& expr) {
+    if (enable_inplace_) {
+      VarUseCounter counter;
+      counter.VisitExpr(expr);
+      use_count_ = std::move(counter.use_count);
+    }
     auto ret = ExprMutator::Mutate(expr);
     return Downcast<Function>(ret);
   }
@@ -138,6 +171,9 @@ class DialectRewriter : public ExprMutator {
     Expr body;
     while (let) {
       auto new_value = ExprMutator::Mutate(let->value);
+      if (const auto* var = new_value.as<VarNode>()) {
+        if (fresh_outputs_.count(var)) fresh_outputs_.insert(let->var.get());
+      }
       scopes_.back().Push(let->var, new_value);
       body = let->body;
       let = body.as<LetNode>();
@@ -188,10 +224,15 @@ class DialectRewriter : public ExprMutator {
       } else {
         // Handle the static case
         Array<Expr> outs;
-        for (size_t i = 0; i < out_types.size(); ++i) {
-          Device dev = GetDevice(GetRef<Call>(cn));
-          auto out = MakeStaticAllocation(&scope, out_types[i], dev, std::to_string(i));
-          outs.push_back(out);
+        if (Optional<Var> input = FindInplaceInput(cn, out_types)) {
+          outs.push_back(input.value());
+        } else {
+          for (size_t i = 0; i < out_types.size(); ++i) {
+            Device dev = GetDevice(GetRef<Call>(cn));
+            auto out = MakeStaticAllocation(&scope, out_types[i], dev, std::to_string(i));
+            fresh_outputs_.insert(out.get());
+            outs.push_back(out);
+          }
         }
         Tuple output(outs);
         Expr invoke = InvokeTVMOp(cn->op, ins, output);
@@ -210,6 +251,24 @@ class DialectRewriter : public ExprMutator {
     return ExprMutator::Mutate(relay::DeviceCopy(inp, src_dev, dst_dev));
   }
 
+  // Find an input of an elementwise call which holds a tensor allocated for
+  // another call and is last used by the call, the output is written into it.
+  Optional<Var> FindInplaceInput(const CallNode* cn, const std::vector<TensorType>& out_types) {
+    if (!enable_inplace_ || out_types.size() != 1) return NullOpt;
+    Device dev = GetDevice(GetRef<Call>(cn));
+    for (size_t i : backend::GetInplaceParams(Downcast<Function>(cn->op))) {
+      const auto* var = cn->args[i].as<VarNode>();
+      if (var == nullptr || !fresh_outputs_.count(var) || use_count_[var] != 1) continue;
+      auto it = context_analysis_map_.find(cn->args[i]);
+      if (it == context_analysis_map_.end() || it->second.device_type != dev.device_type ||
+          it->second.device_id != dev.device_id) {
+        continue;
+      }
+      return GetRef<Var>(var);
+    }
+    return NullOpt;
+  }
+
   // Check if a call invokes a primitive function.
   bool IsPrimitive(const CallNode* call) const {
     if (const auto* fn = call->op.as<FunctionNode>()) {
@@ -409,6 +468,12 @@ class DialectRewriter : public ExprMutator {
 
   runtime::DataType compute_dtype_ = runtime::DataType::Int(64);
   Device default_device_{kDLCPU, 0};
+  // Whether to write the outputs of elementwise calls into their inputs.
+  bool enable_inplace_;
+  // The number of uses of each variable.
+  std::unordered_map<const VarNode*, int> use_count_;
+  // The variables holding a tensor allocated for the output of a call.
+  std::unordered_set<const VarNode*> fresh_outputs_;
 };
 
 namespace transform {
@@ -27,6 +27,7 @@
 
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/dataflow_matcher.h>
+#include <tvm/relay/dataflow_pattern_functor.h>
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/op_attr_types.h>
 #include <tvm/relay/transform.h>
@@ -43,13 +44,59 @@ Function InferType(const Function& expr, const IRModule& m) {
   return Downcast<Function>(mod->Lookup("main"));
 }
 
+/*!
+ * \brief Check whether a pattern only matches calls of the operators it names.
+ *
+ * Merging a pattern replaces the subgraphs it matches with calls of composite functions,
+ * which such a pattern cannot match. If it matches nothing before any pattern is merged,
+ * it matches nothing after either.
+ */
+class OpOnlyPatternChecker : public DFPatternVisitor {
+ public:
+  bool Check(const DFPattern& pattern) {
+    VisitDFPattern(pattern);
+    return op_only_;
+  }
+
+  void VisitDFPattern_(const CallPatternNode* op) final {
+    op_only_ = op_only_ && NamesOps(op->op);
+    DFPatternVisitor::VisitDFPattern_(op);
+  }
+
+  void VisitDFPattern_(const DominatorPatternNode* op) final { op_only_ = false; }
+
+  void VisitDFPattern_(const FunctionPatternNode* op) final { op_only_ = false; }
+
+ private:
+  static bool NamesOps(const DFPattern& callee) {
+    if (const auto* expr_pattern = callee.as<ExprPatternNode>()) {
+      return expr_pattern->expr.as<OpNode>() != nullptr;
+    }
+    if (const auto* alt = callee.as<AltPatternNode>()) {
+      return NamesOps(alt->left) && NamesOps(alt->right);
+    }
+    if (const auto* attr = callee.as<AttrPatternNode>()) {
+      return NamesOps(attr->pattern);
+    }
+    return false;
+  }
+
+  bool op_only_{true};
+};
+
 Expr MergeComposite(const Function& func, const Array<runtime::String>& pattern_names,
                     const Array<DFPattern>& patterns, const std::vector<PackedFunc>& checks,
                     const IRModule& m) {
   ICHECK_EQ(pattern_names.size(), patterns.size());
   Function merged_func = func;
+  // match all the patterns in one walk, to skip the partitioning and type inference
+  // of the patterns which cannot match
+  Array<Array<Expr>> matches = MatchPatterns(patterns, func);
   // merge the patterns one-by-one in order
   for (size_t i = 0; i < patterns.size(); i++) {
+    if (matches[i].empty() && OpOnlyPatternChecker().Check(patterns[i])) {
+      continue;
+    }
     Map<String, ObjectRef> attrs;
     attrs.Set("Composite", pattern_names[i]);
     merged_func = Downcast<Function>(PartitionPattern(patterns[i], merged_func, attrs, checks[i]));
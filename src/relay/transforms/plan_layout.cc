@@ -0,0 +1,498 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ *
+ * \file plan_layout.cc
+ * \brief Choose the data layouts of all the convolutions of a graph together.
+ *
+ * ConvertLayout converts every convolution to the one layout given by the
+ * user. The best layout of a convolution depends on its shape though, and a
+ * convolution whose layout differs from the one of its producer pays for a
+ * layout_transform in between. This pass weighs both with an analytic cost
+ * model and picks the layout of every nn.conv2d of a function at once.
+ *
+ * The candidate layouts of a convolution are NCHW, NHWC, and NCHW[x]c for the
+ * blocks x of the config which divide both its input and output channels.
+ * The elementwise, broadcast and pooling ops between two convolutions adapt
+ * to the layout of their input, so they carry the layout of the producer to
+ * the consumer. All the other tensors, such as the inputs of the function and
+ * the inputs of any other op, stay in the layout of the original graph.
+ *
+ * Following the first producer of each convolution, the convolutions form a
+ * forest, whose cheapest assignment is found exactly by dynamic programming
+ * from the leaves. The other producers, such as the shortcut of a residual
+ * add, are then accounted for by moving each convolution to its cheapest
+ * layout given its neighbours, until no convolution moves. The plan is
+ * applied with the layout rewriter of ConvertLayout.
+ */
+#include <tvm/relay/analysis.h>
+#include <tvm/relay/attrs/nn.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/op_attr_types.h>
+#include <tvm/relay/transform.h>
+#include <tvm/te/operation.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "pattern_utils.h"
+#include "transform_layout.h"
+
+namespace tvm {
+namespace relay {
+
+namespace plan_layout {
+
+/*! \brief The parameters of the cost model of PlanLayout. */
+struct PlanLayoutCostModelConfigNode : public tvm::AttrsNode<PlanLayoutCostModelConfigNode> {
+  Array<Integer> blocks;
+  int vector_bits;
+  int register_bits;
+  double bandwidth;
+  double throughput;
+  double launch_overhead;
+
+  TVM_DECLARE_ATTRS(PlanLayoutCostModelConfigNode, "relay.transform.PlanLayoutCostModelConfig") {
+    TVM_ATTR_FIELD(blocks)
+        .describe("The channel blocks x of the candidate NCHW[x]c layouts")
+        .set_default(Array<Integer>({4, 8, 16}));
+    TVM_ATTR_FIELD(vector_bits)
+        .describe("The width of the vector units of the device in bits")
+        .set_default(256);
+    TVM_ATTR_FIELD(register_bits)
+        .describe("The total width of the vector registers of the device in bits")
+        .set_default(4096);
+    TVM_ATTR_FIELD(bandwidth)
+        .describe("The memory bandwidth of the device in bytes per nanosecond")
+        .set_default(20.0);
+    TVM_ATTR_FIELD(throughput)
+        .describe("The throughput of the device in fully vectorized flops per nanosecond")
+        .set_default(100.0);
+    TVM_ATTR_FIELD(launch_overhead)
+        .describe("The overhead of launching a kernel in nanoseconds")
+        .set_default(1000.0);
+  }
+};
+
+class PlanLayoutCostModelConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(PlanLayoutCostModelConfig, Attrs,
+                                            PlanLayoutCostModelConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(PlanLayoutCostModelConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.PlanLayout.cost_model", PlanLayoutCostModelConfig);
+
+/*! \brief The static shape and the element size of a tensor. */
+struct TensorInfo {
+  std::vector<int64_t> shape;
+  int64_t numel{1};
+  int64_t bytes{0};
+};
+
+bool GetTensorInfo(const Type& type, TensorInfo* info) {
+  const auto* ttype = type.as<TensorTypeNode>();
+  if (ttype == nullptr) return false;
+  for (const auto& dim : ttype->shape) {
+    const auto* imm = dim.as<IntImmNode>();
+    if (imm == nullptr) return false;
+    info->shape.push_back(imm->value);
+    info->numel *= imm->value;
+  }
+  info->bytes = info->numel * ((ttype->dtype.bits() * ttype->dtype.lanes() + 7) / 8);
+  return true;
+}
+
+/*!
+ * \brief Whether an op adapts to the layout of its input, so it sits between
+ * two convolutions without a transform.
+ */
+bool IsLayoutAgnostic(const CallNode* call) {
+  static auto finfer_layout = Op::GetAttrMap<FInferCorrectLayout>("FInferCorrectLayout");
+  static auto fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
+  static const std::unordered_set<std::string> pools = {
+      "nn.max_pool2d", "nn.avg_pool2d", "nn.global_max_pool2d", "nn.global_avg_pool2d"};
+  const auto* op_node = call->op.as<OpNode>();
+  if (op_node == nullptr) return false;
+  Op op = GetRef<Op>(op_node);
+  if (!finfer_layout.count(op)) return false;
+  return pools.count(op_node->name) || fpattern.get(op, kOpaque) <= kBroadcast;
+}
+
+/*! \brief Plan the layouts of the convolutions of a function. */
+class LayoutPlanner {
+ public:
+  explicit LayoutPlanner(const PlanLayoutCostModelConfigNode* cfg) : cfg_(cfg) {}
+
+  /*!
+   * \brief Plan the layouts of the convolutions in a function body.
+   * \param body The body of the function.
+   * \return The planned data layout of each convolution whose layout changes.
+   */
+  std::unordered_map<const Object*, std::string> Plan(const Expr& body) {
+    CollectNodes(body);
+    if (nodes_.empty()) return {};
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+      CollectEdges(body, static_cast<int>(i));
+    }
+    SolveForest();
+    Refine();
+
+    std::unordered_map<const Object*, std::string> plan;
+    for (const auto& node : nodes_) {
+      const std::string& layout = node.candidates[node.choice];
+      if (layout != node.layout) plan[node.call] = layout;
+    }
+    return plan;
+  }
+
+ private:
+  /*! \brief A convolution of the plan. */
+  struct Node {
+    const CallNode* call;
+    /*! \brief The layout of the original graph. */
+    std::string layout;
+    /*! \brief The candidate layouts, the original one first. */
+    std::vector<std::string> candidates;
+    /*! \brief The cost of the convolution in each candidate layout. */
+    std::vector<double> op_costs;
+    /*! \brief The producer nodes and the bytes of the input they feed. */
+    std::vector<std::pair<int, int64_t>> producers;
+    /*! \brief The consumer nodes and the bytes of the input they feed. */
+    std::vector<std::pair<int, int64_t>> consumers;
+    /*! \brief The bytes of the inputs in the original layout. */
+    int64_t fixed_in_bytes{0};
+    /*! \brief The bytes of the outputs consumed in the original layout. */
+    int64_t fixed_out_bytes{0};
+    /*! \brief The children of the node in the forest of first producers. */
+    std::vector<int> children;
+    size_t choice{0};
+  };
+
+  void CollectNodes(const Expr& body) {
+    static const Op& conv2d = Op::Get("nn.conv2d");
+    PostOrderVisit(body, [this](const Expr& expr) {
+      if (const auto* call = expr.as<CallNode>()) {
+        for (const auto& arg : call->args) {
+          consumers_[arg.get()].push_back(call);
+        }
+        if (call->op == conv2d) AddNode(call);
+      } else if (const auto* tuple = expr.as<TupleNode>()) {
+        for (const auto& field : tuple->fields) {
+          consumers_[field.get()].push_back(tuple);
+        }
+      } else if (const auto* get = expr.as<TupleGetItemNode>()) {
+        consumers_[get->tuple.get()].push_back(get);
+      }
+    });
+  }
+
+  void AddNode(const CallNode* call) {
+    const auto* attrs = call->attrs.as<Conv2DAttrs>();
+    std::string layout = attrs->data_layout;
+    if (layout != "NCHW" && layout != "NHWC") return;
+    if (!attrs->out_layout.empty() && attrs->out_layout != attrs->data_layout) return;
+    TensorInfo data, weight, out;
+    if (!GetTensorInfo(call->args[0]->checked_type(), &data) ||
+        !GetTensorInfo(call->args[1]->checked_type(), &weight) ||
+        !GetTensorInfo(call->checked_type(), &out) || data.shape.size() != 4) {
+      return;
+    }
+
+    Layout data_layout(layout);
+    int64_t in_channels = data.shape[data_layout.IndexOf(LayoutAxis::Get('C'))];
+    int64_t out_channels = out.shape[data_layout.IndexOf(LayoutAxis::Get('C'))];
+    int64_t out_width = out.shape[data_layout.IndexOf(LayoutAxis::Get('W'))];
+
+    Node node;
+    node.call = call;
+    node.layout = layout;
+    node.candidates = {layout, layout == "NCHW" ? "NHWC" : "NCHW"};
+    if (attrs->groups == 1) {
+      for (const auto& block : cfg_->blocks) {
+        if (in_channels % block->value == 0 && out_channels % block->value == 0) {
+          node.candidates.push_back("NCHW" + std::to_string(block->value) + "c");
+        }
+      }
+    }
+
+    // Each output element takes one multiply-add per weight of its output channel.
+    double flops = 2.0 * out.numel * (weight.numel / out_channels);
+    int64_t bytes = data.bytes + weight.bytes + out.bytes;
+    int64_t elem_bits = 8 * out.bytes / std::max<int64_t>(1, out.numel);
+    int64_t lanes = std::max<int64_t>(1, cfg_->vector_bits / elem_bits);
+    for (const auto& candidate : node.candidates) {
+      // The innermost axis is vectorized, with the tail of the last vector
+      // wasted, and its accumulators spill once they outgrow the registers.
+      int64_t inner = candidate == "NCHW"   ? out_width
+                      : candidate == "NHWC" ? out_channels
+                                            : Layout(candidate).FactorOf(LayoutAxis::Get('c'));
+      double efficiency = static_cast<double>(inner) / (((inner + lanes - 1) / lanes) * lanes);
+      efficiency *= std::min(1.0, static_cast<double>(cfg_->register_bits) / (inner * elem_bits));
+      node.op_costs.push_back(std::max(flops / (cfg_->throughput * efficiency),
+                                       static_cast<double>(bytes) / cfg_->bandwidth));
+    }
+    index_[call] = static_cast<int>(nodes_.size());
+    nodes_.push_back(std::move(node));
+  }
+
+  /*! \brief Find the producers of a node and the outputs it sends to other ops. */
+  void CollectEdges(const Expr& body, int index) {
+    Node& node = nodes_[index];
+    TensorInfo data;
+    GetTensorInfo(node.call->args[0]->checked_type(), &data);
+
+    // A producer reached along several paths is visited, and thus an edge, once.
+    std::unordered_set<const ExprNode*> visited;
+    std::vector<const ExprNode*> stack = {node.call->args[0].get()};
+    while (!stack.empty()) {
+      const ExprNode* expr = stack.back();
+      stack.pop_back();
+      if (!visited.insert(expr).second) continue;
+      auto it = index_.find(expr);
+      const auto* call =
+          expr->IsInstance<CallNode>() ? static_cast<const CallNode*>(expr) : nullptr;
+      if (it != index_.end()) {
+        node.producers.emplace_back(it->second, data.bytes);
+        nodes_[it->second].consumers.emplace_back(index, data.bytes);
+      } else if (expr->IsInstance<ConstantNode>()) {
+        // Constants are transformed at compile time.
+      } else if (call && IsLayoutAgnostic(call)) {
+        for (const auto& arg : call->args) stack.push_back(arg.get());
+      } else {
+        node.fixed_in_bytes = data.bytes;
+      }
+    }
+    if (!node.producers.empty()) {
+      nodes_[node.producers[0].first].children.push_back(index);
+    }
+
+    // The outputs leave the plan at the first op that does not adapt to their layout.
+    visited.clear();
+    stack = {node.call};
+    while (!stack.empty()) {
+      const ExprNode* expr = stack.back();
+      stack.pop_back();
+      if (!visited.insert(expr).second) continue;
+      bool escapes = expr == body.get();
+      for (const ExprNode* consumer : consumers_[expr]) {
+        const auto* call =
+            consumer->IsInstance<CallNode>() ? static_cast<const CallNode*>(consumer) : nullptr;
+        if (call && index_.count(call) && call->args[0].get() == expr) continue;
+        if (call && IsLayoutAgnostic(call)) {
+          stack.push_back(call);
+        } else {
+          escapes = true;
+        }
+      }
+      TensorInfo info;
+      if (escapes && GetTensorInfo(expr->checked_type(), &info)) {
+        node.fixed_out_bytes += info.bytes;
+      }
+    }
+  }
+
+  /*! \brief The cost of transforming a tensor from one layout to another. */
+  double TransformCost(const std::string& src, const std::string& dst, int64_t bytes) const {
+    if (src == dst || bytes == 0) return 0;
+    return 2.0 * bytes / cfg_->bandwidth + cfg_->launch_overhead;
+  }
+
+  /*! \brief The cost of a node in a layout, with its edges to the original layout. */
+  double LocalCost(const Node& node, size_t choice) const {
+    const std::string& layout = node.candidates[choice];
+    return node.op_costs[choice] + TransformCost(node.layout, layout, node.fixed_in_bytes) +
+           TransformCost(layout, node.layout, node.fixed_out_bytes);
+  }
+
+  /*! \brief Solve the forest of first producers exactly, from the leaves up. */
+  void SolveForest() {
+    // The producers of a node are visited before it, so the children of a
+    // node all come after it.
+    std::vector<std::vector<double>> best(nodes_.size());
+    for (size_t i = nodes_.size(); i-- > 0;) {
+      const Node& node = nodes_[i];
+      for (size_t choice = 0; choice < node.candidates.size(); ++choice) {
+        double cost = LocalCost(node, choice);
+        for (int child : node.children) {
+          cost += BestChild(node.candidates[choice], child, best).second;
+        }
+        best[i].push_back(cost);
+      }
+    }
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+      Node& node = nodes_[i];
+      if (node.producers.empty()) {
+        node.choice = std::min_element(best[i].begin(), best[i].end()) - best[i].begin();
+      }
+      for (int child : node.children) {
+        nodes_[child].choice = BestChild(node.candidates[node.choice], child, best).first;
+      }
+    }
+  }
+
+  /*! \return The best layout of a child given the layout of its parent, and its cost. */
+  std::pair<size_t, double> BestChild(const std::string& layout, int child,
+                                      const std::vector<std::vector<double>>& best) const {
+    const Node& node = nodes_[child];
+    int64_t bytes = node.producers[0].second;
+    std::pair<size_t, double> result = {0, std::numeric_limits<double>::infinity()};
+    for (size_t choice = 0; choice < node.candidates.size(); ++choice) {
+      double cost = TransformCost(layout, node.candidates[choice], bytes) + best[child][choice];
+      if (cost < result.second) result = {choice, cost};
+    }
+    return result;
+  }
+
+  /*! \brief Move each node to its cheapest layout given all its neighbours. */
+  void Refine() {
+    // Each move lowers the total cost, so the loop terminates.
+    bool moved = true;
+    while (moved) {
+      moved = false;
+      for (Node& node : nodes_) {
+        std::vector<double> costs;
+        for (size_t choice = 0; choice < node.candidates.size(); ++choice) {
+          const std::string& layout = node.candidates[choice];
+          double cost = LocalCost(node, choice);
+          for (const auto& producer : node.producers) {
+            cost += TransformCost(Chosen(producer.first), layout, producer.second);
+          }
+          for (const auto& consumer : node.consumers) {
+            cost += TransformCost(layout, Chosen(consumer.first), consumer.second);
+          }
+          costs.push_back(cost);
+        }
+        size_t choice = std::min_element(costs.begin(), costs.end()) - costs.begin();
+        if (costs[choice] < costs[node.choice]) {
+          node.choice = choice;
+          moved = true;
+        }
+      }
+    }
+  }
+
+  const std::string& Chosen(int index) const {
+    return nodes_[index].candidates[nodes_[index].choice];
+  }
+
+  const PlanLayoutCostModelConfigNode* cfg_;
+  std::vector<Node> nodes_;
+  std::unordered_map<const ExprNode*, int> index_;
+  std::unordered_map<const ExprNode*, std::vector<const ExprNode*>> consumers_;
+};
+
+/*!
+ * \brief Container for the planned layouts of PlanLayout.
+ */
+class PlanTransformMemorizerNode : public TransformMemorizerNode {
+ public:
+  explicit PlanTransformMemorizerNode(std::unordered_map<const Object*, std::string> plan)
+      : plan_(std::move(plan)) {}
+
+  /*! \brief The planned data layout of each convolution whose layout changes. */
+  std::unordered_map<const Object*, std::string> plan_;
+};
+
+/*!
+ * \brief Container that provides the transformation function for PlanLayout.
+ */
+class PlanTransformMemorizer : public TransformMemorizer {
+ public:
+  PlanTransformMemorizer() {}
+  explicit PlanTransformMemorizer(ObjectPtr<Object> n) : TransformMemorizer(n) {}
+
+  PlanTransformMemorizerNode* operator->() {
+    return static_cast<PlanTransformMemorizerNode*>(get_mutable());
+  }
+
+  /*!
+   * \brief Convert a planned call to its planned layout, with the default
+   * kernel layout of that data layout.
+   * \param ref_call The original call.
+   * \param new_args The traversed/recursed args to the call.
+   * \return The new Call.
+   */
+  Call CallWithNewLayouts(const Call& ref_call, const std::vector<Expr>& new_args) override {
+    static auto fconvert_layout = Op::GetAttrMap<FTVMConvertOpLayout>("FTVMConvertOpLayout");
+    const auto& plan = operator->()->plan_;
+    auto it = plan.find(ref_call.get());
+    if (it == plan.end()) {
+      return Call(ref_call->op, new_args, ref_call->attrs);
+    }
+
+    tvm::Array<tvm::te::Tensor> tinfos;
+    for (auto expr : ref_call->args) {
+      auto ttype = expr->type_as<TensorTypeNode>();
+      tinfos.push_back(tvm::te::placeholder(ttype->shape, ttype->dtype));
+    }
+    Op op = Downcast<Op>(ref_call->op);
+    Expr new_e = fconvert_layout[op](ref_call->attrs, new_args, tinfos,
+                                     Array<String>{String(it->second), "default"});
+    const CallNode* new_call = new_e.as<CallNode>();
+    ICHECK(new_call) << "Can only replace the original operator with another call node";
+    return GetRef<Call>(new_call);
+  }
+
+  using ContainerType = PlanTransformMemorizerNode;
+};
+
+Expr PlanLayout(const Expr& expr) {
+  auto cfg = transform::PassContext::Current()->GetConfig<PlanLayoutCostModelConfig>(
+      "relay.PlanLayout.cost_model");
+  if (!cfg.defined()) {
+    cfg = AttrsWithDefaultValues<PlanLayoutCostModelConfig>();
+  }
+  const auto* func = expr.as<FunctionNode>();
+  ICHECK(func) << "PlanLayout expects a function";
+  auto plan = LayoutPlanner(cfg.value().get()).Plan(func->body);
+  if (plan.empty()) return expr;
+
+  PlanTransformMemorizer transformMemorizer(
+      make_object<PlanTransformMemorizerNode>(std::move(plan)));
+  auto fcontext = [&](const Call& call) -> ObjectRef { return transformMemorizer; };
+
+  return ForwardRewrite(expr, LayoutRewriter<PlanTransformMemorizer>, fcontext);
+}
+
+}  // namespace plan_layout
+
+namespace transform {
+
+Pass PlanLayout() {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        return Downcast<Function>(relay::plan_layout::PlanLayout(f));
+      };
+  return CreateFunctionPass(pass_func, 3, "PlanLayout", {"InferType", "CanonicalizeOps"});
+}
+
+TVM_REGISTER_GLOBAL("relay._transform.PlanLayout").set_body_typed(PlanLayout);
+
+}  // namespace transform
+
+}  // namespace relay
+}  // namespace tvm
@@ -0,0 +1,352 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ *
+ * \file rematerialize.cc
+ * \brief Recompute cheap activations instead of keeping them alive, until the
+ * memory planned for a function fits a budget.
+ *
+ * The gradient passes keep every forward activation alive until it is read
+ * by the backward computation. An activation computed by a cheap op can
+ * instead be computed again right before its backward uses, from inputs
+ * which are alive at that point anyway:
+ *
+ *      a = relu(x)                      a = relu(x)
+ *      b = f(a)                         b = f(a)
+ *      ...                 ==>          ...
+ *      g = h(a, ...)                    a' = relu(x)
+ *                                       g = h(a', ...)
+ *
+ * The pass works on the dataflow graph, executed in post DFS order as by the
+ * graph executor. It repeatedly finds the point where most bytes are alive,
+ * and recomputes the activation alive across that point which saves the most
+ * bytes for the cost of recomputing it. Each rewrite is kept only if it
+ * lowers the storage planned by GraphPlanMemory, and the pass stops once
+ * that storage fits the budget. The storage is planned before fusion, so
+ * it bounds the storage of the fused function from above.
+ */
+#include <tvm/relay/analysis.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/feature.h>
+#include <tvm/relay/op_attr_types.h>
+#include <tvm/relay/transform.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../backend/utils.h"
+#include "pass_utils.h"
+
+namespace tvm {
+namespace relay {
+
+/*! \brief The uses of an arg of a call to be replaced by a recomputation. */
+using Replacements = std::unordered_map<const CallNode*, std::unordered_set<size_t>>;
+
+/*!
+ * \brief Rebuild a function in graph normal form, with checked types, and
+ *  replace the given args by recomputations of the calls they refer to.
+ */
+class RematerializeMutator : public ExprMutator {
+ public:
+  explicit RematerializeMutator(const Replacements& replacements) : replacements_(replacements) {}
+
+  Function Rebuild(const Function& func) {
+    Function ret(func->params, VisitExpr(func->body), func->ret_type, func->type_params,
+                 func->attrs, func->span);
+    ret->checked_type_ = func->checked_type_;
+    return ret;
+  }
+
+  Expr VisitExpr(const Expr& expr) final {
+    Expr ret = ExprMutator::VisitExpr(expr);
+    if (!ret->checked_type_.defined()) {
+      ret->checked_type_ = expr->checked_type_;
+    }
+    return ret;
+  }
+
+  Expr VisitExpr_(const VarNode* op) final {
+    auto it = values_.find(op);
+    return it != values_.end() ? it->second : GetRef<Expr>(op);
+  }
+
+  Expr VisitExpr_(const LetNode* op) final {
+    values_[op->var.get()] = VisitExpr(op->value);
+    return VisitExpr(op->body);
+  }
+
+  Expr VisitExpr_(const CallNode* op) final {
+    auto it = replacements_.find(op);
+    bool unchanged = true;
+    Array<Expr> args;
+    for (size_t i = 0; i < op->args.size(); ++i) {
+      Expr arg = it != replacements_.end() && it->second.count(i)
+                     ? Recompute(op->args[i].as<CallNode>())
+                     : VisitExpr(op->args[i]);
+      unchanged &= arg.same_as(op->args[i]);
+      args.push_back(arg);
+    }
+    if (unchanged) return GetRef<Expr>(op);
+    return Call(op->op, args, op->attrs, op->type_args, op->span);
+  }
+
+ private:
+  // A second call computing the same value as the given call, after its uses
+  // which are not replaced.
+  Expr Recompute(const CallNode* call) {
+    ICHECK(call != nullptr);
+    auto it = recomputed_.find(call);
+    if (it != recomputed_.end()) return it->second;
+    Array<Expr> args;
+    for (const auto& arg : call->args) {
+      args.push_back(VisitExpr(arg));
+    }
+    Call ret(call->op, args, call->attrs, call->type_args, call->span);
+    ret->checked_type_ = call->checked_type_;
+    recomputed_[call] = ret;
+    return std::move(ret);
+  }
+
+  const Replacements& replacements_;
+  // the values of the let bound variables
+  std::unordered_map<const VarNode*, Expr> values_;
+  // the recomputation of each call, shared by all its replaced uses
+  std::unordered_map<const CallNode*, Expr> recomputed_;
+};
+
+/*!
+ * \brief The liveness of the values of a function in graph normal form, when
+ *  executed in post DFS order.
+ */
+class LivenessAnalysis {
+ public:
+  explicit LivenessAnalysis(const Function& func) {
+    PostOrderVisit(func->body, [this](const Expr& expr) {
+      position_[expr.get()] = order_.size();
+      order_.push_back(expr);
+    });
+    size_t end = order_.size();
+    last_use_[func->body.get()] = end;
+    // The consumers come after their inputs, and the uses through a tuple or
+    // a projection last as long as the uses of the tuple or the projection.
+    for (size_t i = end; i-- > 0;) {
+      const Expr& node = order_[i];
+      size_t use = node.as<TupleNode>() || node.as<TupleGetItemNode>() ? LastUse(node.get()) : i;
+      auto use_arg = [&](const Expr& arg) {
+        size_t& last = last_use_[arg.get()];
+        last = std::max(last, use);
+      };
+      if (const auto* call = node.as<CallNode>()) {
+        for (size_t j = 0; j < call->args.size(); ++j) {
+          use_arg(call->args[j]);
+          consumers_[call->args[j].get()].emplace_back(call, j);
+        }
+      } else if (const auto* tuple = node.as<TupleNode>()) {
+        for (const auto& field : tuple->fields) {
+          use_arg(field);
+          aliased_.insert(field.get());
+        }
+      } else if (const auto* proj = node.as<TupleGetItemNode>()) {
+        use_arg(proj->tuple);
+        aliased_.insert(proj->tuple.get());
+      }
+    }
+    aliased_.insert(func->body.get());
+  }
+
+  /*!
+   * \brief Find the position where the outputs of the calls alive take the
+   *  most bytes. The parameters and constants are alive everywhere.
+   */
+  size_t PeakPosition() const {
+    std::vector<int64_t> delta(order_.size() + 2, 0);
+    for (size_t i = 0; i < order_.size(); ++i) {
+      const auto* call = order_[i].as<CallNode>();
+      if (call == nullptr) continue;
+      int64_t bytes = Bytes(call);
+      delta[i] += bytes;
+      delta[LastUse(call) + 1] -= bytes;
+    }
+    size_t peak = 0;
+    int64_t alive = 0, most = -1;
+    for (size_t i = 0; i < order_.size(); ++i) {
+      alive += delta[i];
+      if (alive > most) {
+        most = alive;
+        peak = i;
+      }
+    }
+    return peak;
+  }
+
+  /*!
+   * \brief Choose the call to recompute for the uses after the peak, which
+   *  saves the most bytes at the peak per element recomputed.
+   * \param rejected The calls which are not to be recomputed.
+   * \return The call and its uses to replace, or an empty map.
+   */
+  Replacements Choose(const std::unordered_set<const CallNode*>& rejected) const {
+    static auto fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
+    static auto fstateful = Op::GetAttrMap<TOpIsStateful>("TOpIsStateful");
+    size_t peak = PeakPosition();
+    const CallNode* best = nullptr;
+    double best_score = 0;
+    for (size_t i = 0; i < peak; ++i) {
+      const auto* call = order_[i].as<CallNode>();
+      if (call == nullptr || rejected.count(call) || aliased_.count(call)) continue;
+      if (LastUse(call) <= peak) continue;
+      const auto* op = call->op.as<OpNode>();
+      if (op == nullptr || !call->checked_type()->IsInstance<TensorTypeNode>()) continue;
+      Op callee = GetRef<Op>(op);
+      if (!fpattern.count(callee) || fpattern[callee] > kInjective) continue;
+      if (fstateful.get(callee, false)) continue;
+      // The args of the recomputation stay alive until it runs.
+      int64_t saved = Bytes(call);
+      int64_t cost = Elements(call->checked_type());
+      bool recomputable = true;
+      for (const auto& arg : call->args) {
+        cost += Elements(arg->checked_type());
+        if (arg.as<VarNode>() || arg.as<ConstantNode>()) continue;
+        if (arg.as<CallNode>() == nullptr) {
+          recomputable = false;
+        } else if (LastUse(arg.get()) < peak) {
+          saved -= Bytes(arg.as<CallNode>());
+        }
+      }
+      if (!recomputable || saved <= 0) continue;
+      double score = static_cast<double>(saved) / std::max<int64_t>(cost, 1);
+      if (score > best_score) {
+        best = call;
+        best_score = score;
+      }
+    }
+    Replacements ret;
+    if (best != nullptr) {
+      for (const auto& use : consumers_.at(best)) {
+        if (position_.at(use.first) > peak) {
+          ret[use.first].insert(use.second);
+        }
+      }
+    }
+    return ret;
+  }
+
+ private:
+  size_t LastUse(const Object* node) const {
+    auto it = last_use_.find(node);
+    return it != last_use_.end() ? it->second : position_.at(node);
+  }
+
+  static int64_t Elements(const Type& type) {
+    int64_t elements = 0;
+    if (const auto* tuple_type = type.as<TupleTypeNode>()) {
+      for (const auto& field : tuple_type->fields) {
+        elements += Elements(field);
+      }
+    } else if (const auto* tensor_type = type.as<TensorTypeNode>()) {
+      elements = 1;
+      for (const auto& dim : tensor_type->shape) {
+        const auto* imm = dim.as<IntImmNode>();
+        elements *= imm != nullptr ? imm->value : 1;
+      }
+    }
+    return elements;
+  }
+
+  static int64_t Bytes(const Type& type) {
+    int64_t bytes = 0;
+    if (const auto* tuple_type = type.as<TupleTypeNode>()) {
+      for (const auto& field : tuple_type->fields) {
+        bytes += Bytes(field);
+      }
+    } else if (const auto* tensor_type = type.as<TensorTypeNode>()) {
+      bytes = Elements(type) * ((tensor_type->dtype.bits() * tensor_type->dtype.lanes() + 7) / 8);
+    }
+    return bytes;
+  }
+
+  static int64_t Bytes(const CallNode* call) { return Bytes(call->checked_type()); }
+
+  // the nodes in execution order
+  std::vector<Expr> order_;
+  // the position of each node in the execution order
+  std::unordered_map<const Object*, size_t> position_;
+  // the position of the last use of each node
+  std::unordered_map<const Object*, size_t> last_use_;
+  // the calls using each node, and the index of the node in their args
+  std::unordered_map<const Object*, std::vector<std::pair<const CallNode*, size_t>>> consumers_;
+  // the nodes in a tuple, projected from or returned by the function
+  std::unordered_set<const Object*> aliased_;
+};
+
+Function Rematerialize(const Function& func, int64_t memory_budget) {
+  if (memory_budget <= 0) return func;
+  FeatureSet supported({fVar, fConstant, fTuple, fTupleGetItem, fOp, fCall, fLet, fGraph});
+  if (!DetectFeature(func->body).is_subset_of(supported)) return func;
+  bool dynamic = false;
+  PostOrderVisit(func->body, [&dynamic](const Expr& expr) {
+    dynamic |= expr->checked_type_.defined() && IsDynamic(expr->checked_type());
+  });
+  if (dynamic) return func;
+
+  Function ret = RematerializeMutator({}).Rebuild(func);
+  int64_t bytes = backend::GraphPlanMemoryBytes(ret);
+  std::unordered_set<const CallNode*> rejected;
+  while (bytes > memory_budget) {
+    Replacements replacements = LivenessAnalysis(ret).Choose(rejected);
+    if (replacements.empty()) break;
+    Function candidate = RematerializeMutator(replacements).Rebuild(ret);
+    int64_t candidate_bytes = backend::GraphPlanMemoryBytes(candidate);
+    if (candidate_bytes < bytes) {
+      ret = candidate;
+      bytes = candidate_bytes;
+    } else {
+      // The recomputed call is the same arg of every replaced use.
+      const auto& use = *replacements.begin();
+      rejected.insert(use.first->args[*use.second.begin()].as<CallNode>());
+    }
+  }
+  if (bytes > memory_budget) {
+    LOG(WARNING) << "Rematerialize: " << bytes << " bytes are planned, above the budget of "
+                 << memory_budget << " bytes";
+  }
+  return ret;
+}
+
+namespace transform {
+
+Pass Rematerialize(Integer memory_budget) {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        return Rematerialize(f, memory_budget->value);
+      };
+  return CreateFunctionPass(pass_func, 0, "Rematerialize", {"InferType"});
+}
+
+TVM_REGISTER_GLOBAL("relay._transform.Rematerialize").set_body_typed(Rematerialize);
+
+}  // namespace transform
+
+}  // namespace relay
+}  // namespace tvm
@@ -0,0 +1,363 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relay/transforms/simplify_data_movement.cc
+ * \brief A pass for canonicalizing the ops which only move data.
+ *
+ * ConvertLayout, AlterOpLayout and graph partitioning leave chains of layout
+ * transforms, transposes, reshapes and device copies, which only move the
+ * same data around. Over the whole graph, the pass
+ *
+ *  - removes the moves which leave their input as it is,
+ *  - cancels a layout transform, a transpose or a device copy followed by
+ *    its inverse,
+ *  - merges two layout transforms, two transposes, two reshapes or two
+ *    device copies in a row into one.
+ *
+ * The bytes written by the moves of a function are given by
+ * relay.analysis.data_movement_bytes.
+ */
+
+#include <tvm/relay/analysis.h>
+#include <tvm/relay/attrs/device_copy.h>
+#include <tvm/relay/attrs/transform.h>
+#include <tvm/relay/dataflow_matcher.h>
+#include <tvm/relay/expr.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/transform.h>
+#include <tvm/tir/data_layout.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../op/make_op.h"
+#include "../op/memory/memory.h"
+#include "simplify_expr.h"
+
+namespace tvm {
+namespace relay {
+
+/*! \brief The ops which produce the data of their input with another shape. */
+static const std::vector<std::string> kReshapeOps = {
+    "reshape", "contrib_reverse_reshape", "squeeze", "expand_dims", "nn.batch_flatten"};
+
+/*! \brief Get a static shape, or an empty array if it is dynamic. */
+static Array<Integer> StaticShape(const Array<PrimExpr>& dims) {
+  Array<Integer> shape;
+  for (const auto& dim : dims) {
+    const auto* imm = dim.as<IntImmNode>();
+    if (imm == nullptr) return Array<Integer>();
+    shape.push_back(Integer(imm->value));
+  }
+  return shape;
+}
+
+/*! \brief Get the static shape of a tensor type, or an empty array if it is not static. */
+static Array<Integer> StaticShape(const Type& type) {
+  const auto* tensor_type = type.as<TensorTypeNode>();
+  return tensor_type != nullptr ? StaticShape(tensor_type->shape) : Array<Integer>();
+}
+
+static bool SameShape(const Array<Integer>& lhs, const Array<Integer>& rhs) {
+  if (lhs.size() != rhs.size()) return false;
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    if (lhs[i]->value != rhs[i]->value) return false;
+  }
+  return true;
+}
+
+/*!
+ * \brief Get the axes of the input read by each axis of the output of a
+ *  transpose, or of a layout transform between layouts without split axes.
+ * \return Whether the call is such a permutation of ndim axes.
+ */
+static bool GetPermutation(const Call& call, size_t ndim, std::vector<int>* axes) {
+  axes->clear();
+  if (const auto* attrs = call->attrs.as<TransposeAttrs>()) {
+    if (!attrs->axes.defined() || attrs->axes.empty()) {
+      for (size_t i = ndim; i-- > 0;) {
+        axes->push_back(static_cast<int>(i));
+      }
+      return true;
+    }
+    if (attrs->axes.size() != ndim) return false;
+    for (const auto& axis : attrs->axes) {
+      int64_t value = axis->value;
+      axes->push_back(static_cast<int>(value < 0 ? value + ndim : value));
+    }
+    return true;
+  }
+  if (const auto* attrs = call->attrs.as<LayoutTransformAttrs>()) {
+    Layout src(attrs->src_layout);
+    Layout dst(attrs->dst_layout);
+    if (src.ndim() != ndim || dst.ndim() != ndim || src.ndim_primal() != ndim ||
+        dst.ndim_primal() != ndim) {
+      return false;
+    }
+    for (size_t i = 0; i < ndim; ++i) {
+      int axis = src.IndexOf(dst[i]);
+      if (axis < 0) return false;
+      axes->push_back(axis);
+    }
+    return true;
+  }
+  return false;
+}
+
+/*!
+ * \brief EliminateIdentityMove removes a layout transform, transpose, reshape or device copy
+ *   whose output is its input.
+ */
+class EliminateIdentityMove : public DFPatternRewrite {
+ public:
+  EliminateIdentityMove() {
+    x_ = IsWildcard();
+    DFPattern move = IsOp("layout_transform") || IsOp("transpose") || IsOp("device_copy");
+    for (const auto& name : kReshapeOps) {
+      move = move || IsOp(name);
+    }
+    pattern_ = move({x_});
+  }
+
+  Expr Callback(const Expr& pre, const Expr& post,
+                const Map<DFPattern, Array<Expr>>& node_map) const override {
+    const auto* call = pre.as<CallNode>();
+    Array<Integer> out_shape = StaticShape(pre->checked_type());
+    Array<Integer> in_shape = StaticShape(call->args[0]->checked_type());
+    if (out_shape.empty() || !SameShape(out_shape, in_shape)) return post;
+    if (const auto* attrs = call->attrs.as<LayoutTransformAttrs>()) {
+      if (attrs->src_layout != attrs->dst_layout) return post;
+    } else if (const auto* attrs = call->attrs.as<DeviceCopyAttrs>()) {
+      if (attrs->src_dev_type != attrs->dst_dev_type) return post;
+    } else if (call->attrs.as<TransposeAttrs>()) {
+      std::vector<int> axes;
+      if (!GetPermutation(GetRef<Call>(call), out_shape.size(), &axes)) return post;
+      for (size_t i = 0; i < axes.size(); ++i) {
+        if (axes[i] != static_cast<int>(i)) return post;
+      }
+    }
+    return node_map[x_][0];
+  }
+
+ private:
+  /*! \brief Pattern input */
+  DFPattern x_;
+};
+
+/*!
+ * \brief MergeLayoutTransforms cancels two consecutive layout transforms which are the inverse
+ *   of each other, and merges the others into one layout transform, split axes included.
+ */
+class MergeLayoutTransforms : public DFPatternRewrite {
+ public:
+  MergeLayoutTransforms() {
+    x_ = IsWildcard();
+    pattern_ = IsOp("layout_transform")({IsOp("layout_transform")({x_})});
+  }
+
+  Expr Callback(const Expr& pre, const Expr& post,
+                const Map<DFPattern, Array<Expr>>& node_map) const override {
+    auto outer = Downcast<Call>(pre);
+    auto inner = Downcast<Call>(outer->args[0]);
+    const auto* outer_attrs = outer->attrs.as<LayoutTransformAttrs>();
+    const auto* inner_attrs = inner->attrs.as<LayoutTransformAttrs>();
+    // The outer transform must read the layout the inner one writes.
+    if (inner_attrs->dst_layout != outer_attrs->src_layout) return post;
+    Array<Integer> out_shape = StaticShape(pre->checked_type());
+    Array<Integer> in_shape = StaticShape(inner->args[0]->checked_type());
+    if (out_shape.empty() || in_shape.empty()) return post;
+    auto x = node_map[x_][0];
+    if (inner_attrs->src_layout == outer_attrs->dst_layout) {
+      return SameShape(out_shape, in_shape) ? x : post;
+    }
+    tir::BijectiveLayout layout(Layout(inner_attrs->src_layout), Layout(outer_attrs->dst_layout));
+    if (!layout.defined()) return post;
+    // A split axis padded by the first transform cannot be merged.
+    Array<PrimExpr> dims(in_shape.begin(), in_shape.end());
+    if (!SameShape(StaticShape(layout.ForwardShape(dims)), out_shape)) return post;
+    return MakeLayoutTransform(x, inner_attrs->src_layout, outer_attrs->dst_layout);
+  }
+
+ private:
+  /*! \brief Pattern input */
+  DFPattern x_;
+};
+
+/*!
+ * \brief MergeTransposes merges two consecutive transposes, or a transpose and a layout transform
+ *   without split axes, into one transpose, or cancels them.
+ */
+class MergeTransposes : public DFPatternRewrite {
+ public:
+  MergeTransposes() {
+    x_ = IsWildcard();
+    auto trans1 = IsOp("transpose") || IsOp("layout_transform");
+    auto trans2 = IsOp("transpose") || IsOp("layout_transform");
+    pattern_ = trans1({trans2({x_})});
+  }
+
+  Expr Callback(const Expr& pre, const Expr& post,
+                const Map<DFPattern, Array<Expr>>& node_map) const override {
+    auto outer = Downcast<Call>(pre);
+    auto inner = Downcast<Call>(outer->args[0]);
+    // Two layout transforms are left to MergeLayoutTransforms.
+    if (outer->attrs.as<LayoutTransformAttrs>() && inner->attrs.as<LayoutTransformAttrs>()) {
+      return post;
+    }
+    const auto* out_type = pre->checked_type().as<TensorTypeNode>();
+    if (out_type == nullptr) return post;
+    size_t ndim = out_type->shape.size();
+    std::vector<int> outer_axes, inner_axes;
+    if (!GetPermutation(outer, ndim, &outer_axes) || !GetPermutation(inner, ndim, &inner_axes)) {
+      return post;
+    }
+    Array<Integer> axes;
+    bool identity = true;
+    for (size_t i = 0; i < ndim; ++i) {
+      int axis = inner_axes[outer_axes[i]];
+      identity &= axis == static_cast<int>(i);
+      axes.push_back(axis);
+    }
+    auto x = node_map[x_][0];
+    return identity ? x : MakeTranspose(x, axes);
+  }
+
+ private:
+  /*! \brief Pattern input */
+  DFPattern x_;
+};
+
+/*!
+ * \brief MergeReshapes merges two consecutive reshapes, squeezes, expand_dims or batch_flattens
+ *   into one reshape to the static output shape, or cancels them.
+ */
+class MergeReshapes : public DFPatternRewrite {
+ public:
+  MergeReshapes() {
+    x_ = IsWildcard();
+    DFPattern reshape1 = IsOp(kReshapeOps[0]);
+    DFPattern reshape2 = IsOp(kReshapeOps[0]);
+    for (size_t i = 1; i < kReshapeOps.size(); ++i) {
+      reshape1 = reshape1 || IsOp(kReshapeOps[i]);
+      reshape2 = reshape2 || IsOp(kReshapeOps[i]);
+    }
+    pattern_ = reshape1({reshape2({x_})});
+  }
+
+  Expr Callback(const Expr& pre, const Expr& post,
+                const Map<DFPattern, Array<Expr>>& node_map) const override {
+    auto inner = Downcast<Call>(Downcast<Call>(pre)->args[0]);
+    Array<Integer> out_shape = StaticShape(pre->checked_type());
+    Array<Integer> in_shape = StaticShape(inner->args[0]->checked_type());
+    if (out_shape.empty() || in_shape.empty()) return post;
+    auto x = node_map[x_][0];
+    return SameShape(out_shape, in_shape) ? x : MakeReshape(x, out_shape);
+  }
+
+ private:
+  /*! \brief Pattern input */
+  DFPattern x_;
+};
+
+/*!
+ * \brief MergeDeviceCopies removes the round trips of device copies, and merges two consecutive
+ *   device copies into one copy from the first device to the last.
+ */
+class MergeDeviceCopies : public DFPatternRewrite {
+ public:
+  MergeDeviceCopies() {
+    x_ = IsWildcard();
+    pattern_ = IsOp("device_copy")({IsOp("device_copy")({x_})});
+    require_type_ = false;
+  }
+
+  Expr Callback(const Expr& pre, const Expr& post,
+                const Map<DFPattern, Array<Expr>>& node_map) const override {
+    auto outer = Downcast<Call>(pre);
+    auto inner = Downcast<Call>(outer->args[0]);
+    int src_dev_type = inner->attrs.as<DeviceCopyAttrs>()->src_dev_type;
+    int dst_dev_type = outer->attrs.as<DeviceCopyAttrs>()->dst_dev_type;
+    auto x = node_map[x_][0];
+    return src_dev_type == dst_dev_type ? x : DeviceCopy(x, src_dev_type, dst_dev_type);
+  }
+
+ private:
+  /*! \brief Pattern input */
+  DFPattern x_;
+};
+
+Expr SimplifyDataMovement(const Expr& expr, const IRModule& mod) {
+  // the rewrites will be applied in the given order, and repeated until fixed point
+  DFPatternRewriteComposer composer;
+  composer.AddRewrite<EliminateIdentityMove>();
+  composer.AddRewrite<MergeLayoutTransforms>();
+  composer.AddRewrite<MergeTransposes>();
+  composer.AddRewrite<MergeReshapes>();
+  composer.AddRewrite<MergeDeviceCopies>();
+  return RewritePatterns(composer.MakeCallbacks(), expr, mod);
+}
+
+/*!
+ * \brief Count the bytes written by the layout transforms, transposes, reshapes and device copies
+ *  of an expression, each call counted once.
+ */
+int64_t DataMovementBytes(const Expr& expr) {
+  static const std::vector<std::string> moves = {"layout_transform", "transpose", "device_copy"};
+  int64_t bytes = 0;
+  PostOrderVisit(expr, [&bytes](const Expr& e) {
+    const auto* call = e.as<CallNode>();
+    const auto* op = call != nullptr ? call->op.as<OpNode>() : nullptr;
+    if (op == nullptr) return;
+    if (std::find(moves.begin(), moves.end(), op->name) == moves.end() &&
+        std::find(kReshapeOps.begin(), kReshapeOps.end(), op->name) == kReshapeOps.end()) {
+      return;
+    }
+    const auto* type = call->checked_type().as<TensorTypeNode>();
+    if (type == nullptr) return;
+    Array<Integer> shape = StaticShape(type->shape);
+    if (shape.size() != type->shape.size()) return;
+    int64_t size = (type->dtype.bits() * type->dtype.lanes() + 7) / 8;
+    for (const auto& dim : shape) {
+      size *= dim->value;
+    }
+    bytes += size;
+  });
+  return bytes;
+}
+
+TVM_REGISTER_GLOBAL("relay.analysis.data_movement_bytes").set_body_typed(DataMovementBytes);
+
+namespace transform {
+
+Pass SimplifyDataMovement() {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        return Downcast<Function>(SimplifyDataMovement(f, m));
+      };
+  return CreateFunctionPass(pass_func, 0, "SimplifyDataMovement", {"InferType"});
+}
+
+TVM_REGISTER_GLOBAL("relay._transform.SimplifyDataMovement").set_body_typed(SimplifyDataMovement);
+
+}  // namespace transform
+
+}  // namespace relay
+}  // namespace tvm
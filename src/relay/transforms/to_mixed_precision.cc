@@ -0,0 +1,355 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ *
+ * \file to_mixed_precision.cc
+ * \brief Rewrite a float32 graph to compute in a lower precision float type.
+ *
+ * Each op falls in one of three categories, given by the lists passed to the
+ * pass or else by its FTVMMixedPrecisionConversionType attribute:
+ *
+ *  - always (the allow list): ops which gain the most from the lower
+ *    precision, such as convolutions and dense. They are computed in the mixed
+ *    precision type, accumulating in the type given by the attribute.
+ *  - follow: ops such as elementwise and data movement ops, computed in the
+ *    mixed precision type when all their floating point inputs already are.
+ *  - never (the deny list): numerically sensitive ops, such as softmax,
+ *    reductions and normalizations, which stay in float32.
+ *
+ * Ops without a category are never converted.
+ *
+ * Casts are shared: an expression is cast to a type once, and a cast back to
+ * the type of the input of a cast takes that input, so a value never makes a
+ * round trip through the mixed precision type. The casts of constants are
+ * folded by FoldConstant, and the other casts are elementwise ops which are
+ * fused into the kernels of their neighbours.
+ */
+#include <tvm/relay/attrs/nn.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/op_attr_types.h>
+#include <tvm/relay/transform.h>
+
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+#include "pattern_utils.h"
+
+namespace tvm {
+namespace relay {
+
+/*! \brief The category of an op for mixed precision conversion. */
+enum MixedPrecisionCategory : int {
+  kMixedPrecisionAlways = 0,
+  kMixedPrecisionFollow = 1,
+  kMixedPrecisionNever = 2,
+};
+
+/*!
+ * \brief The mixed precision conversion of a call.
+ * \return The category of the call, the accumulation dtype of the ops with an
+ * out_dtype attribute, and the output dtype.
+ */
+using FTVMMixedPrecisionConversionType = runtime::TypedPackedFunc<Array<ObjectRef>(
+    const Call& call_node, const String& mixed_precision_type)>;
+
+template <typename T>
+Attrs WithOutDtype(const T* attrs, DataType dtype) {
+  auto n = make_object<T>(*attrs);
+  n->out_dtype = dtype;
+  return Attrs(n);
+}
+
+/*! \return The attrs with a new out_dtype, or null when they have none. */
+Attrs ModifyOutDtype(const Attrs& attrs, DataType dtype) {
+  if (const auto* a = attrs.as<Conv1DAttrs>()) return WithOutDtype(a, dtype);
+  if (const auto* a = attrs.as<Conv2DAttrs>()) return WithOutDtype(a, dtype);
+  if (const auto* a = attrs.as<Conv3DAttrs>()) return WithOutDtype(a, dtype);
+  if (const auto* a = attrs.as<Conv1DTransposeAttrs>()) return WithOutDtype(a, dtype);
+  if (const auto* a = attrs.as<Conv2DTransposeAttrs>()) return WithOutDtype(a, dtype);
+  if (const auto* a = attrs.as<Conv3DTransposeAttrs>()) return WithOutDtype(a, dtype);
+  if (const auto* a = attrs.as<Conv2DWinogradAttrs>()) return WithOutDtype(a, dtype);
+  if (const auto* a = attrs.as<Conv3DWinogradAttrs>()) return WithOutDtype(a, dtype);
+  if (const auto* a = attrs.as<DeformableConv2DAttrs>()) return WithOutDtype(a, dtype);
+  if (const auto* a = attrs.as<DenseAttrs>()) return WithOutDtype(a, dtype);
+  return Attrs(nullptr);
+}
+
+class MixedPrecisionMutator : public MixedModeMutator {
+ public:
+  MixedPrecisionMutator(DataType mixed_type, Map<String, Integer> op_categories)
+      : mixed_type_(mixed_type), op_categories_(std::move(op_categories)) {}
+
+  /*! \brief Convert a function, keeping its signature. */
+  Function Convert(const Function& func) {
+    Expr body = CastToType(Mutate(func->body), func->body->checked_type());
+    return Function(func->params, body, func->ret_type, func->type_params, func->attrs, func->span);
+  }
+
+  using MixedModeMutator::VisitExpr_;
+
+  Expr Rewrite_(const CallNode* pre, const Expr& post) final {
+    Call call = Downcast<Call>(post);
+    Array<Expr> args;
+    Type out_type = pre->checked_type();
+    const auto* op = pre->op.as<OpNode>();
+    if (op == nullptr || !HasFloat32(pre)) {
+      for (size_t i = 0; i < call->args.size(); ++i) {
+        args.push_back(CastToType(call->args[i], pre->args[i]->checked_type()));
+      }
+      return Record(Call(call->op, args, call->attrs, call->type_args, call->span), out_type);
+    }
+
+    int category;
+    DataType accumulation_dtype, output_dtype;
+    std::tie(category, accumulation_dtype, output_dtype) = GetConversion(GetRef<Op>(op), pre);
+    bool convert = category == kMixedPrecisionAlways ||
+                   (category == kMixedPrecisionFollow && InputsAreMixed(pre, call));
+    Attrs attrs = call->attrs;
+    DataType result_dtype = mixed_type_;
+    if (category == kMixedPrecisionAlways && accumulation_dtype != mixed_type_) {
+      // An op which cannot accumulate in another type than its inputs stays in float32.
+      Attrs new_attrs = attrs.defined() ? ModifyOutDtype(attrs, accumulation_dtype) : Attrs();
+      if (new_attrs.defined()) {
+        attrs = new_attrs;
+        result_dtype = accumulation_dtype;
+      } else {
+        convert = false;
+      }
+    }
+    for (size_t i = 0; i < call->args.size(); ++i) {
+      Type arg_type = pre->args[i]->checked_type();
+      args.push_back(CastToType(call->args[i], convert ? Mixed(arg_type) : arg_type));
+    }
+    if (!convert) {
+      return Record(Call(call->op, args, call->attrs, call->type_args, call->span), out_type);
+    }
+
+    Expr result = Record(Call(call->op, args, attrs, call->type_args, call->span),
+                         Retype(out_type, DataType::Float(32), result_dtype));
+    return CastToType(result, Retype(out_type, DataType::Float(32), output_dtype));
+  }
+
+  Expr Rewrite_(const TupleNode* pre, const Expr& post) final {
+    Tuple tuple = Downcast<Tuple>(post);
+    Array<Type> fields;
+    for (const auto& field : tuple->fields) fields.push_back(GetType(field));
+    return Record(tuple, TupleType(fields));
+  }
+
+  Expr Rewrite_(const TupleGetItemNode* pre, const Expr& post) final {
+    TupleGetItem get = Downcast<TupleGetItem>(post);
+    const auto* tuple_type = GetType(get->tuple).as<TupleTypeNode>();
+    ICHECK(tuple_type);
+    return Record(get, tuple_type->fields[get->index]);
+  }
+
+  Expr VisitExpr_(const LetNode* op) final {
+    // The bound vars keep their types, so the values are cast back to them.
+    auto pre_visit = [this](const LetNode* op) {
+      this->Mutate(op->var);
+      this->Mutate(op->value);
+    };
+    auto post_visit = [this](const LetNode* op) {
+      Expr expr = GetRef<Expr>(op);
+      Var var = Downcast<Var>(this->Mutate(op->var));
+      Expr value = CastToType(this->Mutate(op->value), op->value->checked_type());
+      Expr body = CastToType(this->Mutate(op->body), op->body->checked_type());
+      this->memo_[expr] = Let(var, value, body, op->span);
+    };
+    ExpandANormalForm(op, pre_visit, post_visit);
+    return memo_[GetRef<Expr>(op)];
+  }
+
+  Expr VisitExpr_(const IfNode* op) final {
+    Expr cond = CastToType(Mutate(op->cond), op->cond->checked_type());
+    Expr true_branch = CastToType(Mutate(op->true_branch), op->true_branch->checked_type());
+    Expr false_branch = CastToType(Mutate(op->false_branch), op->false_branch->checked_type());
+    return If(cond, true_branch, false_branch, op->span);
+  }
+
+  Expr VisitExpr_(const FunctionNode* op) final {
+    Function func = GetRef<Function>(op);
+    if (func->HasNonzeroAttr(attr::kPrimitive)) return func;
+    return Convert(func);
+  }
+
+ private:
+  /*! \return The category, the accumulation and the output dtypes of a call. */
+  std::tuple<int, DataType, DataType> GetConversion(const Op& op, const CallNode* pre) {
+    static auto fconversion =
+        Op::GetAttrMap<FTVMMixedPrecisionConversionType>("FTVMMixedPrecisionConversionType");
+    if (op_categories_.count(op->name)) {
+      int category = op_categories_.at(op->name)->value;
+      DataType dtype = category == kMixedPrecisionNever ? DataType::Float(32) : mixed_type_;
+      DataType accumulation_dtype =
+          category == kMixedPrecisionAlways ? DataType::Float(32) : dtype;
+      return std::make_tuple(category, accumulation_dtype, dtype);
+    }
+    if (!fconversion.count(op)) {
+      return std::make_tuple(kMixedPrecisionNever, DataType::Float(32), DataType::Float(32));
+    }
+    Array<ObjectRef> conversion =
+        fconversion[op](GetRef<Call>(pre), DLDataType2String(mixed_type_));
+    ICHECK_EQ(conversion.size(), 3)
+        << "FTVMMixedPrecisionConversionType of " << op->name
+        << " should return the category, the accumulation dtype and the output dtype";
+    return std::make_tuple(Downcast<Integer>(conversion[0])->value,
+                           DataType(String2DLDataType(Downcast<String>(conversion[1]))),
+                           DataType(String2DLDataType(Downcast<String>(conversion[2]))));
+  }
+
+  /*! \brief Whether a call computes on or returns float32 tensors. */
+  bool HasFloat32(const CallNode* pre) {
+    if (Contains(pre->checked_type(), DataType::Float(32))) return true;
+    for (const auto& arg : pre->args) {
+      if (Contains(arg->checked_type(), DataType::Float(32))) return true;
+    }
+    return false;
+  }
+
+  /*!
+   * \brief Whether the float32 inputs of a call are all in the mixed precision
+   * type after the rewrite, up to constants which can be cast for free.
+   */
+  bool InputsAreMixed(const CallNode* pre, const Call& call) {
+    bool any_mixed = false;
+    for (size_t i = 0; i < pre->args.size(); ++i) {
+      Type arg_type = pre->args[i]->checked_type();
+      if (!Contains(arg_type, DataType::Float(32))) continue;
+      if (pre->args[i]->IsInstance<ConstantNode>()) continue;
+      if (!StructuralEqual()(GetType(call->args[i]), Mixed(arg_type))) return false;
+      any_mixed = true;
+    }
+    return any_mixed;
+  }
+
+  /*! \brief Cast an expression to a type which differs only by its float dtypes. */
+  Expr CastToType(const Expr& expr, const Type& type) {
+    Type current = GetType(expr);
+    if (const auto* tensor_type = type.as<TensorTypeNode>()) {
+      const auto* current_tensor = current.as<TensorTypeNode>();
+      ICHECK(current_tensor);
+      if (current_tensor->dtype == tensor_type->dtype) return expr;
+      return CastTensor(expr, tensor_type->dtype);
+    }
+    const auto* tuple_type = type.as<TupleTypeNode>();
+    if (tuple_type == nullptr || StructuralEqual()(current, type)) return expr;
+    Array<Expr> fields;
+    for (size_t i = 0; i < tuple_type->fields.size(); ++i) {
+      Expr field;
+      if (const auto* tuple = expr.as<TupleNode>()) {
+        field = tuple->fields[i];
+      } else {
+        field = Record(TupleGetItem(expr, i), Downcast<TupleType>(current)->fields[i]);
+      }
+      fields.push_back(CastToType(field, tuple_type->fields[i]));
+    }
+    return Record(Tuple(fields), type);
+  }
+
+  /*! \brief Cast a tensor once, taking the input of a cast when casting it back. */
+  Expr CastTensor(const Expr& expr, DataType dtype) {
+    auto source = cast_sources_.find(expr);
+    if (source != cast_sources_.end() &&
+        GetType(source->second).as<TensorTypeNode>()->dtype == dtype) {
+      return source->second;
+    }
+    auto& cache = dtype == mixed_type_ ? down_casts_ : up_casts_;
+    auto it = cache.find(expr);
+    if (it != cache.end()) return it->second;
+
+    const auto* tensor_type = GetType(expr).as<TensorTypeNode>();
+    Expr cast = Record(relay::Cast(expr, dtype), TensorType(tensor_type->shape, dtype));
+    cast_sources_[cast] = expr;
+    cache[expr] = cast;
+    return cast;
+  }
+
+  /*! \return The type of an expression after the rewrite. */
+  Type GetType(const Expr& expr) {
+    auto it = types_.find(expr);
+    return it != types_.end() ? it->second : expr->checked_type();
+  }
+
+  Expr Record(const Expr& expr, const Type& type) {
+    types_[expr] = type;
+    return expr;
+  }
+
+  Type Mixed(const Type& type) { return Retype(type, DataType::Float(32), mixed_type_); }
+
+  /*! \brief Replace the dtype of the tensors of a type. */
+  static Type Retype(const Type& type, DataType from, DataType to) {
+    if (const auto* tensor_type = type.as<TensorTypeNode>()) {
+      if (tensor_type->dtype != from) return type;
+      return TensorType(tensor_type->shape, to);
+    }
+    if (const auto* tuple_type = type.as<TupleTypeNode>()) {
+      Array<Type> fields;
+      for (const auto& field : tuple_type->fields) fields.push_back(Retype(field, from, to));
+      return TupleType(fields);
+    }
+    return type;
+  }
+
+  /*! \brief Whether a type holds tensors of a dtype. */
+  static bool Contains(const Type& type, DataType dtype) {
+    if (const auto* tensor_type = type.as<TensorTypeNode>()) {
+      return tensor_type->dtype == dtype;
+    }
+    if (const auto* tuple_type = type.as<TupleTypeNode>()) {
+      for (const auto& field : tuple_type->fields) {
+        if (Contains(field, dtype)) return true;
+      }
+    }
+    return false;
+  }
+
+  DataType mixed_type_;
+  Map<String, Integer> op_categories_;
+  /*! \brief The types of the rewritten expressions. */
+  std::unordered_map<Expr, Type, ObjectPtrHash, ObjectPtrEqual> types_;
+  /*! \brief The casts to the mixed precision type and to float32 of each expression. */
+  std::unordered_map<Expr, Expr, ObjectPtrHash, ObjectPtrEqual> down_casts_;
+  std::unordered_map<Expr, Expr, ObjectPtrHash, ObjectPtrEqual> up_casts_;
+  /*! \brief The input of each cast created by the pass. */
+  std::unordered_map<Expr, Expr, ObjectPtrHash, ObjectPtrEqual> cast_sources_;
+};
+
+namespace transform {
+
+Pass ToMixedPrecision(DataType mixed_precision_type, Map<String, Integer> op_categories) {
+  ICHECK(mixed_precision_type.is_float16() || mixed_precision_type.is_bfloat16())
+      << "The mixed precision type should be float16 or bfloat16, but got "
+      << mixed_precision_type;
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        return MixedPrecisionMutator(mixed_precision_type, op_categories).Convert(f);
+      };
+  return CreateFunctionPass(pass_func, 0, "ToMixedPrecision", {"InferType"});
+}
+
+TVM_REGISTER_GLOBAL("relay._transform.ToMixedPrecision").set_body_typed(ToMixedPrecision);
+
+}  // namespace transform
+
+}  // namespace relay
+}  // namespace tvm
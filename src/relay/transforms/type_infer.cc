@@ -45,6 +45,10 @@
 #include <tvm/relay/pattern_functor.h>
 #include <tvm/relay/transform.h>
 
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 #include "../analysis/type_solver.h"
 #include "pass_utils.h"
 
@@ -99,8 +103,15 @@ class TypeInferencer : private ExprFunctor<Type(const Expr&)>,
  public:
   // constructors
 
-  explicit TypeInferencer(IRModule mod, DiagnosticContext diag_ctx)
-      : mod_(mod), diag_ctx(diag_ctx), solver_(GlobalVar(), diag_ctx) {
+  /*!
+   * \param mod The module.
+   * \param diag_ctx The diagnostic context.
+   * \param reusable The subexpressions whose checked types are kept as they are,
+   *  without visiting them again, nullptr to infer every subexpression.
+   */
+  explicit TypeInferencer(IRModule mod, DiagnosticContext diag_ctx,
+                          const std::unordered_set<const Object*>* reusable = nullptr)
+      : mod_(mod), diag_ctx(diag_ctx), solver_(GlobalVar(), diag_ctx), reusable_(reusable) {
     ICHECK(mod.defined()) << "Module must not be null in the type inferencer.";
   }
 
@@ -132,6 +143,24 @@ class TypeInferencer : private ExprFunctor<Type(const Expr&)>,
   /*! \brief Internal map used for memoization. */
   std::unordered_map<Expr, Type, ObjectPtrHash, ObjectPtrEqual> memo_;
 
+  // the subexpressions whose types are reused, can be nullptr.
+  const std::unordered_set<const Object*>* reusable_;
+  // the reused subexpressions reached by the inference, left untouched by the resolver.
+  std::vector<Expr> reused_;
+
+  bool Reusable(const Expr& expr) const {
+    return reusable_ != nullptr && reusable_->count(expr.get()) != 0;
+  }
+
+  // Keep the checked type of a reusable subexpression, without visiting its children.
+  Type Reuse(const Expr& expr) {
+    auto res = memo_.emplace(expr, expr->checked_type_);
+    if (res.second) {
+      reused_.push_back(expr);
+    }
+    return res.first->second;
+  }
+
   void VisitLeaf(const Expr& expr) {
     if (!memo_.count(expr)) {
       Type ret = this->DispatchVisitExpr(expr);
@@ -142,6 +171,9 @@ class TypeInferencer : private ExprFunctor<Type(const Expr&)>,
   bool CheckVisited(const Expr& expr) {
     if (memo_.count(expr)) {
       return true;
+    } else if (Reusable(expr)) {
+      Reuse(expr);
+      return true;
     } else {
       return false;
     }
@@ -180,6 +212,11 @@ class TypeInferencer : private ExprFunctor<Type(const Expr&)>,
     if (it != type_map_.end() && it->second.checked_type.defined()) {
       return it->second.checked_type;
     }
+    if (Reusable(expr)) {
+      Type ret = Reuse(expr);
+      type_map_[expr].checked_type = ret;
+      return ret;
+    }
     Type ret = this->VisitExpr(expr);
     ICHECK(ret.defined());
     KindCheck(ret, mod_, this->diag_ctx);
@@ -588,8 +625,13 @@ class TypeInferencer : private ExprFunctor<Type(const Expr&)>,
 class TypeInferencer::Resolver : public MixedModeMutator, PatternMutator {
  public:
   Resolver(const std::unordered_map<Expr, ResolvedTypeInfo, ObjectPtrHash, ObjectPtrEqual>& tmap,
-           TypeSolver* solver)
-      : tmap_(tmap), solver_(solver) {}
+           TypeSolver* solver, const std::vector<Expr>& reused = {})
+      : tmap_(tmap), solver_(solver) {
+    // the reused subexpressions already carry their types.
+    for (const Expr& expr : reused) {
+      memo_[expr] = expr;
+    }
+  }
 
   using MixedModeMutator::VisitExpr_;
 
@@ -749,7 +791,7 @@ Expr TypeInferencer::Infer(GlobalVar var, Function function) {
   Solve();
 
   // Step 3: Attach resolved types to checked_type field.
-  auto resolved_expr = Resolver(type_map_, &solver_).VisitExpr(function);
+  auto resolved_expr = Resolver(type_map_, &solver_, reused_).VisitExpr(function);
 
   if (!WellFormed(resolved_expr, this->diag_ctx)) {
     this->diag_ctx.Emit(Diagnostic::Bug(function->span)
@@ -789,6 +831,127 @@ struct AllCheckTypePopulated : MixedModeVisitor {
 
 void EnsureCheckedType(const Expr& e) { AllCheckTypePopulated().VisitExpr(e); }
 
+/*!
+ * \brief Find what a previous inference of a function left valid.
+ *
+ *  A pass that rewrites part of a function creates new nodes, which have no
+ *  checked type, and shares the nodes it does not touch. A shared subexpression
+ *  built only from constants, annotated variables and calls of operators keeps
+ *  its checked type, as its type does not depend on the rest of the function.
+ */
+class TypedExprAnalyzer : public MixedModeVisitor {
+ public:
+  /*! \brief The subexpressions whose checked types can be reused. */
+  std::unordered_set<const Object*> reusable;
+  /*! \brief The global functions referenced by the function. */
+  std::unordered_set<const GlobalVarNode*> globals;
+  /*! \brief Whether every subexpression of the function has a checked type. */
+  bool all_typed{true};
+
+  using MixedModeVisitor::VisitExpr_;
+
+  void VisitExpr_(const VarNode* op) final {
+    if (Closed(op) && op->type_annotation.defined() &&
+        StructuralEqual()(op->type_annotation, op->checked_type_)) {
+      reusable.insert(op);
+    }
+  }
+
+  void VisitExpr_(const ConstantNode* op) final {
+    if (Closed(op)) reusable.insert(op);
+  }
+
+  void VisitExpr_(const GlobalVarNode* op) final { globals.insert(op); }
+
+  void VisitExpr_(const CallNode* op) final {
+    bool ok = Closed(op) && op->op.as<OpNode>() != nullptr;
+    for (const Expr& arg : op->args) {
+      ok = ok && reusable.count(arg.get());
+    }
+    if (ok) reusable.insert(op);
+  }
+
+  void VisitExpr_(const TupleNode* op) final {
+    bool ok = Closed(op);
+    for (const Expr& field : op->fields) {
+      ok = ok && reusable.count(field.get());
+    }
+    if (ok) reusable.insert(op);
+  }
+
+  void VisitExpr_(const TupleGetItemNode* op) final {
+    if (Closed(op) && reusable.count(op->tuple.get())) reusable.insert(op);
+  }
+
+  void VisitExpr_(const FunctionNode* op) final {
+    Closed(op);
+    ExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const LetNode* op) final {
+    auto pre_visit = [this](const LetNode* op) {
+      this->Closed(op);
+      this->VisitExpr(op->var);
+      this->VisitExpr(op->value);
+    };
+    auto post_visit = [this](const LetNode* op) {
+      this->VisitExpr(op->body);
+      this->visit_counter_[op] += 1;
+    };
+    ExpandANormalForm(op, pre_visit, post_visit);
+  }
+
+  void VisitExpr_(const IfNode* op) final {
+    Closed(op);
+    ExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const MatchNode* op) final {
+    Closed(op);
+    ExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const RefCreateNode* op) final {
+    Closed(op);
+    ExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const RefReadNode* op) final {
+    Closed(op);
+    ExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const RefWriteNode* op) final {
+    Closed(op);
+    ExprVisitor::VisitExpr_(op);
+  }
+
+ private:
+  // Whether the checked type of the node is defined and mentions no type variable.
+  bool Closed(const ExprNode* op) {
+    if (!op->checked_type_.defined()) {
+      all_typed = false;
+      return false;
+    }
+    auto it = closed_.find(op->checked_type_.get());
+    if (it != closed_.end()) return it->second;
+    OpenTypeFinder finder;
+    finder.VisitType(op->checked_type_);
+    closed_[op->checked_type_.get()] = !finder.open;
+    return !finder.open;
+  }
+
+  // Find the type variables and the incomplete types in a type.
+  struct OpenTypeFinder : public TypeVisitor {
+    bool open{false};
+    void VisitType_(const TypeVarNode* op) final { open = true; }
+    void VisitType_(const IncompleteTypeNode* op) final { open = true; }
+  };
+
+  // the closedness of the types seen so far.
+  std::unordered_map<const Object*, bool> closed_;
+};
+
 // TODO(@jroesch): Can we optimize this?
 void AddGlobalTypes(IRModule mod) {
   std::vector<std::pair<GlobalVar, Function> > updates;
@@ -811,6 +974,51 @@ void AddGlobalTypes(IRModule mod) {
 
 namespace transform {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.InferType.incremental", Bool);
+
+/*!
+ * \brief Find the functions of a module that the previous inference left typed.
+ *
+ *  A function is kept when every subexpression still has its checked type,
+ *  its type was written back into its global var, and it only references
+ *  functions which are kept.
+ *
+ * \param mod The module.
+ * \param analyzers The analysis of every Relay function, to be filled.
+ * \return The global vars of the kept functions.
+ */
+std::unordered_set<const GlobalVarNode*> TypedFunctions(
+    const IRModule& mod, std::unordered_map<const GlobalVarNode*, TypedExprAnalyzer>* analyzers) {
+  std::unordered_set<const GlobalVarNode*> typed;
+  for (const auto& it : mod->functions) {
+    if (auto* func_node = it.second.as<FunctionNode>()) {
+      TypedExprAnalyzer& analyzer = (*analyzers)[it.first.get()];
+      analyzer.VisitExpr(GetRef<Function>(func_node));
+      if (analyzer.all_typed && it.first->checked_type_.same_as(func_node->checked_type_)) {
+        typed.insert(it.first.get());
+      }
+    }
+  }
+  // drop the callers of the functions to infer, until a fixed point.
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto it = typed.begin(); it != typed.end();) {
+      bool stale = false;
+      for (const GlobalVarNode* callee : analyzers->at(*it).globals) {
+        stale = stale || (analyzers->count(callee) && !typed.count(callee));
+      }
+      if (stale) {
+        it = typed.erase(it);
+        changed = true;
+      } else {
+        ++it;
+      }
+    }
+  }
+  return typed;
+}
+
 Pass InferType() {
   auto pass_info = PassInfo(0, "InferType", {});
   return tvm::transform::CreateModulePass(
@@ -822,6 +1030,15 @@ Pass InferType() {
 
         pass_ctx->diag_ctx = DiagnosticContext::Default(updated_mod);
 
+        // Only infer what changed since the last inference, when incremental.
+        bool incremental =
+            pass_ctx->GetConfig<Bool>("relay.InferType.incremental", Bool(false)).value();
+        std::unordered_map<const GlobalVarNode*, TypedExprAnalyzer> analyzers;
+        std::unordered_set<const GlobalVarNode*> typed;
+        if (incremental) {
+          typed = TypedFunctions(updated_mod, &analyzers);
+        }
+
         // Add all the type annotations to the functions in the model.
         AddGlobalTypes(mod);
 
@@ -836,14 +1053,17 @@ Pass InferType() {
           if (auto* func_node = it.second.as<FunctionNode>()) {
             auto func = GetRef<Function>(func_node);
 
-            // // If a function already has type information we can skip checking it.
-            // if (func->checked_type_.defined()) {
-            //   continue;
-            // }
+            // If a function still has its type information we can skip checking it.
+            if (typed.count(it.first.get())) {
+              continue;
+            }
 
             // TODO(@jroesch): we should be able to move the type inferencer outside
             // of this function but it seems to be more stateful then I expect.
-            auto inferencer = TypeInferencer(mod, pass_ctx->diag_ctx.value());
+            auto analyzer = analyzers.find(it.first.get());
+            auto inferencer =
+                TypeInferencer(mod, pass_ctx->diag_ctx.value(),
+                               analyzer != analyzers.end() ? &analyzer->second.reusable : nullptr);
             auto updated_func = inferencer.Infer(it.first, func);
 
             pass_ctx->diag_ctx.value().Render();
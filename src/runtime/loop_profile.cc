@@ -0,0 +1,185 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/loop_profile.cc
+ * \brief Counters of the loops instrumented by tir.transform.LoopProfile.
+ */
+#include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/registry.h>
+
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+
+/*! \brief The counters of a loop. */
+struct LoopCounter {
+  /*! \brief The number of times the loop is entered. */
+  int64_t entries{0};
+  /*! \brief The total number of iterations. */
+  int64_t trips{0};
+  /*! \brief The total time spent in the loop in nanoseconds. */
+  int64_t nanos{0};
+};
+
+/*!
+ * \brief The counters recorded by one thread. Only the thread itself updates them, the mutex is
+ *  contended by Dump and Reset alone, so the instrumented parallel loops do not serialize.
+ */
+struct ThreadLoopCounters {
+  using Entry = std::pair<const std::string, LoopCounter>;
+
+  std::mutex mutex;
+  /*! \brief The counters, keyed by a copy of the key. */
+  std::unordered_map<std::string, LoopCounter> counters;
+  /*! \brief The entries of the key string constants seen so far, to skip hashing the keys. */
+  std::unordered_map<const char*, Entry*> cache;
+
+  /*! \return The counter of the key. Must be called with the mutex held. */
+  LoopCounter* Find(const char* key) {
+    auto it = cache.find(key);
+    // the module of a cached address may be unloaded and another one loaded at the same place.
+    if (it != cache.end() && std::strcmp(it->second->first.c_str(), key) == 0) {
+      return &it->second->second;
+    }
+    Entry* entry = &*counters.emplace(key, LoopCounter()).first;
+    cache[key] = entry;
+    return &entry->second;
+  }
+};
+
+class LoopProfiler {
+ public:
+  static LoopProfiler* Global() {
+    static LoopProfiler* inst = new LoopProfiler();
+    return inst;
+  }
+
+  int64_t Enter(const char* key, int64_t trip_count) {
+    ThreadLoopCounters* local = ThreadLocal();
+    {
+      std::lock_guard<std::mutex> lock(local->mutex);
+      LoopCounter* counter = local->Find(key);
+      counter->entries += 1;
+      counter->trips += trip_count;
+    }
+    return Now();
+  }
+
+  void Exit(const char* key, int64_t start) {
+    int64_t elapsed = Now() - start;
+    ThreadLoopCounters* local = ThreadLocal();
+    std::lock_guard<std::mutex> lock(local->mutex);
+    local->Find(key)->nanos += elapsed;
+  }
+
+  void Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& local : threads_) {
+      std::lock_guard<std::mutex> local_lock(local->mutex);
+      local->counters.clear();
+      local->cache.clear();
+    }
+  }
+
+  /*! \return The counters in json, {key: [entries, trips, nanos]}. */
+  std::string Dump() {
+    std::map<std::string, LoopCounter> merged;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      // the same loop can be run by several threads, or instrumented in several modules.
+      for (const auto& local : threads_) {
+        std::lock_guard<std::mutex> local_lock(local->mutex);
+        for (const auto& kv : local->counters) {
+          LoopCounter& counter = merged[kv.first];
+          counter.entries += kv.second.entries;
+          counter.trips += kv.second.trips;
+          counter.nanos += kv.second.nanos;
+        }
+      }
+    }
+    std::ostringstream os;
+    os << "{";
+    for (auto it = merged.begin(); it != merged.end(); ++it) {
+      if (it != merged.begin()) os << ", ";
+      os << "\"";
+      for (char c : it->first) {
+        if (c == '"' || c == '\\') os << '\\';
+        os << c;
+      }
+      os << "\": [" << it->second.entries << ", " << it->second.trips << ", " << it->second.nanos
+         << "]";
+    }
+    os << "}";
+    return os.str();
+  }
+
+ private:
+  static int64_t Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  /*! \return The counters of the calling thread, registered on its first call. */
+  ThreadLoopCounters* ThreadLocal() {
+    static thread_local std::shared_ptr<ThreadLoopCounters> local = [this]() {
+      auto local = std::make_shared<ThreadLoopCounters>();
+      std::lock_guard<std::mutex> lock(mutex_);
+      threads_.push_back(local);
+      return local;
+    }();
+    return local.get();
+  }
+
+  /*! \brief Guards threads_. */
+  std::mutex mutex_;
+  // kept after the threads exit, until the process exits.
+  std::vector<std::shared_ptr<ThreadLoopCounters>> threads_;
+};
+
+TVM_REGISTER_GLOBAL("runtime.LoopProfileDump").set_body_typed([]() {
+  return LoopProfiler::Global()->Dump();
+});
+
+TVM_REGISTER_GLOBAL("runtime.LoopProfileReset").set_body_typed([]() {
+  LoopProfiler::Global()->Reset();
+});
+
+}  // namespace runtime
+}  // namespace tvm
+
+int64_t TVMBackendLoopProfileEnter(const char* key, int64_t trip_count) {
+  return tvm::runtime::LoopProfiler::Global()->Enter(key, trip_count);
+}
+
+int TVMBackendLoopProfileExit(const char* key, int64_t start) {
+  tvm::runtime::LoopProfiler::Global()->Exit(key, start);
+  return 0;
+}
@@ -24,6 +24,7 @@
 // Part of the code are adapted from Halide's CodeGen_LLVM
 #include "codegen_llvm.h"
 
+#include <tvm/ir/transform.h>
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/runtime/crt/error_codes.h>
 #include <tvm/runtime/device_api.h>
@@ -74,6 +75,9 @@ void CodeGenLLVM::Init(const std::string& module_name, llvm::TargetMachine* tm,
   md_very_likely_branch_ = md_builder_->createBranchWeights(1 << 20, 1);
   md_tbaa_root_ = md_builder_->createTBAARoot("tvm-tbaa");
   md_tbaa_alias_set_ = md_builder_->createTBAANode("tvm-alias", md_tbaa_root_);
+  enable_gather_ = tvm::transform::PassContext::Current()
+                       ->GetConfig<Bool>("tir.enable_vectorize_gather", Bool(false))
+                       .value();
   this->InitTarget(tm);
 }
 
@@ -595,6 +599,55 @@ llvm::Value* CodeGenLLVM::CreateVecSlice(llvm::Value* vec, int begin, int extent
   return builder_->CreateShuffleVector(vec, vec, llvm::ConstantVector::get(indices));
 }
 
+llvm::Value* CodeGenLLVM::CreateVecReduce(const CallNode* op) {
+  DataType t = op->args[0].dtype();
+  llvm::Value* vec = MakeValue(op->args[0]);
+  bool is_float = t.is_float();
+  bool is_signed = t.is_int();
+#if TVM_LLVM_VERSION >= 120
+  if (op->op.same_as(builtin::vector_reduce_add()) ||
+      op->op.same_as(builtin::vector_reduce_mul())) {
+    bool is_add = op->op.same_as(builtin::vector_reduce_add());
+    if (!is_float) {
+      return is_add ? builder_->CreateAddReduce(vec) : builder_->CreateMulReduce(vec);
+    }
+    llvm::Type* etype = DTypeToLLVMType(t.element_of());
+    llvm::CallInst* ret =
+        is_add ? builder_->CreateFAddReduce(llvm::ConstantFP::getNegativeZero(etype), vec)
+               : builder_->CreateFMulReduce(llvm::ConstantFP::get(etype, 1.0), vec);
+    // allow a tree reduction instead of the sequential one.
+    ret->setHasAllowReassoc(true);
+    return ret;
+  } else if (op->op.same_as(builtin::vector_reduce_max())) {
+    return is_float ? builder_->CreateFPMaxReduce(vec)
+                    : builder_->CreateIntMaxReduce(vec, is_signed);
+  } else {
+    return is_float ? builder_->CreateFPMinReduce(vec)
+                    : builder_->CreateIntMinReduce(vec, is_signed);
+  }
+#else
+  // tree combine the two halves of the vector.
+  int lanes = t.lanes();
+  ICHECK_EQ(lanes & (lanes - 1), 0) << "Can only reduce a vector with power of two lanes";
+  auto combine = [&](llvm::Value* a, llvm::Value* b) -> llvm::Value* {
+    if (op->op.same_as(builtin::vector_reduce_add())) {
+      return is_float ? builder_->CreateFAdd(a, b) : builder_->CreateAdd(a, b);
+    } else if (op->op.same_as(builtin::vector_reduce_mul())) {
+      return is_float ? builder_->CreateFMul(a, b) : builder_->CreateMul(a, b);
+    } else if (op->op.same_as(builtin::vector_reduce_max())) {
+      return builder_->CreateSelect(CreateGT(t, a, b), a, b);
+    } else {
+      return builder_->CreateSelect(CreateLT(t, a, b), a, b);
+    }
+  };
+  while (lanes > 1) {
+    lanes /= 2;
+    vec = combine(CreateVecSlice(vec, 0, lanes), CreateVecSlice(vec, lanes, lanes));
+  }
+  return builder_->CreateExtractElement(vec, ConstInt32(0));
+#endif
+}
+
 llvm::Value* CodeGenLLVM::CreateVecFlip(llvm::Value* vec) {
   int num_elems = GetVectorNumElements(vec);
 #if TVM_LLVM_VERSION >= 110
@@ -748,6 +801,50 @@ llvm::Value* CodeGenLLVM::CreateBufferPtr(DataType t, llvm::Value* buffer, llvm:
   return builder_->CreateInBoundsGEP(buffer, index);
 }
 
+llvm::Value* CodeGenLLVM::CreateMaskedLoad(DataType t, llvm::Value* ptr, int alignment,
+                                           llvm::Value* mask) {
+  llvm::Value* passthru = llvm::UndefValue::get(DTypeToLLVMType(t));
+#if TVM_LLVM_VERSION >= 130
+  return builder_->CreateMaskedLoad(DTypeToLLVMType(t), ptr, llvm::Align(alignment), mask,
+                                    passthru);
+#elif TVM_LLVM_VERSION >= 110
+  return builder_->CreateMaskedLoad(ptr, llvm::Align(alignment), mask, passthru);
+#else
+  return builder_->CreateMaskedLoad(ptr, alignment, mask, passthru);
+#endif
+}
+
+llvm::Value* CodeGenLLVM::CreateMaskedGather(DataType t, llvm::Value* ptrs, int alignment,
+                                             llvm::Value* mask) {
+  llvm::Value* passthru = llvm::UndefValue::get(DTypeToLLVMType(t));
+#if TVM_LLVM_VERSION >= 130
+  return builder_->CreateMaskedGather(DTypeToLLVMType(t), ptrs, llvm::Align(alignment), mask,
+                                      passthru);
+#elif TVM_LLVM_VERSION >= 110
+  return builder_->CreateMaskedGather(ptrs, llvm::Align(alignment), mask, passthru);
+#else
+  return builder_->CreateMaskedGather(ptrs, alignment, mask, passthru);
+#endif
+}
+
+void CodeGenLLVM::CreateMaskedStore(llvm::Value* value, llvm::Value* ptr, int alignment,
+                                    llvm::Value* mask) {
+#if TVM_LLVM_VERSION >= 110
+  builder_->CreateMaskedStore(value, ptr, llvm::Align(alignment), mask);
+#else
+  builder_->CreateMaskedStore(value, ptr, alignment, mask);
+#endif
+}
+
+void CodeGenLLVM::CreateMaskedScatter(llvm::Value* value, llvm::Value* ptrs, int alignment,
+                                      llvm::Value* mask) {
+#if TVM_LLVM_VERSION >= 110
+  builder_->CreateMaskedScatter(value, ptrs, llvm::Align(alignment), mask);
+#else
+  builder_->CreateMaskedScatter(value, ptrs, alignment, mask);
+#endif
+}
+
 llvm::Value* CodeGenLLVM::GetVarValue(const VarNode* v) const {
   auto it = var_map_.find(v);
   ICHECK(it != var_map_.end()) << "cannot find variable " << v->name_hint;
@@ -967,6 +1064,11 @@ llvm::Value* CodeGenLLVM::CreateIntrinsic(const CallNode* op) {
       indices.push_back(i);
     }
     return builder_->CreateShuffleVector(v0, v1, indices);
+  } else if (op->op.same_as(builtin::vector_reduce_add()) ||
+             op->op.same_as(builtin::vector_reduce_mul()) ||
+             op->op.same_as(builtin::vector_reduce_max()) ||
+             op->op.same_as(builtin::vector_reduce_min())) {
+    return CreateVecReduce(op);
   } else if (op->op.same_as(builtin::atomic_add())) {
     // TODO(masahi): Support atomic for CPU backend
     LOG(FATAL) << "CPU backend does not support atomic add yet.";
@@ -1142,6 +1244,11 @@ llvm::Value* CodeGenLLVM::VisitExpr_(const LetNode* op) {
   return MakeValue(op->body);
 }
 
+bool CodeGenLLVM::IsGatherIndex(const PrimExpr& index, bool is_volatile) const {
+  return enable_gather_ && !is_volatile && index.as<RampNode>() == nullptr &&
+         index.as<BroadcastNode>() == nullptr;
+}
+
 llvm::Value* CodeGenLLVM::VisitExpr_(const LoadNode* op) {
   DataType t = op->dtype;
   bool is_volatile = volatile_buf_.count(op->buffer_var.get());
@@ -1162,22 +1269,29 @@ llvm::Value* CodeGenLLVM::VisitExpr_(const LoadNode* op) {
   } else {
     // vector load
     unsigned addrspace = llvm::dyn_cast<llvm::PointerType>(buffer->getType())->getAddressSpace();
-    if (const RampNode* ramp = op->index.as<RampNode>()) {
-      if (is_one(ramp->stride)) {
-        int alignment, native_bits;
-        GetAlignment(t, op->buffer_var.get(), ramp->base, &alignment, &native_bits);
-        ICHECK_EQ(ramp->lanes, t.lanes());
-        llvm::Value* ptr = CreateBufferPtr(t.element_of(), buffer, MakeValue(ramp->base));
-        ptr = builder_->CreatePointerCast(ptr, DTypeToLLVMType(t)->getPointerTo(addrspace));
+    const RampNode* ramp = op->index.as<RampNode>();
+    if (ramp && is_one(ramp->stride)) {
+      int alignment, native_bits;
+      GetAlignment(t, op->buffer_var.get(), ramp->base, &alignment, &native_bits);
+      ICHECK_EQ(ramp->lanes, t.lanes());
+      llvm::Value* ptr = CreateBufferPtr(t.element_of(), buffer, MakeValue(ramp->base));
+      ptr = builder_->CreatePointerCast(ptr, DTypeToLLVMType(t)->getPointerTo(addrspace));
+      if (!is_one(op->predicate)) {
+        return CreateMaskedLoad(t, ptr, alignment, MakeValue(op->predicate));
+      }
 #if TVM_LLVM_VERSION >= 110
-        llvm::LoadInst* load =
-            builder_->CreateAlignedLoad(ptr, llvm::Align(alignment), is_volatile);
+      llvm::LoadInst* load = builder_->CreateAlignedLoad(ptr, llvm::Align(alignment), is_volatile);
 #else
-        llvm::LoadInst* load = builder_->CreateAlignedLoad(ptr, alignment, is_volatile);
+      llvm::LoadInst* load = builder_->CreateAlignedLoad(ptr, alignment, is_volatile);
 #endif
-        AddAliasInfo(load, op->buffer_var.get(), op->index);
-        return load;
-      }
+      AddAliasInfo(load, op->buffer_var.get(), op->index);
+      return load;
+    }
+    // Predicated accesses become a masked gather, and so do data dependent indices
+    // when enabled. Constant strided and broadcast accesses are cheaper as scalar loads.
+    if (t.bits() >= 8 && (!is_one(op->predicate) || IsGatherIndex(op->index, is_volatile))) {
+      llvm::Value* ptrs = CreateBufferPtr(t.element_of(), buffer, index);
+      return CreateMaskedGather(t, ptrs, t.bits() / 8, MakeValue(op->predicate));
     }
   }
   // scalarized load.
@@ -1258,7 +1372,6 @@ llvm::Value* CodeGenLLVM::VisitExpr_(const BroadcastNode* op) {
 }
 
 void CodeGenLLVM::VisitStmt_(const StoreNode* op) {
-  ICHECK(is_one(op->predicate)) << op->predicate;
   DataType t = op->value.dtype();
   bool is_volatile = volatile_buf_.count(op->buffer_var.get());
   llvm::Value* buffer = MakeValue(op->buffer_var);
@@ -1266,6 +1379,7 @@ void CodeGenLLVM::VisitStmt_(const StoreNode* op) {
   llvm::Value* value = MakeValue(op->value);
 
   if (t.lanes() == 1) {
+    ICHECK(is_one(op->predicate)) << op->predicate;
     int alignment, native_bits;
     GetAlignment(t, op->buffer_var.get(), op->index, &alignment, &native_bits);
     llvm::Value* ptr = CreateBufferPtr(t, buffer, index);
@@ -1280,25 +1394,36 @@ void CodeGenLLVM::VisitStmt_(const StoreNode* op) {
   } else {
     // vector store
     unsigned addrspace = llvm::dyn_cast<llvm::PointerType>(buffer->getType())->getAddressSpace();
-    if (const RampNode* ramp = op->index.as<RampNode>()) {
-      if (is_one(ramp->stride)) {
-        int alignment, native_bits;
-        GetAlignment(t, op->buffer_var.get(), ramp->base, &alignment, &native_bits);
-        ICHECK_EQ(ramp->lanes, t.lanes());
-        llvm::Value* ptr = CreateBufferPtr(t.element_of(), buffer, MakeValue(ramp->base));
-        ptr = builder_->CreatePointerCast(ptr, DTypeToLLVMType(t)->getPointerTo(addrspace));
+    const RampNode* ramp = op->index.as<RampNode>();
+    if (ramp && is_one(ramp->stride)) {
+      int alignment, native_bits;
+      GetAlignment(t, op->buffer_var.get(), ramp->base, &alignment, &native_bits);
+      ICHECK_EQ(ramp->lanes, t.lanes());
+      llvm::Value* ptr = CreateBufferPtr(t.element_of(), buffer, MakeValue(ramp->base));
+      ptr = builder_->CreatePointerCast(ptr, DTypeToLLVMType(t)->getPointerTo(addrspace));
+      if (!is_one(op->predicate)) {
+        CreateMaskedStore(value, ptr, alignment, MakeValue(op->predicate));
+        return;
+      }
 #if TVM_LLVM_VERSION >= 110
-        llvm::StoreInst* store =
-            builder_->CreateAlignedStore(value, ptr, llvm::Align(alignment), is_volatile);
+      llvm::StoreInst* store =
+          builder_->CreateAlignedStore(value, ptr, llvm::Align(alignment), is_volatile);
 #else
-        llvm::StoreInst* store = builder_->CreateAlignedStore(value, ptr, alignment, is_volatile);
+      llvm::StoreInst* store = builder_->CreateAlignedStore(value, ptr, alignment, is_volatile);
 #endif
-        AddAliasInfo(store, op->buffer_var.get(), op->index);
-        return;
-      }
+      AddAliasInfo(store, op->buffer_var.get(), op->index);
+      return;
+    }
+    // Lanes are written in order, so a later lane wins on duplicated indices
+    // exactly as in the scalarized store.
+    if (t.bits() >= 8 && (!is_one(op->predicate) || IsGatherIndex(op->index, is_volatile))) {
+      llvm::Value* ptrs = CreateBufferPtr(t.element_of(), buffer, index);
+      CreateMaskedScatter(value, ptrs, t.bits() / 8, MakeValue(op->predicate));
+      return;
     }
   }
   ICHECK_GE(t.bits(), 8);
+  ICHECK(is_one(op->predicate)) << op->predicate;
   // scalarized store.
   int basic_align = t.bits() / 8;
   auto f = [&](int i, llvm::Value* index) {
@@ -285,9 +285,21 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const PrimExpr&)>,
   llvm::Value* CreateMul(DataType t, llvm::Value* a, llvm::Value* b);
   llvm::Value* CreateBroadcast(llvm::Value* value, int lanes);
   llvm::Value* CreateBufferPtr(DataType t, llvm::Value* buffer, llvm::Value* index);
+  // Masked vector memory access, ptr is a vector pointer for load/store
+  // and a vector of element pointers for gather/scatter.
+  llvm::Value* CreateMaskedLoad(DataType t, llvm::Value* ptr, int alignment, llvm::Value* mask);
+  llvm::Value* CreateMaskedGather(DataType t, llvm::Value* ptrs, int alignment,
+                                  llvm::Value* mask);
+  void CreateMaskedStore(llvm::Value* value, llvm::Value* ptr, int alignment, llvm::Value* mask);
+  void CreateMaskedScatter(llvm::Value* value, llvm::Value* ptrs, int alignment,
+                           llvm::Value* mask);
+  // Whether an unpredicated vector access at index becomes a gather or scatter.
+  bool IsGatherIndex(const PrimExpr& index, bool is_volatile) const;
   // Vector concatenation.
   llvm::Value* CreateVecSlice(llvm::Value* vec, int begin, int extent);
   llvm::Value* CreateVecFlip(llvm::Value* vec);
+  // Horizontal reduction of the vector_reduce_* intrinsics.
+  llvm::Value* CreateVecReduce(const CallNode* op);
   llvm::Value* CreateVecConcat(std::vector<llvm::Value*> vecs);
   llvm::Value* CreateVecPad(llvm::Value* vec, int target_lanes);
   // Create serial for
@@ -336,6 +348,8 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const PrimExpr&)>,
   std::unordered_map<std::string, llvm::Constant*> str_map_;
   // Whether current function is restricted
   bool is_restricted_{true};
+  // Whether vector accesses with data dependent indices become gathers and scatters
+  bool enable_gather_{false};
   // The analyzer information
   std::unique_ptr<arith::Analyzer> analyzer_;
   // set of var that are not restricted(can alias)
@@ -24,6 +24,10 @@
 #ifdef TVM_LLVM_VERSION
 
 #include <tvm/runtime/registry.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <vector>
 
 #include "codegen_cpu.h"
 #include "llvm/MC/MCSubtargetInfo.h"
@@ -66,10 +70,12 @@ bool TargetHasFeature(const llvm::TargetMachine& tm, const std::string& feature)
 class CodeGenX86_64 final : public CodeGenCPU {
  public:
   llvm::Value* VisitExpr_(const CastNode* op) override;
+  void VisitStmt_(const AttrStmtNode* op) override;
 
  private:
   llvm::Value* CallVectorIntrin(llvm::Intrinsic::ID id, size_t intrin_lanes, llvm::Type* result_ty,
                                 const std::vector<llvm::Value*>& args);
+  bool EmitVNNIDotProduct(const Stmt& body);
 };
 
 llvm::Value* CodeGenX86_64::VisitExpr_(const CastNode* op) {
@@ -113,6 +119,190 @@ llvm::Value* CodeGenX86_64::VisitExpr_(const CastNode* op) {
   return CodeGenCPU::VisitExpr_(op);
 }
 
+void CodeGenX86_64::VisitStmt_(const AttrStmtNode* op) {
+  // The loop annotated by the auto-scheduler to be mapped onto the VNNI dot-product instructions.
+  // Fall back to the normal code generation if the loop body does not match the pattern.
+  if (op->attr_key == "pragma_x86_vnni") {
+    if (!EmitVNNIDotProduct(op->body)) {
+      this->VisitStmt(op->body);
+    }
+    return;
+  }
+  CodeGenCPU::VisitStmt_(op);
+}
+
+namespace {
+// Return x if `expr` widens an 8-bit integer x to int32, i.e. int32(x) or broadcast(int32(x)).
+PrimExpr MatchInt8Operand(const PrimExpr& expr) {
+  if (const auto* op = expr.as<CastNode>()) {
+    const DataType& from = op->value.dtype();
+    if (op->dtype.is_int() && op->dtype.bits() == 32 && (from.is_int() || from.is_uint()) &&
+        from.bits() == 8) {
+      return op->value;
+    }
+  } else if (const auto* op = expr.as<BroadcastNode>()) {
+    PrimExpr value = MatchInt8Operand(op->value);
+    if (value.defined()) {
+      return tir::Broadcast(value, op->lanes);
+    }
+  }
+  return PrimExpr();
+}
+
+// Return whether `load` reads the element written by `store`.
+bool IsAccumulatorLoad(const PrimExpr& load, const StoreNode* store) {
+  const auto* op = load.as<LoadNode>();
+  return op != nullptr && op->buffer_var.same_as(store->buffer_var) &&
+         tir::is_one(op->predicate) && StructuralEqual()(op->index, store->index);
+}
+}  // namespace
+
+/*
+ * Map an int8 dot-product onto vpdpbusd, which sums up the products of 4 pairs of uint8 and int8
+ * into each int32 lane. The body must be either a loop whose extent is a multiple of 4, or the
+ * unrolled statements of such a loop, and each iteration must perform
+ *   C[index] = C[index] + int32(a) * int32(b)
+ * where a, b are uint8 and int8 vectors (in any order), and C is an int32 vector whose lanes are
+ * a multiple of 16.
+ */
+bool CodeGenX86_64::EmitVNNIDotProduct(const Stmt& body) {
+#if TVM_LLVM_VERSION >= 80
+  if (!TargetHasFeature(*target_machine_, "avx512vnni")) {
+    return false;
+  }
+
+  // Collect the accumulation of every iteration.
+  std::vector<Stmt> stores;
+  if (const auto* loop = body.as<ForNode>()) {
+    const auto* extent = loop->extent.as<IntImmNode>();
+    if (extent == nullptr || !tir::is_zero(loop->min) ||
+        (loop->kind != ForKind::kSerial && loop->kind != ForKind::kUnrolled)) {
+      return false;
+    }
+    for (int64_t i = 0; i < extent->value; ++i) {
+      stores.push_back(
+          tir::Substitute(loop->body, {{loop->loop_var, IntImm(loop->loop_var.dtype(), i)}}));
+    }
+  } else if (const auto* seq = body.as<SeqStmtNode>()) {
+    for (const Stmt& stmt : seq->seq) {
+      stores.push_back(stmt);
+    }
+  } else {
+    return false;
+  }
+  if (stores.empty() || stores.size() % 4 != 0) {
+    return false;
+  }
+
+  const StoreNode* first = stores[0].as<StoreNode>();
+  if (first == nullptr) {
+    return false;
+  }
+  const DataType& dtype = first->value.dtype();
+  if (!dtype.is_int() || dtype.bits() != 32 || dtype.lanes() % 16 != 0 ||
+      !tir::is_one(first->predicate)) {
+    return false;
+  }
+  const VarNode* acc_buffer = first->buffer_var.get();
+
+  PrimExpr acc;
+  std::vector<PrimExpr> unsigned_terms, signed_terms;
+  for (const Stmt& stmt : stores) {
+    const StoreNode* store = stmt.as<StoreNode>();
+    if (store == nullptr || !store->buffer_var.same_as(first->buffer_var) ||
+        !tir::is_one(store->predicate) || !StructuralEqual()(store->index, first->index)) {
+      return false;
+    }
+    const auto* add = store->value.as<AddNode>();
+    if (add == nullptr) {
+      return false;
+    }
+    PrimExpr term;
+    if (IsAccumulatorLoad(add->a, store)) {
+      term = add->b;
+    } else if (IsAccumulatorLoad(add->b, store)) {
+      term = add->a;
+    } else {
+      return false;
+    }
+    if (!acc.defined()) {
+      acc = IsAccumulatorLoad(add->a, store) ? add->a : add->b;
+    }
+
+    const auto* mul = term.as<MulNode>();
+    if (mul == nullptr) {
+      return false;
+    }
+    PrimExpr lhs = MatchInt8Operand(mul->a);
+    PrimExpr rhs = MatchInt8Operand(mul->b);
+    if (!lhs.defined() || !rhs.defined() || lhs.dtype().lanes() != dtype.lanes() ||
+        rhs.dtype().lanes() != dtype.lanes()) {
+      return false;
+    }
+    if (lhs.dtype().is_int() && rhs.dtype().is_uint()) {
+      std::swap(lhs, rhs);
+    }
+    if (!lhs.dtype().is_uint() || !rhs.dtype().is_int()) {
+      return false;
+    }
+    // The operands must not read the accumulator, since all the accumulations are fused.
+    auto reads_acc = [acc_buffer](const VarNode* v) { return v == acc_buffer; };
+    if (tir::ExprUseVar(lhs, reads_acc) || tir::ExprUseVar(rhs, reads_acc)) {
+      return false;
+    }
+    unsigned_terms.push_back(lhs);
+    signed_terms.push_back(rhs);
+  }
+
+  // Interleave 4 vectors of 8-bit lanes [l * 4 + k] = vec[k][l] and reinterpret them as int32.
+  const int lanes = 16;
+  auto pack = [this, lanes](const std::vector<llvm::Value*>& vecs, int begin) {
+    std::vector<llvm::Value*> slices;
+    for (llvm::Value* vec : vecs) {
+      slices.push_back(CreateVecSlice(vec, begin, lanes));
+    }
+    llvm::Value* concat = CreateVecConcat(slices);
+    std::vector<llvm::Constant*> indices;
+    for (int l = 0; l < lanes; ++l) {
+      for (int k = 0; k < 4; ++k) {
+        indices.push_back(llvm::ConstantInt::get(t_int32_, k * lanes + l));
+      }
+    }
+    llvm::Value* interleaved =
+        builder_->CreateShuffleVector(concat, concat, llvm::ConstantVector::get(indices));
+    return builder_->CreateBitCast(interleaved, DTypeToLLVMType(DataType::Int(32, lanes)));
+  };
+
+  llvm::Function* vpdpbusd =
+      llvm::Intrinsic::getDeclaration(module_.get(), ::llvm::Intrinsic::x86_avx512_vpdpbusd_512);
+  llvm::Value* acc_value = MakeValue(acc);
+  std::vector<llvm::Value*> results;
+  for (int begin = 0; begin < dtype.lanes(); begin += lanes) {
+    results.push_back(CreateVecSlice(acc_value, begin, lanes));
+  }
+  for (size_t i = 0; i < unsigned_terms.size(); i += 4) {
+    std::vector<llvm::Value*> a, b;
+    for (size_t k = i; k < i + 4; ++k) {
+      a.push_back(MakeValue(unsigned_terms[k]));
+      b.push_back(MakeValue(signed_terms[k]));
+    }
+    for (size_t j = 0; j < results.size(); ++j) {
+      results[j] = builder_->CreateCall(
+          vpdpbusd, {results[j], pack(a, j * lanes), pack(b, j * lanes)});
+    }
+  }
+
+  // Store the result through the normal store path by binding it to a variable.
+  Var result_var("vnni_result", dtype);
+  var_map_[result_var.get()] = CreateVecConcat(results);
+  this->VisitStmt(Store(first->buffer_var, result_var, first->index, first->predicate));
+  var_map_.erase(result_var.get());
+  return true;
+#else
+  return false;
+#endif
+}
+
 llvm::Value* CodeGenX86_64::CallVectorIntrin(llvm::Intrinsic::ID id, size_t intrin_lanes,
                                              llvm::Type* result_ty,
                                              const std::vector<llvm::Value*>& args) {
@@ -0,0 +1,426 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file index_strength_reduction.cc
+ * \brief Hoist the loop invariant index computations, and replace the
+ *  div/mod of the affine indices of the innermost loops with counters.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/arith/iter_affine_map.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/expr.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <functional>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace tir {
+
+struct IndexStrengthReductionConfigNode
+    : public tvm::AttrsNode<IndexStrengthReductionConfigNode> {
+  bool reduce_power_of_two;
+
+  TVM_DECLARE_ATTRS(IndexStrengthReductionConfigNode,
+                    "tir.transform.IndexStrengthReductionConfig") {
+    TVM_ATTR_FIELD(reduce_power_of_two)
+        .describe("Whether to replace the div/mod by powers of two, which are already "
+                  "lowered to shifts and masks")
+        .set_default(false);
+  }
+};
+
+class IndexStrengthReductionConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(IndexStrengthReductionConfig, Attrs,
+                                            IndexStrengthReductionConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(IndexStrengthReductionConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.IndexStrengthReduction", IndexStrengthReductionConfig);
+
+/*! \return Whether the expression is a scalar integer. */
+inline bool IsScalarIndex(const PrimExpr& e) {
+  return e.dtype().lanes() == 1 && (e.dtype().is_int() || e.dtype().is_uint());
+}
+
+/*!
+ * \brief Visit the index expressions, which are the indices of the loads
+ *  and stores and the values of the integer let bindings.
+ */
+class IndexVisitor : public StmtExprVisitor {
+ public:
+  /*! \param fvisit Called on each index sub-expression, returns true to skip its operands. */
+  explicit IndexVisitor(std::function<bool(const PrimExpr&)> fvisit) : fvisit_(fvisit) {}
+
+  void VisitExpr(const PrimExpr& e) final {
+    if (in_index_ && fvisit_(e)) return;
+    StmtExprVisitor::VisitExpr(e);
+  }
+
+  void VisitExpr_(const LoadNode* op) final {
+    VisitIndex(op->index);
+    this->VisitExpr(op->predicate);
+  }
+
+  void VisitStmt_(const StoreNode* op) final {
+    this->VisitExpr(op->value);
+    VisitIndex(op->index);
+    this->VisitExpr(op->predicate);
+  }
+
+  void VisitStmt_(const LetStmtNode* op) final {
+    if (IsScalarIndex(op->value)) {
+      VisitIndex(op->value);
+    } else {
+      this->VisitExpr(op->value);
+    }
+    this->VisitStmt(op->body);
+  }
+
+ private:
+  void VisitIndex(const PrimExpr& index) {
+    bool in_index = in_index_;
+    in_index_ = true;
+    this->VisitExpr(index);
+    in_index_ = in_index;
+  }
+
+  std::function<bool(const PrimExpr&)> fvisit_;
+  bool in_index_{false};
+};
+
+/*! \brief Rewrite the index expressions visited by IndexVisitor. */
+class IndexMutator : public StmtExprMutator {
+ public:
+  /*! \param fmutate Called on each index sub-expression, returns the replacement if any. */
+  explicit IndexMutator(std::function<Optional<PrimExpr>(const PrimExpr&)> fmutate)
+      : fmutate_(fmutate) {}
+
+  PrimExpr VisitExpr(const PrimExpr& e) final {
+    if (in_index_) {
+      if (Optional<PrimExpr> ret = fmutate_(e)) return ret.value();
+    }
+    return StmtExprMutator::VisitExpr(e);
+  }
+
+  PrimExpr VisitExpr_(const LoadNode* op) final {
+    PrimExpr index = MutateIndex(op->index);
+    PrimExpr predicate = this->VisitExpr(op->predicate);
+    if (index.same_as(op->index) && predicate.same_as(op->predicate)) {
+      return GetRef<PrimExpr>(op);
+    }
+    return Load(op->dtype, op->buffer_var, index, predicate);
+  }
+
+  Stmt VisitStmt_(const StoreNode* op) final {
+    PrimExpr value = this->VisitExpr(op->value);
+    PrimExpr index = MutateIndex(op->index);
+    PrimExpr predicate = this->VisitExpr(op->predicate);
+    if (value.same_as(op->value) && index.same_as(op->index) &&
+        predicate.same_as(op->predicate)) {
+      return GetRef<Stmt>(op);
+    }
+    return Store(op->buffer_var, value, index, predicate);
+  }
+
+  Stmt VisitStmt_(const LetStmtNode* op) final {
+    PrimExpr value = IsScalarIndex(op->value) ? MutateIndex(op->value) : this->VisitExpr(op->value);
+    Stmt body = this->VisitStmt(op->body);
+    if (value.same_as(op->value) && body.same_as(op->body)) {
+      return GetRef<Stmt>(op);
+    }
+    return LetStmt(op->var, value, body);
+  }
+
+ private:
+  PrimExpr MutateIndex(const PrimExpr& index) {
+    bool in_index = in_index_;
+    in_index_ = true;
+    PrimExpr ret = this->VisitExpr(index);
+    in_index_ = in_index;
+    return ret;
+  }
+
+  std::function<Optional<PrimExpr>(const PrimExpr&)> fmutate_;
+  bool in_index_{false};
+};
+
+/*! \brief A floordiv/floormod of an affine function of the loop variable. */
+struct AffineDivMod {
+  /*! \brief The dividend. */
+  PrimExpr dividend;
+  /*! \brief The constant divisor. */
+  int64_t divisor;
+  /*! \brief The increment of the dividend per iteration. */
+  int64_t step;
+  /*! \brief The buffer holding [quotient, remainder]. */
+  Var counter;
+};
+
+/*!
+ * \brief Rewrite the loops from the innermost one.
+ *
+ *  The div/mod of the indices which are affine in the variable of an
+ *  innermost serial loop are replaced with a quotient and a remainder,
+ *  which are computed before the loop and updated at each iteration:
+ *
+ *  for (i, 0, n) {
+ *    B[floordiv(i, 7) * 8 + floormod(i, 7)] = ...
+ *  }
+ *
+ * into
+ *
+ *  c[0] = 0, c[1] = 0
+ *  for (i, 0, n) {
+ *    B[c[0] * 8 + c[1]] = ...
+ *    c[1] = c[1] + 1
+ *    if (c[1] >= 7) { c[1] = c[1] - 7; c[0] = c[0] + 1 }
+ *  }
+ *
+ *  Then the index sub-expressions which are invariant in a loop are hoisted
+ *  into let bindings in front of it.
+ */
+class IndexStrengthReducer : public StmtMutator {
+ public:
+  explicit IndexStrengthReducer(bool reduce_power_of_two)
+      : reduce_power_of_two_(reduce_power_of_two) {}
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    Stmt stmt = StmtMutator::VisitStmt_(op);
+    op = stmt.as<ForNode>();
+    if (op->kind == ForKind::kThreadBinding) return stmt;
+    std::unordered_set<const VarNode*> bound = BoundVars(op);
+    For loop = GetRef<For>(op);
+    std::vector<AffineDivMod> divmods;
+    if (op->kind == ForKind::kSerial && !ContainsLoop(op->body) && !is_one(op->extent)) {
+      loop = ReduceStrength(loop, bound, &divmods);
+    }
+    Stmt ret = HoistInvariant(loop, bound);
+    if (divmods.empty()) return ret;
+
+    std::vector<Stmt> seq;
+    for (const AffineDivMod& dm : divmods) {
+      DataType t = dm.dividend.dtype();
+      PrimExpr init = Substitute(dm.dividend, Map<Var, PrimExpr>{{op->loop_var, op->min}});
+      PrimExpr divisor = make_const(t, dm.divisor);
+      seq.push_back(Store(dm.counter, floordiv(init, divisor), make_const(DataType::Int(32), 0),
+                          const_true()));
+      seq.push_back(Store(dm.counter, floormod(init, divisor), make_const(DataType::Int(32), 1),
+                          const_true()));
+    }
+    seq.push_back(ret);
+    ret = SeqStmt::Flatten(seq);
+    for (const AffineDivMod& dm : divmods) {
+      ret = Allocate(dm.counter, dm.dividend.dtype(), {make_const(DataType::Int(32), 2)},
+                     const_true(), ret);
+      ret = AttrStmt(dm.counter, attr::storage_scope, StringImm("local"), ret);
+    }
+    return ret;
+  }
+
+ private:
+  For ReduceStrength(For loop, const std::unordered_set<const VarNode*>& bound,
+                     std::vector<AffineDivMod>* divmods) {
+    const Var& loop_var = loop->loop_var;
+    Map<Var, Range> iters{{loop_var, Range::FromMinExtent(loop->min, loop->extent)}};
+    auto fmatch = [&](const PrimExpr& e, bool create) -> Optional<PrimExpr> {
+      PrimExpr a, b;
+      int index;
+      if (const FloorDivNode* op = e.as<FloorDivNode>()) {
+        a = op->a, b = op->b, index = 0;
+      } else if (const FloorModNode* op = e.as<FloorModNode>()) {
+        a = op->a, b = op->b, index = 1;
+      } else {
+        return NullOpt;
+      }
+      const int64_t* divisor = as_const_int(b);
+      if (!IsScalarIndex(e) || divisor == nullptr || *divisor < 2 ||
+          (!reduce_power_of_two_ && (*divisor & (*divisor - 1)) == 0) ||
+          !ExprUseVar(a, loop_var) ||
+          ExprUseVar(a, [&](const VarNode* v) { return bound.count(v) && v != loop_var.get(); })) {
+        return NullOpt;
+      }
+      for (const AffineDivMod& dm : *divmods) {
+        if (dm.divisor == *divisor && ExprDeepEqual()(dm.dividend, a)) {
+          return Load(e.dtype(), dm.counter, make_const(DataType::Int(32), index), const_true());
+        }
+      }
+      if (!create) return NullOpt;
+      // a = step * loop_var + base, in which base is invariant in the loop.
+      Array<arith::IterSumExpr> iter_map =
+          arith::DetectIterMap({a}, iters, const_true(), false, &analyzer_);
+      if (iter_map.size() != 1 || iter_map[0]->args.size() != 1) return NullOpt;
+      const arith::IterSplitExpr& split = iter_map[0]->args[0];
+      const int64_t* step = as_const_int(split->scale);
+      if (!is_one(split->lower_factor) || step == nullptr || *step <= 0 ||
+          !analyzer_.CanProveEqual(split->extent, split->source->extent)) {
+        return NullOpt;
+      }
+      Var counter(loop_var->name_hint + ".divmod", PointerType(PrimType(e.dtype())));
+      divmods->push_back(AffineDivMod{a, *divisor, *step, counter});
+      return Load(e.dtype(), counter, make_const(DataType::Int(32), index), const_true());
+    };
+    IndexVisitor([&](const PrimExpr& e) { return fmatch(e, true).defined(); })(loop->body);
+    if (divmods->empty()) return loop;
+
+    Stmt body = IndexMutator([&](const PrimExpr& e) { return fmatch(e, false); })(loop->body);
+    std::vector<Stmt> seq{body};
+    for (const AffineDivMod& dm : *divmods) {
+      DataType t = dm.dividend.dtype();
+      PrimExpr q_index = make_const(DataType::Int(32), 0);
+      PrimExpr r_index = make_const(DataType::Int(32), 1);
+      PrimExpr q = Load(t, dm.counter, q_index, const_true());
+      PrimExpr r = Load(t, dm.counter, r_index, const_true());
+      int64_t q_step = dm.step / dm.divisor, r_step = dm.step % dm.divisor;
+      if (q_step != 0) {
+        seq.push_back(Store(dm.counter, q + make_const(t, q_step), q_index, const_true()));
+      }
+      if (r_step != 0) {
+        seq.push_back(Store(dm.counter, r + make_const(t, r_step), r_index, const_true()));
+        Stmt carry = SeqStmt({Store(dm.counter, r - make_const(t, dm.divisor), r_index,
+                                    const_true()),
+                              Store(dm.counter, q + make_const(t, 1), q_index, const_true())});
+        seq.push_back(IfThenElse(r >= make_const(t, dm.divisor), carry));
+      }
+    }
+    auto n = make_object<ForNode>(*loop.get());
+    n->body = SeqStmt::Flatten(seq);
+    return For(n);
+  }
+
+  Stmt HoistInvariant(For loop, const std::unordered_set<const VarNode*>& bound) {
+    auto finvariant = [&](const PrimExpr& e) {
+      if (!IsScalarIndex(e) || e->IsInstance<VarNode>() || e->IsInstance<IntImmNode>()) {
+        return false;
+      }
+      bool hoistable = true;
+      PostOrderVisit(e, [&](const ObjectRef& node) {
+        if (const VarNode* v = node.as<VarNode>()) {
+          hoistable &= bound.count(v) == 0;
+        } else if (const FloorDivNode* op = node.as<FloorDivNode>()) {
+          hoistable &= IsNonZeroConst(op->b);
+        } else if (const FloorModNode* op = node.as<FloorModNode>()) {
+          hoistable &= IsNonZeroConst(op->b);
+        } else if (const DivNode* op = node.as<DivNode>()) {
+          hoistable &= IsNonZeroConst(op->b);
+        } else if (const ModNode* op = node.as<ModNode>()) {
+          hoistable &= IsNonZeroConst(op->b);
+        } else {
+          // pure integer arithmetic only.
+          hoistable &= node->IsInstance<IntImmNode>() || node->IsInstance<AddNode>() ||
+                       node->IsInstance<SubNode>() || node->IsInstance<MulNode>() ||
+                       node->IsInstance<MinNode>() || node->IsInstance<MaxNode>() ||
+                       node->IsInstance<CastNode>();
+        }
+      });
+      return hoistable;
+    };
+
+    std::vector<std::pair<Var, PrimExpr>> invariants;
+    auto fmatch = [&](const PrimExpr& e) -> Optional<PrimExpr> {
+      for (const auto& kv : invariants) {
+        if (ExprDeepEqual()(kv.second, e)) return kv.first;
+      }
+      return NullOpt;
+    };
+    IndexVisitor([&](const PrimExpr& e) {
+      if (!finvariant(e)) return false;
+      if (!fmatch(e).defined()) {
+        invariants.emplace_back(Var(loop->loop_var->name_hint + ".inv", e.dtype()), e);
+      }
+      return true;
+    })(loop->body);
+    if (invariants.empty()) return std::move(loop);
+
+    auto n = make_object<ForNode>(*loop.get());
+    n->body = IndexMutator(fmatch)(loop->body);
+    Stmt ret = For(n);
+    for (auto it = invariants.rbegin(); it != invariants.rend(); ++it) {
+      ret = LetStmt(it->first, it->second, ret);
+    }
+    return ret;
+  }
+
+  /*! \return The loop variable and the variables defined in the loop. */
+  static std::unordered_set<const VarNode*> BoundVars(const ForNode* loop) {
+    std::unordered_set<const VarNode*> bound{loop->loop_var.get()};
+    PostOrderVisit(loop->body, [&](const ObjectRef& node) {
+      if (const LetStmtNode* op = node.as<LetStmtNode>()) {
+        bound.insert(op->var.get());
+      } else if (const LetNode* op = node.as<LetNode>()) {
+        bound.insert(op->var.get());
+      } else if (const ForNode* op = node.as<ForNode>()) {
+        bound.insert(op->loop_var.get());
+      } else if (const AllocateNode* op = node.as<AllocateNode>()) {
+        bound.insert(op->buffer_var.get());
+      } else if (const AttrStmtNode* op = node.as<AttrStmtNode>()) {
+        if (const IterVarNode* iv = op->node.as<IterVarNode>()) {
+          bound.insert(iv->var.get());
+        }
+      }
+    });
+    return bound;
+  }
+
+  static bool ContainsLoop(const Stmt& stmt) {
+    bool found = false;
+    PostOrderVisit(stmt, [&](const ObjectRef& node) { found |= node->IsInstance<ForNode>(); });
+    return found;
+  }
+
+  static bool IsNonZeroConst(const PrimExpr& e) {
+    const int64_t* value = as_const_int(e);
+    return value != nullptr && *value != 0;
+  }
+
+  // whether to reduce the div/mod by powers of two.
+  bool reduce_power_of_two_;
+  // analyzer
+  arith::Analyzer analyzer_;
+};
+
+namespace transform {
+
+Pass IndexStrengthReduction() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    auto cfg = ctx->GetConfig<IndexStrengthReductionConfig>("tir.IndexStrengthReduction");
+    if (!cfg.defined()) {
+      cfg = AttrsWithDefaultValues<IndexStrengthReductionConfig>();
+    }
+    auto* n = f.CopyOnWrite();
+    n->body = IndexStrengthReducer(cfg.value()->reduce_power_of_two)(std::move(n->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.IndexStrengthReduction", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.IndexStrengthReduction")
+    .set_body_typed(IndexStrengthReduction);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
@@ -0,0 +1,331 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file inject_software_prefetch.cc
+ * \brief Prefetch the strided and indirect loads of the innermost loops
+ *  a few iterations ahead on CPU targets.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/arith/pattern.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/target/target.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/expr.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <cstdlib>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../../runtime/thread_storage_scope.h"
+
+namespace tvm {
+namespace tir {
+
+using runtime::StorageRank;
+using runtime::StorageScope;
+
+struct InjectSoftwarePrefetchConfigNode
+    : public tvm::AttrsNode<InjectSoftwarePrefetchConfigNode> {
+  int distance;
+  int cache_line_bytes;
+  int max_prefetch_per_loop;
+
+  TVM_DECLARE_ATTRS(InjectSoftwarePrefetchConfigNode,
+                    "tir.transform.InjectSoftwarePrefetchConfig") {
+    TVM_ATTR_FIELD(distance)
+        .describe("The number of loop iterations to prefetch ahead")
+        .set_default(16);
+    TVM_ATTR_FIELD(cache_line_bytes)
+        .describe("The size of the cache line. Loads with a smaller stride are left to the "
+                  "hardware prefetcher")
+        .set_default(64);
+    TVM_ATTR_FIELD(max_prefetch_per_loop)
+        .describe("The maximum number of prefetches inserted in a loop")
+        .set_default(4);
+  }
+};
+
+class InjectSoftwarePrefetchConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(InjectSoftwarePrefetchConfig, Attrs,
+                                            InjectSoftwarePrefetchConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(InjectSoftwarePrefetchConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.InjectSoftwarePrefetch", InjectSoftwarePrefetchConfig);
+
+/*! \brief Collect the loads in the body of an innermost loop. */
+class LoopLoadCollector : public StmtExprVisitor {
+ public:
+  /*! \brief A load in the loop body. */
+  struct Entry {
+    const LoadNode* load;
+    /*! \brief Whether the load only happens under a condition. */
+    bool conditional;
+  };
+
+  void VisitStmt_(const ForNode* op) final { has_inner_loop_ = true; }
+
+  void VisitStmt_(const WhileNode* op) final { has_inner_loop_ = true; }
+
+  void VisitStmt_(const LetStmtNode* op) final {
+    local_vars_.insert(op->var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const LetNode* op) final {
+    local_vars_.insert(op->var.get());
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const AllocateNode* op) final {
+    local_vars_.insert(op->buffer_var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const StoreNode* op) final {
+    written_.insert(op->buffer_var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const IfThenElseNode* op) final {
+    this->VisitExpr(op->condition);
+    ++condition_depth_;
+    this->VisitStmt(op->then_case);
+    if (op->else_case.defined()) this->VisitStmt(op->else_case);
+    --condition_depth_;
+  }
+
+  void VisitExpr_(const SelectNode* op) final {
+    this->VisitExpr(op->condition);
+    ++condition_depth_;
+    this->VisitExpr(op->true_value);
+    this->VisitExpr(op->false_value);
+    --condition_depth_;
+  }
+
+  void VisitExpr_(const CallNode* op) final {
+    if (op->op.same_as(builtin::if_then_else())) {
+      this->VisitExpr(op->args[0]);
+      ++condition_depth_;
+      this->VisitExpr(op->args[1]);
+      this->VisitExpr(op->args[2]);
+      --condition_depth_;
+    } else {
+      StmtExprVisitor::VisitExpr_(op);
+    }
+  }
+
+  void VisitExpr_(const LoadNode* op) final {
+    loads_.push_back(Entry{op, condition_depth_ != 0});
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  /*! \brief The loads, in the order of visit. */
+  std::vector<Entry> loads_;
+  /*! \brief The variables defined in the loop body. */
+  std::unordered_set<const VarNode*> local_vars_;
+  /*! \brief The buffers written in the loop body. */
+  std::unordered_set<const VarNode*> written_;
+  /*! \brief Whether the loop body contains another loop. */
+  bool has_inner_loop_{false};
+
+ private:
+  int condition_depth_{0};
+};
+
+/*!
+ * \brief Insert prefetches into the innermost serial loops.
+ *
+ *  Two kinds of loads are prefetched `distance` iterations ahead:
+ *  - strided loads, whose address advances by at least a cache line in each
+ *    iteration, so that the hardware prefetcher is unlikely to catch them;
+ *  - indirect loads, whose address depends on a load of another buffer with
+ *    an affine index, e.g. A[B[i]]. These prefetches are guarded by the loop
+ *    bound, since computing their address reads the index buffer.
+ */
+class SoftwarePrefetchInjector : public StmtExprMutator {
+ public:
+  explicit SoftwarePrefetchInjector(const InjectSoftwarePrefetchConfig& cfg) : cfg_(cfg) {}
+
+  Stmt VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::storage_scope) {
+      const VarNode* buf = op->node.as<VarNode>();
+      storage_scope_[buf] = StorageScope::Create(op->value.as<StringImmNode>()->value);
+    }
+    return StmtExprMutator::VisitStmt_(op);
+  }
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    Stmt stmt = StmtExprMutator::VisitStmt_(op);
+    op = stmt.as<ForNode>();
+    if (op->kind != ForKind::kSerial) return stmt;
+    if (const auto* extent = op->extent.as<IntImmNode>()) {
+      if (extent->value <= cfg_->distance) return stmt;
+    }
+
+    LoopLoadCollector collector;
+    collector(op->body);
+    if (collector.has_inner_loop_) return stmt;
+
+    std::vector<Stmt> prefetches;
+    prefetched_.clear();
+    for (const LoopLoadCollector::Entry& entry : collector.loads_) {
+      if (static_cast<int>(prefetches.size()) >= cfg_->max_prefetch_per_loop) break;
+      Stmt prefetch = MakePrefetch(op, entry, collector);
+      if (prefetch.defined()) prefetches.push_back(prefetch);
+    }
+    if (prefetches.empty()) return stmt;
+
+    prefetches.push_back(op->body);
+    auto n = CopyOnWrite(op);
+    n->body = SeqStmt::Flatten(prefetches);
+    return Stmt(n);
+  }
+
+ private:
+  bool IsGlobal(const VarNode* buffer_var) const {
+    auto it = storage_scope_.find(buffer_var);
+    return it == storage_scope_.end() || it->second.rank == StorageRank::kGlobal;
+  }
+
+  /*! \brief Whether the expression uses a variable defined in the loop body. */
+  static bool UseLocalVar(const PrimExpr& expr, const LoopLoadCollector& collector) {
+    return ExprUseVar(expr, [&collector](const VarNode* var) {
+      return collector.local_vars_.count(var) != 0;
+    });
+  }
+
+  /*! \return The stride of the index w.r.t. the loop var, or nullptr if it is not affine. */
+  static const IntImmNode* GetStride(const PrimExpr& index, const Var& loop_var) {
+    Array<PrimExpr> coeff = arith::DetectLinearEquation(index, {loop_var});
+    if (coeff.empty()) return nullptr;
+    return coeff[0].as<IntImmNode>();
+  }
+
+  /*! \brief Whether the index reads another buffer with an affine index. */
+  bool IsIndirect(const PrimExpr& index, const Var& loop_var,
+                  const LoopLoadCollector& collector) const {
+    bool indirect = false, valid = true;
+    PostOrderVisit(index, [&](const ObjectRef& node) {
+      const auto* load = node.as<LoadNode>();
+      if (load == nullptr) return;
+      PrimExpr base = load->index;
+      if (const auto* ramp = base.as<RampNode>()) base = ramp->base;
+      bool nested = false;
+      PostOrderVisit(base, [&nested](const ObjectRef& n) { nested |= n->IsInstance<LoadNode>(); });
+      if (nested || collector.written_.count(load->buffer_var.get()) ||
+          GetStride(base, loop_var) == nullptr) {
+        valid = false;
+      } else if (ExprUseVar(base, loop_var)) {
+        indirect = true;
+      }
+    });
+    return valid && indirect;
+  }
+
+  Stmt MakePrefetch(const ForNode* loop, const LoopLoadCollector::Entry& entry,
+                    const LoopLoadCollector& collector) {
+    const LoadNode* load = entry.load;
+    const Var& loop_var = loop->loop_var;
+    if (!IsGlobal(load->buffer_var.get()) || collector.local_vars_.count(load->buffer_var.get()) ||
+        UseLocalVar(load->index, collector)) {
+      return Stmt();
+    }
+    PrimExpr base = load->index;
+    if (const auto* ramp = base.as<RampNode>()) base = ramp->base;
+    DataType dtype = load->dtype.element_of();
+
+    bool has_load = false;
+    PostOrderVisit(base,
+                   [&has_load](const ObjectRef& n) { has_load |= n->IsInstance<LoadNode>(); });
+    bool indirect = false;
+    if (!has_load) {
+      const IntImmNode* stride = GetStride(base, loop_var);
+      if (stride == nullptr || std::abs(stride->value) * dtype.bytes() < cfg_->cache_line_bytes) {
+        return Stmt();
+      }
+    } else if (!entry.conditional && IsIndirect(base, loop_var, collector)) {
+      indirect = true;
+    } else {
+      return Stmt();
+    }
+
+    PrimExpr ahead = loop_var + make_const(loop_var.dtype(), cfg_->distance);
+    PrimExpr addr = analyzer_.Simplify(Substitute(base, Map<Var, PrimExpr>{{loop_var, ahead}}));
+    // skip the addresses in the same cache line as one that is already prefetched.
+    for (const auto& kv : prefetched_) {
+      if (!kv.first.same_as(load->buffer_var) || kv.second.dtype() != addr.dtype()) continue;
+      if (const auto* diff = analyzer_.Simplify(addr - kv.second).as<IntImmNode>()) {
+        if (std::abs(diff->value) * dtype.bytes() < cfg_->cache_line_bytes) return Stmt();
+      }
+    }
+    prefetched_.emplace_back(load->buffer_var, addr);
+
+    PrimExpr address = Call(DataType::Handle(), builtin::address_of(),
+                            {Load(dtype, load->buffer_var, addr, const_true())});
+    Stmt prefetch = Evaluate(Call(dtype, builtin::prefetch(), {address, 0, 3, 1}));
+    if (indirect) {
+      prefetch = IfThenElse(ahead < loop->min + loop->extent, prefetch);
+    }
+    return prefetch;
+  }
+
+  /*! \brief The config. */
+  InjectSoftwarePrefetchConfig cfg_;
+  /*! \brief The storage scope of the allocated buffers. */
+  std::unordered_map<const VarNode*, StorageScope> storage_scope_;
+  /*! \brief The addresses prefetched in the current loop. */
+  std::vector<std::pair<Var, PrimExpr>> prefetched_;
+  /*! \brief The analyzer. */
+  arith::Analyzer analyzer_;
+};
+
+namespace transform {
+
+Pass InjectSoftwarePrefetch() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    // The prefetch intrinsic is only lowered by the LLVM backend.
+    auto target = f->GetAttr<Target>(tvm::attr::kTarget);
+    if (!target.defined() || target.value()->kind->name != "llvm") return f;
+    auto cfg = ctx->GetConfig<InjectSoftwarePrefetchConfig>("tir.InjectSoftwarePrefetch");
+    if (!cfg.defined()) {
+      cfg = AttrsWithDefaultValues<InjectSoftwarePrefetchConfig>();
+    }
+    auto* n = f.CopyOnWrite();
+    n->body = SoftwarePrefetchInjector(cfg.value())(std::move(n->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.InjectSoftwarePrefetch", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.InjectSoftwarePrefetch")
+    .set_body_typed(InjectSoftwarePrefetch);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
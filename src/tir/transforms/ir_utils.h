@@ -168,6 +168,13 @@ inline int GetTempAllocaAlignment(DataType type, int32_t const_size) {
  */
 Stmt ConvertSSA(Stmt stmt);
 
+/*!
+ * \brief Vectorize the loops of kind kVectorized in a statement.
+ * \param stmt The source statement.
+ * \return The vectorized statement.
+ */
+Stmt VectorizeLoop(Stmt stmt);
+
 }  // namespace tir
 }  // namespace tvm
 #endif  // TVM_TIR_TRANSFORMS_IR_UTILS_H_
@@ -109,7 +109,13 @@ class CandidateSelector final : public StmtExprVisitor {
 
   void VisitStmt_(const ForNode* op) final {
     // partition const loop when sets partition_const_loop_
-    if (!is_const_int(op->min) || !is_const_int(op->extent) || partition_const_loop_) {
+    bool partition = !is_const_int(op->min) || !is_const_int(op->extent) || partition_const_loop_;
+    // the annotation of the loop overrides the default.
+    auto it = op->annotations.find(attr::pragma_loop_partition);
+    if (it != op->annotations.end()) {
+      partition = Downcast<Integer>((*it).second)->value != 0;
+    }
+    if (partition) {
       const VarNode* var = op->loop_var.get();
       record_.insert({var, false});
       StmtExprVisitor::VisitStmt_(op);
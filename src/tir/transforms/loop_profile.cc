@@ -0,0 +1,250 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file loop_profile.cc
+ * \brief Profile-guided loop unrolling and partitioning.
+ *
+ *  An instrumented build records the trip count and the time of every loop
+ *  at runtime (src/runtime/loop_profile.cc). The next build of the same
+ *  schedule reads the profile back and marks the loops for UnrollLoop and
+ *  LoopPartition.
+ */
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/expr.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+namespace tvm {
+namespace tir {
+
+struct LoopProfileConfigNode : public tvm::AttrsNode<LoopProfileConfigNode> {
+  bool instrument;
+  Map<String, Array<PrimExpr>> profile;
+  double hot_threshold;
+  double cold_threshold;
+  int max_unroll_extent;
+
+  TVM_DECLARE_ATTRS(LoopProfileConfigNode, "tir.transform.LoopProfileConfig") {
+    TVM_ATTR_FIELD(instrument)
+        .describe("Whether to instrument the loops with trip count and time counters")
+        .set_default(false);
+    TVM_ATTR_FIELD(profile)
+        .describe("The profile of an instrumented run, {loop key: [entries, trips, nanoseconds]}")
+        .set_default(Map<String, Array<PrimExpr>>());
+    TVM_ATTR_FIELD(hot_threshold)
+        .describe("Loops taking at least this fraction of the time of their function are hot")
+        .set_default(0.1);
+    TVM_ATTR_FIELD(cold_threshold)
+        .describe("Loops taking less than this fraction of the time of their function are cold, "
+                  "and are neither unrolled nor partitioned")
+        .set_default(0.01);
+    TVM_ATTR_FIELD(max_unroll_extent)
+        .describe("The maximum extent of a hot innermost loop to unroll")
+        .set_default(16);
+  }
+};
+
+class LoopProfileConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(LoopProfileConfig, Attrs, LoopProfileConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(LoopProfileConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.LoopProfile", LoopProfileConfig);
+
+/*!
+ * \brief Base class which names the loops of a function in pre-order,
+ *  the keys are stable across the builds of the same schedule.
+ */
+class LoopKeyMutator : public StmtMutator {
+ public:
+  explicit LoopKeyMutator(std::string symbol) : symbol_(symbol) {}
+
+ protected:
+  std::string NextKey(const ForNode* op) {
+    std::ostringstream os;
+    os << symbol_ << "/" << loop_index_++ << ":" << op->loop_var->name_hint;
+    return os.str();
+  }
+
+  // the name of the function.
+  std::string symbol_;
+
+ private:
+  // the number of visited loops.
+  int loop_index_{0};
+};
+
+/*!
+ * \brief Wrap the loops running on the host with
+ *
+ *  let start = TVMBackendLoopProfileEnter(key, extent)
+ *  for (...)
+ *  TVMBackendLoopProfileExit(key, start)
+ */
+class LoopInstrumenter : public LoopKeyMutator {
+ public:
+  using LoopKeyMutator::LoopKeyMutator;
+
+  Stmt VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::thread_extent || op->attr_key == attr::virtual_thread) {
+      ++device_depth_;
+      Stmt ret = StmtMutator::VisitStmt_(op);
+      --device_depth_;
+      return ret;
+    }
+    return StmtMutator::VisitStmt_(op);
+  }
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    std::string key = NextKey(op);
+    // calls inside a vectorized loop would scalarize it.
+    bool skip = vectorized_depth_ > 0 || device_depth_ > 0 || op->kind == ForKind::kThreadBinding;
+    if (op->kind == ForKind::kVectorized) ++vectorized_depth_;
+    Stmt stmt = StmtMutator::VisitStmt_(op);
+    if (op->kind == ForKind::kVectorized) --vectorized_depth_;
+    if (skip) return stmt;
+
+    Var start(op->loop_var->name_hint + ".start", DataType::Int(64));
+    PrimExpr enter = Call(DataType::Int(64), builtin::call_extern(),
+                          {StringImm("TVMBackendLoopProfileEnter"), StringImm(key),
+                           cast(start.dtype(), op->extent)});
+    Stmt exit = Evaluate(Call(DataType::Int(32), builtin::call_extern(),
+                              {StringImm("TVMBackendLoopProfileExit"), StringImm(key), start}));
+    return LetStmt(start, enter, SeqStmt({stmt, exit}));
+  }
+
+ private:
+  // the depth of device scopes.
+  int device_depth_{0};
+  // the depth of vectorized loops.
+  int vectorized_depth_{0};
+};
+
+/*!
+ * \brief Mark the loops according to their share of the time of the function.
+ *
+ *  - cold loops are neither unrolled nor partitioned, to keep the code compact.
+ *  - hot innermost loops with a small constant extent are unrolled.
+ *  - hot loops with likely conditions are partitioned, which hoists the
+ *    conditions out of the main part of the loop.
+ */
+class LoopProfileApplier : public LoopKeyMutator {
+ public:
+  LoopProfileApplier(std::string symbol, const LoopProfileConfigNode* cfg)
+      : LoopKeyMutator(symbol), cfg_(cfg) {
+    // approximate the time of the function with its slowest loop.
+    std::string prefix = symbol_ + "/";
+    for (const auto& kv : cfg->profile) {
+      if (kv.first.operator std::string().compare(0, prefix.size(), prefix) == 0) {
+        root_nanos_ = std::max(root_nanos_, Counter(kv.second, 2));
+      }
+    }
+  }
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    std::string key = NextKey(op);
+    Stmt stmt = StmtMutator::VisitStmt_(op);
+    auto it = cfg_->profile.find(key);
+    if (it == cfg_->profile.end() || root_nanos_ <= 0) return stmt;
+    double share = Counter((*it).second, 2) / root_nanos_;
+    op = stmt.as<ForNode>();
+    auto n = CopyOnWrite(op);
+    if (share < cfg_->cold_threshold) {
+      n->annotations.Set(attr::pragma_loop_partition, Integer(0));
+      return AttrStmt(n->loop_var, "pragma_auto_unroll_max_step", Integer(0), For(n));
+    }
+    if (share >= cfg_->hot_threshold) {
+      const int64_t* extent = as_const_int(n->extent);
+      if (n->kind == ForKind::kSerial && extent != nullptr && *extent <= cfg_->max_unroll_extent &&
+          !ContainsLoop(n->body)) {
+        n->kind = ForKind::kUnrolled;
+      }
+      if (ContainsLikely(n->body)) {
+        n->annotations.Set(attr::pragma_loop_partition, Integer(1));
+      }
+    }
+    return For(n);
+  }
+
+ private:
+  static double Counter(const Array<PrimExpr>& counters, size_t index) {
+    ICHECK_EQ(counters.size(), 3U) << "A loop profile is [entries, trips, nanoseconds]";
+    if (const FloatImmNode* imm = counters[index].as<FloatImmNode>()) {
+      return imm->value;
+    }
+    const int64_t* value = as_const_int(counters[index]);
+    ICHECK(value != nullptr) << "A loop profile is [entries, trips, nanoseconds]";
+    return static_cast<double>(*value);
+  }
+
+  static bool ContainsLoop(const Stmt& stmt) {
+    bool found = false;
+    PostOrderVisit(stmt, [&](const ObjectRef& node) { found |= node->IsInstance<ForNode>(); });
+    return found;
+  }
+
+  static bool ContainsLikely(const Stmt& stmt) {
+    bool found = false;
+    PostOrderVisit(stmt, [&](const ObjectRef& node) {
+      if (const CallNode* call = node.as<CallNode>()) {
+        found |= call->op.same_as(builtin::likely());
+      }
+    });
+    return found;
+  }
+
+  // the config.
+  const LoopProfileConfigNode* cfg_;
+  // the time of the function.
+  double root_nanos_{0};
+};
+
+namespace transform {
+
+Pass LoopProfile() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    auto cfg = ctx->GetConfig<LoopProfileConfig>("tir.LoopProfile");
+    if (!cfg.defined()) return f;
+    auto global_symbol = f->GetAttr<String>(tvm::attr::kGlobalSymbol);
+    if (!global_symbol.defined()) return f;
+    auto* n = f.CopyOnWrite();
+    if (cfg.value()->instrument) {
+      n->body = LoopInstrumenter(global_symbol.value())(std::move(n->body));
+    } else if (cfg.value()->profile.size() != 0) {
+      n->body = LoopProfileApplier(global_symbol.value(), cfg.value().get())(std::move(n->body));
+    }
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.LoopProfile", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.LoopProfile").set_body_typed(LoopProfile);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
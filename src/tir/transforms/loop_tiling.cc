@@ -0,0 +1,344 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file loop_tiling.cc
+ * \brief Tile and reorder perfectly nested loops so that the data
+ *  touched by a tile fits into the L1/L2 cache.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/arith/bound.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/expr.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tvm {
+namespace tir {
+
+struct LoopTilingConfigNode : public tvm::AttrsNode<LoopTilingConfigNode> {
+  int l1_cache_bytes;
+  int l2_cache_bytes;
+
+  TVM_DECLARE_ATTRS(LoopTilingConfigNode, "tir.transform.LoopTilingConfig") {
+    TVM_ATTR_FIELD(l1_cache_bytes)
+        .describe("The size of the L1 data cache that the innermost tiles should fit in")
+        .set_default(32768);
+    TVM_ATTR_FIELD(l2_cache_bytes)
+        .describe("The size of the L2 cache that the outer tiles should fit in")
+        .set_default(262144);
+  }
+};
+
+class LoopTilingConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(LoopTilingConfig, Attrs, LoopTilingConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(LoopTilingConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.LoopTiling", LoopTilingConfig);
+
+/*!
+ * \brief Collect the buffer accesses in the body of a loop band and check
+ *  whether they can be analyzed.
+ */
+class BandAccessCollector : public StmtExprVisitor {
+ public:
+  void VisitStmt_(const BufferStoreNode* op) final {
+    AddBuffer(op->buffer);
+    stores_[op->buffer.get()].push_back(op->indices);
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const BufferLoadNode* op) final {
+    AddBuffer(op->buffer);
+    loads_[op->buffer.get()].push_back(op->indices);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const StoreNode* op) final {
+    // flattened accesses are not handled.
+    unsafe_ = true;
+  }
+
+  void VisitExpr_(const LoadNode* op) final { unsafe_ = true; }
+
+  void VisitExpr_(const CallNode* op) final {
+    if (SideEffect(GetRef<Call>(op)) > CallEffectKind::kReadState) {
+      unsafe_ = true;
+    }
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::thread_extent || op->attr_key == attr::virtual_thread) {
+      unsafe_ = true;
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  /*! \brief The buffers touched, in the order of the first access. */
+  std::vector<Buffer> buffers_;
+  /*! \brief The indices of the stores of each buffer. */
+  std::unordered_map<const BufferNode*, std::vector<Array<PrimExpr>>> stores_;
+  /*! \brief The indices of the loads of each buffer. */
+  std::unordered_map<const BufferNode*, std::vector<Array<PrimExpr>>> loads_;
+  /*! \brief Whether the body contains something that prevents tiling. */
+  bool unsafe_{false};
+
+ private:
+  void AddBuffer(const Buffer& buffer) {
+    if (visited_.insert(buffer.get()).second) {
+      buffers_.push_back(buffer);
+    }
+  }
+
+  std::unordered_set<const BufferNode*> visited_;
+};
+
+/*!
+ * \brief Tile the perfectly nested serial loops with constant extents.
+ *
+ *  For each band, the tile sizes are shrunk until the footprint of a tile,
+ *  computed with DomainTouched, fits into the L2 cache, and the tiles are tiled
+ *  again to fit into the L1 cache. The loops of the band are then reordered
+ *  as [L2 tiles, L1 tiles, points].
+ *
+ *  Only the bands in which every iteration writes distinct elements are
+ *  tiled freely. A loop that does not appear in the indices of a written buffer
+ *  accumulates into it, and only the outermost of these loops can be tiled,
+ *  so that each element is still updated in the same order.
+ */
+class LoopTiler : public StmtExprMutator {
+ public:
+  LoopTiler(int64_t l1_cache_bytes, int64_t l2_cache_bytes)
+      : l1_cache_bytes_(l1_cache_bytes), l2_cache_bytes_(l2_cache_bytes) {}
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    std::vector<const ForNode*> band;
+    Stmt body = GetRef<Stmt>(op);
+    while (const auto* loop = body.as<ForNode>()) {
+      if (!IsTileable(loop)) break;
+      band.push_back(loop);
+      body = loop->body;
+    }
+    if (band.size() >= 2) {
+      Stmt tiled = TileBand(band, body);
+      if (tiled.defined()) return tiled;
+    }
+    return StmtExprMutator::VisitStmt_(op);
+  }
+
+ private:
+  static bool IsTileable(const ForNode* loop) {
+    return loop->kind == ForKind::kSerial && !loop->thread_binding.defined() &&
+           loop->annotations.empty() && is_zero(loop->min) && loop->extent.as<IntImmNode>() &&
+           loop->extent.as<IntImmNode>()->value > 1;
+  }
+
+  /*!
+   * \brief Decide which loops of the band can be tiled.
+   * \return Whether any loop of the band can be tiled.
+   */
+  static bool GetTileableLoops(const std::vector<const ForNode*>& band,
+                               const BandAccessCollector& access, std::vector<bool>* tileable) {
+    if (access.unsafe_ || access.stores_.empty()) return false;
+    ExprDeepEqual deep_equal;
+    auto same_indices = [&deep_equal](const Array<PrimExpr>& lhs, const Array<PrimExpr>& rhs) {
+      if (lhs.size() != rhs.size()) return false;
+      for (size_t i = 0; i < lhs.size(); ++i) {
+        if (!deep_equal(lhs[i], rhs[i])) return false;
+      }
+      return true;
+    };
+    std::vector<bool> is_reduce(band.size(), false);
+    for (const auto& kv : access.stores_) {
+      const Array<PrimExpr>& indices = kv.second[0];
+      // all the accesses to a written buffer must touch the same element.
+      for (const Array<PrimExpr>& other : kv.second) {
+        if (!same_indices(indices, other)) return false;
+      }
+      auto it = access.loads_.find(kv.first);
+      if (it != access.loads_.end()) {
+        for (const Array<PrimExpr>& other : it->second) {
+          if (!same_indices(indices, other)) return false;
+        }
+      }
+      for (size_t i = 0; i < band.size(); ++i) {
+        const Var& var = band[i]->loop_var;
+        bool used = false, used_as_index = false;
+        for (const PrimExpr& index : indices) {
+          if (index.same_as(var)) {
+            used_as_index = true;
+          } else if (ExprUseVar(index, var)) {
+            used = true;
+          }
+        }
+        // the written elements must be a projection of the iteration space.
+        if (used) return false;
+        if (!used_as_index) is_reduce[i] = true;
+      }
+    }
+    tileable->assign(band.size(), true);
+    bool seen_reduce = false;
+    for (size_t i = 0; i < band.size(); ++i) {
+      if (is_reduce[i]) {
+        (*tileable)[i] = !seen_reduce;
+        seen_reduce = true;
+      }
+    }
+    return true;
+  }
+
+  /*! \brief The number of bytes touched by a tile of the band. */
+  static int64_t Footprint(const std::vector<const ForNode*>& band, const Stmt& body,
+                           const std::vector<Buffer>& buffers, const std::vector<int64_t>& tiles) {
+    Stmt nest = body;
+    for (size_t i = band.size(); i != 0; --i) {
+      const Var& var = band[i - 1]->loop_var;
+      nest = For(var, make_zero(var.dtype()), make_const(var.dtype(), tiles[i - 1]),
+                 ForKind::kSerial, nest);
+    }
+    arith::Analyzer analyzer;
+    int64_t total = 0;
+    for (const Buffer& buffer : buffers) {
+      int64_t bytes = buffer->dtype.bytes() * buffer->dtype.lanes();
+      for (const Range& range : arith::DomainTouched(nest, buffer, true, true)) {
+        if (!range.defined()) return std::numeric_limits<int64_t>::max();
+        const auto* extent = analyzer.Simplify(range->extent).as<IntImmNode>();
+        if (extent == nullptr) return std::numeric_limits<int64_t>::max();
+        bytes *= extent->value;
+      }
+      total += bytes;
+    }
+    return total;
+  }
+
+  /*!
+   * \brief Shrink the tile sizes until the footprint fits into the capacity.
+   *
+   *  Each step shrinks the largest tile, the outer loop first on a tie,
+   *  to the next smaller divisor of its initial size.
+   */
+  static std::vector<int64_t> ShrinkToFit(const std::vector<const ForNode*>& band,
+                                          const Stmt& body, const std::vector<Buffer>& buffers,
+                                          const std::vector<bool>& tileable,
+                                          const std::vector<int64_t>& init, int64_t capacity) {
+    std::vector<int64_t> tiles = init;
+    while (Footprint(band, body, buffers, tiles) > capacity) {
+      int best = -1;
+      for (size_t i = 0; i < band.size(); ++i) {
+        if (tileable[i] && tiles[i] > 1 && (best == -1 || tiles[i] > tiles[best])) {
+          best = static_cast<int>(i);
+        }
+      }
+      if (best == -1) break;
+      int64_t next = tiles[best] - 1;
+      while (init[best] % next != 0) --next;
+      tiles[best] = next;
+    }
+    return tiles;
+  }
+
+  Stmt TileBand(const std::vector<const ForNode*>& band, const Stmt& body) {
+    BandAccessCollector access;
+    access(body);
+    std::vector<bool> tileable;
+    if (!GetTileableLoops(band, access, &tileable)) return Stmt();
+
+    std::vector<int64_t> extents;
+    for (const ForNode* loop : band) {
+      extents.push_back(loop->extent.as<IntImmNode>()->value);
+    }
+    if (Footprint(band, body, access.buffers_, extents) == std::numeric_limits<int64_t>::max()) {
+      return Stmt();
+    }
+    std::vector<int64_t> l2_tiles =
+        ShrinkToFit(band, body, access.buffers_, tileable, extents, l2_cache_bytes_);
+    std::vector<int64_t> l1_tiles =
+        ShrinkToFit(band, body, access.buffers_, tileable, l2_tiles, l1_cache_bytes_);
+    if (l1_tiles == extents) return Stmt();
+
+    // Loops of each level, from the outermost level.
+    std::vector<std::vector<For>> levels(3);
+    std::unordered_map<const VarNode*, PrimExpr> vmap;
+    for (size_t i = 0; i < band.size(); ++i) {
+      const Var& var = band[i]->loop_var;
+      DataType dtype = var.dtype();
+      int64_t factors[3] = {extents[i] / l2_tiles[i], l2_tiles[i] / l1_tiles[i], l1_tiles[i]};
+      const char* suffixes[3] = {".outer", ".mid", ".inner"};
+      int64_t stride = extents[i];
+      PrimExpr value;
+      for (int level = 0; level < 3; ++level) {
+        stride /= factors[level];
+        if (factors[level] == 1) continue;
+        Var level_var = var.copy_with_suffix(suffixes[level]);
+        PrimExpr term = stride == 1 ? PrimExpr(level_var) : level_var * make_const(dtype, stride);
+        value = value.defined() ? value + term : term;
+        levels[level].push_back(For(level_var, make_zero(dtype), make_const(dtype, factors[level]),
+                                    ForKind::kSerial, Evaluate(0)));
+      }
+      vmap[var.get()] = value;
+    }
+
+    Stmt ret = Substitute(body, vmap);
+    for (size_t level = levels.size(); level != 0; --level) {
+      const std::vector<For>& loops = levels[level - 1];
+      for (size_t i = loops.size(); i != 0; --i) {
+        const For& loop = loops[i - 1];
+        ret = For(loop->loop_var, loop->min, loop->extent, loop->kind, ret);
+      }
+    }
+    return ret;
+  }
+
+  /*! \brief The capacity of the L1 cache in bytes. */
+  int64_t l1_cache_bytes_;
+  /*! \brief The capacity of the L2 cache in bytes. */
+  int64_t l2_cache_bytes_;
+};
+
+namespace transform {
+
+Pass LoopTiling() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    auto* n = f.CopyOnWrite();
+    auto cfg = ctx->GetConfig<LoopTilingConfig>("tir.LoopTiling");
+    if (!cfg.defined()) {
+      cfg = AttrsWithDefaultValues<LoopTilingConfig>();
+    }
+    n->body = LoopTiler(cfg.value()->l1_cache_bytes, cfg.value()->l2_cache_bytes)(n->body);
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.LoopTiling", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.LoopTiling").set_body_typed(LoopTiling);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
@@ -35,6 +35,24 @@ namespace arith {
 
 using namespace tir;
 
+struct SimplifyConfigNode : public tvm::AttrsNode<SimplifyConfigNode> {
+  bool enable_memo;
+
+  TVM_DECLARE_ATTRS(SimplifyConfigNode, "tir.transform.SimplifyConfig") {
+    TVM_ATTR_FIELD(enable_memo)
+        .describe("Whether to memoize the simplification results of the analyzer")
+        .set_default(false);
+  }
+};
+
+class SimplifyConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(SimplifyConfig, Attrs, SimplifyConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(SimplifyConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.Simplify", SimplifyConfig);
+
 class StmtSimplifier : public IRMutatorWithAnalyzer {
  public:
   explicit StmtSimplifier(Analyzer* analyzer) : IRMutatorWithAnalyzer(analyzer) {}
@@ -104,7 +122,12 @@ namespace transform {
 Pass Simplify() {
   auto pass_func = [](PrimFunc f, IRModule m, PassContext ctx) {
     auto* n = f.CopyOnWrite();
+    auto cfg = ctx->GetConfig<arith::SimplifyConfig>("tir.Simplify");
+    if (!cfg.defined()) {
+      cfg = AttrsWithDefaultValues<arith::SimplifyConfig>();
+    }
     arith::Analyzer analyzer;
+    analyzer.EnableMemo(cfg.value()->enable_memo);
     n->body = arith::StmtSimplifier(&analyzer).Simplify(std::move(n->body));
     return f;
   };
@@ -0,0 +1,173 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file specialize_shapes.cc
+ * \brief Specialize the body of a function on the values of its symbolic
+ *  shapes, and dispatch among the variants at call time.
+ */
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/expr.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <unordered_set>
+#include <vector>
+
+#include "ir_utils.h"
+
+namespace tvm {
+namespace tir {
+
+struct SpecializeShapesConfigNode : public tvm::AttrsNode<SpecializeShapesConfigNode> {
+  Map<String, Array<Integer>> hot_values;
+  Array<Integer> divisors;
+  int max_variants;
+
+  TVM_DECLARE_ATTRS(SpecializeShapesConfigNode, "tir.transform.SpecializeShapesConfig") {
+    TVM_ATTR_FIELD(hot_values)
+        .describe("The frequent values of the symbolic shapes, keyed by the name of the variable")
+        .set_default(Map<String, Array<Integer>>());
+    TVM_ATTR_FIELD(divisors)
+        .describe("The symbolic shapes are specialized for the multiples of these divisors")
+        .set_default(Array<Integer>());
+    TVM_ATTR_FIELD(max_variants)
+        .describe("The maximum number of variants of a function, including the generic one")
+        .set_default(8);
+  }
+};
+
+class SpecializeShapesConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(SpecializeShapesConfig, Attrs,
+                                            SpecializeShapesConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(SpecializeShapesConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.SpecializeShapes", SpecializeShapesConfig);
+
+/*!
+ * \brief Dispatch the body on the value of a symbolic shape n
+ *
+ *  if (n == 64) {
+ *    body[n := 64]
+ *  } else if (floormod(n, 8) == 0) {
+ *    let n.q = floordiv(n, 8)
+ *    body[n := n.q * 8]
+ *  } else {
+ *    body
+ *  }
+ *
+ *  The constant extents and the known divisibility let the later passes
+ *  unroll, vectorize and drop the loop tails of the variants.
+ */
+class ShapeSpecializer {
+ public:
+  explicit ShapeSpecializer(const SpecializeShapesConfigNode* cfg) : cfg_(cfg) {}
+
+  Stmt Specialize(const PrimFunc& f) {
+    Stmt body = f->body;
+    int num_variants = 1;
+    for (const Var& var : ShapeVars(f)) {
+      std::vector<int64_t> values;
+      auto it = cfg_->hot_values.find(var->name_hint);
+      if (it != cfg_->hot_values.end()) {
+        for (const Integer& value : (*it).second) {
+          values.push_back(value->value);
+        }
+      }
+      std::vector<int64_t> divisors;
+      for (const Integer& divisor : cfg_->divisors) {
+        if (divisor->value > 1) divisors.push_back(divisor->value);
+      }
+      // the larger divisors are tested first.
+      std::sort(divisors.begin(), divisors.end(), std::greater<int64_t>());
+      int cases = static_cast<int>(values.size() + divisors.size());
+      if (cases == 0 || num_variants * (cases + 1) > cfg_->max_variants) continue;
+      num_variants *= cases + 1;
+      body = Dispatch(var, values, divisors, body);
+    }
+    // The variants are copies of the same body, give their vars distinct definitions.
+    if (num_variants > 1) {
+      body = ConvertSSA(body);
+    }
+    return body;
+  }
+
+ private:
+  Stmt Dispatch(const Var& var, const std::vector<int64_t>& values,
+                const std::vector<int64_t>& divisors, const Stmt& body) {
+    DataType t = var.dtype();
+    Stmt ret = body;
+    for (auto it = divisors.rbegin(); it != divisors.rend(); ++it) {
+      PrimExpr divisor = make_const(t, *it);
+      Var quotient(var->name_hint + ".q", t);
+      Stmt variant = Substitute(body, Map<Var, PrimExpr>{{var, quotient * divisor}});
+      variant = LetStmt(quotient, floordiv(var, divisor), variant);
+      ret = IfThenElse(floormod(var, divisor) == make_zero(t), variant, ret);
+    }
+    for (auto it = values.rbegin(); it != values.rend(); ++it) {
+      Stmt variant = Substitute(body, Map<Var, PrimExpr>{{var, make_const(t, *it)}});
+      ret = IfThenElse(var == make_const(t, *it), variant, ret);
+    }
+    return ret;
+  }
+
+  /*! \return The symbolic dimensions of the buffers of the function. */
+  static std::vector<Var> ShapeVars(const PrimFunc& f) {
+    std::vector<Var> vars;
+    std::unordered_set<const VarNode*> visited;
+    for (const Var& param : f->params) {
+      auto it = f->buffer_map.find(param);
+      if (it == f->buffer_map.end()) continue;
+      for (const PrimExpr& dim : (*it).second->shape) {
+        const VarNode* var = dim.as<VarNode>();
+        if (var != nullptr && var->dtype.is_int() && visited.insert(var).second) {
+          vars.push_back(GetRef<Var>(var));
+        }
+      }
+    }
+    return vars;
+  }
+
+  // the config.
+  const SpecializeShapesConfigNode* cfg_;
+};
+
+namespace transform {
+
+Pass SpecializeShapes() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    auto cfg = ctx->GetConfig<SpecializeShapesConfig>("tir.SpecializeShapes");
+    if (!cfg.defined()) return f;
+    auto* n = f.CopyOnWrite();
+    n->body = ShapeSpecializer(cfg.value().get()).Specialize(f);
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.SpecializeShapes", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.SpecializeShapes").set_body_typed(SpecializeShapes);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
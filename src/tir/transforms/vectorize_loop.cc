@@ -35,9 +35,32 @@
 #include <unordered_set>
 #include <vector>
 
+#include "ir_utils.h"
+
 namespace tvm {
 namespace tir {
 
+struct VectorizeLoopConfigNode : public tvm::AttrsNode<VectorizeLoopConfigNode> {
+  bool enable_predication;
+
+  TVM_DECLARE_ATTRS(VectorizeLoopConfigNode, "tir.transform.VectorizeLoopConfig") {
+    TVM_ATTR_FIELD(enable_predication)
+        .describe(
+            "Keep if_then_else and conditional stores under a vector condition vectorized "
+            "with masked loads and stores. Only the LLVM backend supports predicated access.")
+        .set_default(false);
+  }
+};
+
+class VectorizeLoopConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(VectorizeLoopConfig, Attrs,
+                                            VectorizeLoopConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(VectorizeLoopConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.VectorizeLoop", VectorizeLoopConfig);
+
 inline PrimExpr BroadcastTo(PrimExpr e, int lanes) {
   if (e.dtype().lanes() == lanes) return e;
   if (const BroadcastNode* op = e.as<BroadcastNode>()) {
@@ -92,6 +115,85 @@ class VecAllocAccess : public StmtExprMutator {
   int var_lanes_;
 };
 
+// Guard the memory accesses of a vectorized branch with a vector mask,
+// so that the lanes where the mask is false never touch memory.
+//
+// if_then_else(c, A[i], 0) => select(c, A[i] with predicate c, 0)
+//
+// The rewrite fails when the branch contains an operation which is unsafe to
+// evaluate in the disabled lanes, an access which does not carry the lanes of
+// the mask, or a statement other than stores and lets.
+class MaskedAccessRewriter : public StmtExprMutator {
+ public:
+  explicit MaskedAccessRewriter(PrimExpr mask) : mask_(mask), lanes_(mask.dtype().lanes()) {}
+
+  bool success() const { return success_; }
+
+  Stmt VisitStmt(const Stmt& stmt) final {
+    if (!stmt->IsInstance<StoreNode>() && !stmt->IsInstance<SeqStmtNode>() &&
+        !stmt->IsInstance<LetStmtNode>()) {
+      success_ = false;
+      return stmt;
+    }
+    return StmtExprMutator::VisitStmt(stmt);
+  }
+
+  PrimExpr VisitExpr_(const LoadNode* op) final {
+    PrimExpr expr = StmtExprMutator::VisitExpr_(op);
+    op = expr.as<LoadNode>();
+    if (op->dtype.lanes() != lanes_) {
+      success_ = false;
+      return expr;
+    }
+    return Load(op->dtype, op->buffer_var, op->index, Mask(op->predicate));
+  }
+
+  Stmt VisitStmt_(const StoreNode* op) final {
+    Stmt stmt = StmtExprMutator::VisitStmt_(op);
+    op = stmt.as<StoreNode>();
+    if (op->value.dtype().lanes() != lanes_) {
+      success_ = false;
+      return stmt;
+    }
+    return Store(op->buffer_var, op->value, op->index, Mask(op->predicate));
+  }
+
+  PrimExpr VisitExpr_(const CallNode* op) final {
+    if (SideEffect(GetRef<PrimExpr>(op)) > CallEffectKind::kReadState) {
+      success_ = false;
+    }
+    return StmtExprMutator::VisitExpr_(op);
+  }
+
+  PrimExpr VisitExpr_(const DivNode* op) final { return CheckDivisor(op); }
+  PrimExpr VisitExpr_(const ModNode* op) final { return CheckDivisor(op); }
+  PrimExpr VisitExpr_(const FloorDivNode* op) final { return CheckDivisor(op); }
+  PrimExpr VisitExpr_(const FloorModNode* op) final { return CheckDivisor(op); }
+
+ private:
+  PrimExpr Mask(const PrimExpr& predicate) {
+    return is_one(predicate) ? mask_ : predicate && mask_;
+  }
+  // An integer division may trap in the disabled lanes.
+  template <typename T>
+  PrimExpr CheckDivisor(const T* op) {
+    if (!op->dtype.is_float()) {
+      const int64_t* divisor = as_const_int(op->b);
+      if (divisor == nullptr || *divisor == 0) {
+        success_ = false;
+      }
+    }
+    return StmtExprMutator::VisitExpr_(op);
+  }
+
+  // the mask of the enabled lanes.
+  PrimExpr mask_;
+  // the lanes of the mask.
+  int lanes_;
+  // whether all accesses are guarded.
+  bool success_{true};
+};
+
 // We use ExprFunctor directly instead of StmtExprMutator
 // This is because the transformation can change the dtype of the Expr
 // The existing ExprMutator transformation rules may not be well defined.
@@ -100,7 +202,8 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   using ExprFunctor::VisitExpr;
   using StmtMutator::operator();
 
-  Vectorizer(Var var, int var_lanes) : var_(var), var_lanes_(var_lanes) {
+  Vectorizer(Var var, int var_lanes, bool enable_predication)
+      : var_(var), var_lanes_(var_lanes), enable_predication_(enable_predication) {
     ramp_ = Ramp(0, 1, var_lanes);
   }
 
@@ -247,6 +350,10 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   PrimExpr MutateIfThenElseExpr_(const CallNode* op) {
     PrimExpr cond = this->VisitExpr(op->args[0]);
     if (cond.dtype().is_vector()) {
+      if (enable_predication_) {
+        PrimExpr ret = PredicateIfThenElseExpr(op, cond);
+        if (ret.defined()) return ret;
+      }
       need_scalarize_ = true;
       return GetRef<PrimExpr>(op);
     }
@@ -374,6 +481,10 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
     ICHECK(!op->condition.dtype().is_vector());
     PrimExpr condition = this->VisitExpr(op->condition);
     if (condition.dtype().is_vector()) {
+      if (enable_predication_) {
+        Stmt ret = PredicateIfThenElse(op, condition);
+        if (ret.defined()) return ret;
+      }
       return Scalarize(GetRef<Stmt>(op));
     }
     Stmt then_case = this->VisitStmt(op->then_case);
@@ -437,6 +548,41 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
     return Allocate(op->buffer_var, op->dtype, extents, condition, body);
   }
 
+  // vectorize if_then_else under a vector condition into a select of masked branches,
+  // return an undefined expr if the branches cannot be masked.
+  PrimExpr PredicateIfThenElseExpr(const CallNode* op, const PrimExpr& cond) {
+    int lanes = cond.dtype().lanes();
+    PrimExpr t = this->VisitExpr(op->args[1]);
+    PrimExpr f = this->VisitExpr(op->args[2]);
+    if (need_scalarize_ || (t.dtype().lanes() != 1 && t.dtype().lanes() != lanes) ||
+        (f.dtype().lanes() != 1 && f.dtype().lanes() != lanes)) {
+      return PrimExpr();
+    }
+    MaskedAccessRewriter true_rewriter(cond);
+    MaskedAccessRewriter false_rewriter(!cond);
+    t = true_rewriter(t);
+    f = false_rewriter(f);
+    if (!true_rewriter.success() || !false_rewriter.success()) {
+      return PrimExpr();
+    }
+    return Select(cond, BroadcastTo(t, lanes), BroadcastTo(f, lanes));
+  }
+  // vectorize an IfThenElse under a vector condition into masked stores,
+  // return an undefined stmt if the branches cannot be masked.
+  Stmt PredicateIfThenElse(const IfThenElseNode* op, const PrimExpr& condition) {
+    // evaluate the condition once, before any of the stores.
+    Var mask("mask", condition.dtype());
+    MaskedAccessRewriter then_rewriter(mask);
+    Stmt then_case = then_rewriter(this->VisitStmt(op->then_case));
+    if (!then_rewriter.success()) return Stmt();
+    if (!op->else_case.defined()) {
+      return LetStmt(mask, condition, then_case);
+    }
+    MaskedAccessRewriter else_rewriter(!mask);
+    Stmt else_case = else_rewriter(this->VisitStmt(op->else_case));
+    if (!else_rewriter.success()) return Stmt();
+    return LetStmt(mask, condition, SeqStmt({then_case, else_case}));
+  }
   // scalarize the statment
   Stmt Scalarize(Stmt stmt) {
     Var idx(var_->name_hint + ".s", var_->dtype);
@@ -461,6 +607,8 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   int var_lanes_;
   // ramp representing the var.
   PrimExpr ramp_;
+  // whether to mask the accesses under a vector condition instead of scalarizing.
+  bool enable_predication_;
   // flag to mark requirment of scalarization.
   bool need_scalarize_{false};
   // Let binding
@@ -530,6 +678,9 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
 
 class LoopVectorizer : public StmtMutator {
  public:
+  explicit LoopVectorizer(bool enable_predication = false)
+      : enable_predication_(enable_predication) {}
+
   Stmt VisitStmt_(const ForNode* op) final {
     if (op->kind == ForKind::kVectorized) {
       ICHECK(is_zero(op->min));
@@ -537,11 +688,15 @@ class LoopVectorizer : public StmtMutator {
       if (!extent_as_int || extent_as_int->value < 1) {
         LOG(FATAL) << "Failed to vectorize loop with extent " << op->extent;
       }
-      return Vectorizer(op->loop_var, static_cast<int>(extent_as_int->value))(op->body);
+      return Vectorizer(op->loop_var, static_cast<int>(extent_as_int->value),
+                        enable_predication_)(op->body);
     } else {
       return StmtMutator::VisitStmt_(op);
     }
   }
+
+ private:
+  bool enable_predication_;
 };
 
 Stmt VectorizeLoop(Stmt stmt) { return LoopVectorizer()(std::move(stmt)); }
@@ -568,7 +723,11 @@ Pass VectorizeLoop(bool enable_vectorize) {
   auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
     auto* n = f.CopyOnWrite();
     if (enable_vectorize) {
-      n->body = LoopVectorizer()(std::move(n->body));
+      auto cfg = ctx->GetConfig<VectorizeLoopConfig>("tir.VectorizeLoop");
+      if (!cfg.defined()) {
+        cfg = AttrsWithDefaultValues<VectorizeLoopConfig>();
+      }
+      n->body = LoopVectorizer(cfg.value()->enable_predication)(std::move(n->body));
     } else {
       n->body = VectorizeSkipper()(std::move(n->body));
     }
@@ -0,0 +1,252 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file vectorize_reduction.cc
+ * \brief Accumulate the reductions of the innermost loops into the lanes
+ *  of a vector, and combine the lanes after the loop.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/target/target.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/expr.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <functional>
+#include <string>
+
+#include "ir_utils.h"
+
+namespace tvm {
+namespace tir {
+
+struct VectorizeReductionConfigNode : public tvm::AttrsNode<VectorizeReductionConfigNode> {
+  int vector_bits;
+
+  TVM_DECLARE_ATTRS(VectorizeReductionConfigNode, "tir.transform.VectorizeReductionConfig") {
+    TVM_ATTR_FIELD(vector_bits)
+        .describe("The width of the partial accumulator in bits. Twice the native vector "
+                  "width keeps two independent accumulations in flight")
+        .set_default(512);
+  }
+};
+
+class VectorizeReductionConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(VectorizeReductionConfig, Attrs,
+                                            VectorizeReductionConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(VectorizeReductionConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.VectorizeReduction", VectorizeReductionConfig);
+
+/*! \brief A commutative reduction C[index] = combine(C[index], value). */
+struct Reduction {
+  /*! \brief The accumulating store. */
+  const StoreNode* store{nullptr};
+  /*! \brief The value combined into the accumulator. */
+  PrimExpr value;
+  /*! \brief The identity element of the combiner. */
+  PrimExpr identity;
+  /*! \brief The intrinsic combining the lanes of a vector. */
+  Op reduce_op;
+  /*! \brief The combiner. */
+  std::function<PrimExpr(PrimExpr, PrimExpr)> combine;
+};
+
+/*!
+ * \brief Rewrite the innermost loops whose body is a single reduction
+ *
+ *  for (k, 0, n) {
+ *    C[i] = C[i] + f(k)
+ *  }
+ *
+ * into
+ *
+ *  acc[ramp(0, 1, lanes)] = broadcast(0, lanes)
+ *  for (k.outer, 0, n / lanes) {
+ *    acc[ramp(0, 1, lanes)] = acc[ramp(0, 1, lanes)] + f(ramp(k.outer * lanes, 1, lanes))
+ *  }
+ *  C[i] = C[i] + vector_reduce_add(acc[ramp(0, 1, lanes)])
+ *  for (k.tail, 0, n % lanes) {
+ *    C[i] = C[i] + f(n / lanes * lanes + k.tail)
+ *  }
+ */
+class ReductionVectorizer : public StmtMutator {
+ public:
+  explicit ReductionVectorizer(int vector_bits) : vector_bits_(vector_bits) {}
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    Stmt stmt = StmtMutator::VisitStmt_(op);
+    op = stmt.as<ForNode>();
+    Reduction red;
+    if (op->kind != ForKind::kSerial || !MatchReduction(op, &red)) {
+      return stmt;
+    }
+    int lanes = vector_bits_ / red.store->value.dtype().bits();
+    if (lanes < 2) return stmt;
+    const int64_t* extent = as_const_int(op->extent);
+    if (extent != nullptr && *extent < lanes) return stmt;
+    return Rewrite(op, red, lanes);
+  }
+
+ private:
+  bool MatchReduction(const ForNode* loop, Reduction* red) {
+    const StoreNode* store = loop->body.as<StoreNode>();
+    if (store == nullptr || !is_one(store->predicate) ||
+        ExprUseVar(store->index, loop->loop_var)) {
+      return false;
+    }
+    DataType t = store->value.dtype();
+    if (t.lanes() != 1 || t.bits() < 8 || !(t.is_float() || t.is_int() || t.is_uint())) {
+      return false;
+    }
+    PrimExpr a, b;
+    if (const AddNode* op = store->value.as<AddNode>()) {
+      a = op->a, b = op->b;
+      red->identity = make_zero(t);
+      red->reduce_op = builtin::vector_reduce_add();
+      red->combine = [](PrimExpr x, PrimExpr y) { return x + y; };
+    } else if (const MulNode* op = store->value.as<MulNode>()) {
+      a = op->a, b = op->b;
+      red->identity = make_const(t, 1);
+      red->reduce_op = builtin::vector_reduce_mul();
+      red->combine = [](PrimExpr x, PrimExpr y) { return x * y; };
+    } else if (const MaxNode* op = store->value.as<MaxNode>()) {
+      a = op->a, b = op->b;
+      red->identity = t.is_float() ? -infinity(t) : min_value(t);
+      red->reduce_op = builtin::vector_reduce_max();
+      red->combine = [](PrimExpr x, PrimExpr y) { return max(x, y); };
+    } else if (const MinNode* op = store->value.as<MinNode>()) {
+      a = op->a, b = op->b;
+      red->identity = t.is_float() ? infinity(t) : max_value(t);
+      red->reduce_op = builtin::vector_reduce_min();
+      red->combine = [](PrimExpr x, PrimExpr y) { return min(x, y); };
+    } else {
+      return false;
+    }
+    if (IsAccumulator(a, store)) {
+      red->value = b;
+    } else if (IsAccumulator(b, store)) {
+      red->value = a;
+    } else {
+      return false;
+    }
+    // The accumulator is only written after the loop.
+    bool reads_accumulator = false;
+    PostOrderVisit(red->value, [&](const ObjectRef& node) {
+      if (const LoadNode* load = node.as<LoadNode>()) {
+        reads_accumulator |= load->buffer_var.same_as(store->buffer_var);
+      } else if (node.same_as(store->buffer_var)) {
+        reads_accumulator = true;
+      }
+    });
+    if (reads_accumulator || SideEffect(red->value) > CallEffectKind::kReadState) {
+      return false;
+    }
+    red->store = store;
+    return true;
+  }
+
+  static bool IsAccumulator(const PrimExpr& e, const StoreNode* store) {
+    const LoadNode* load = e.as<LoadNode>();
+    return load != nullptr && load->buffer_var.same_as(store->buffer_var) &&
+           is_one(load->predicate) && ExprDeepEqual()(load->index, store->index);
+  }
+
+  Stmt Rewrite(const ForNode* loop, const Reduction& red, int lanes) {
+    const StoreNode* store = red.store;
+    DataType t = store->value.dtype();
+    DataType itype = loop->loop_var.dtype();
+    std::string name = loop->loop_var->name_hint;
+    Var acc(store->buffer_var->name_hint + ".acc", PointerType(PrimType(t)));
+    Var lane(name + ".v", itype);
+    Var outer(name + ".outer", itype);
+    PrimExpr zero = make_zero(itype), vector_lanes = make_const(itype, lanes);
+    PrimExpr main_extent = analyzer_.Simplify(floordiv(loop->extent, vector_lanes));
+
+    // partial accumulation in the lanes of acc.
+    PrimExpr k = loop->min + outer * vector_lanes + lane;
+    PrimExpr value = Substitute(red.value, Map<Var, PrimExpr>{{loop->loop_var, k}});
+    Stmt update = Store(acc, red.combine(Load(t, acc, lane, const_true()), value), lane,
+                        const_true());
+    update = VectorizeLoop(For(lane, zero, vector_lanes, ForKind::kVectorized, update));
+    // give up if the value cannot be vectorized.
+    bool scalarized = false;
+    PostOrderVisit(update,
+                   [&](const ObjectRef& node) { scalarized |= node->IsInstance<ForNode>(); });
+    if (scalarized) return GetRef<Stmt>(loop);
+
+    PrimExpr acc_index = Ramp(0, 1, lanes);
+    Stmt init = Store(acc, Broadcast(red.identity, lanes), acc_index, const_true(lanes));
+    update = For(outer, zero, main_extent, ForKind::kSerial, update);
+    PrimExpr partial = Load(t.with_lanes(lanes), acc, acc_index, const_true(lanes));
+    Stmt combine = Store(store->buffer_var,
+                         red.combine(Load(t, store->buffer_var, store->index, const_true()),
+                                     Call(t, red.reduce_op, {partial})),
+                         store->index, const_true());
+    Stmt body = SeqStmt({init, update, combine});
+    body = Allocate(acc, t, {make_const(DataType::Int(32), lanes)}, const_true(), body);
+    body = AttrStmt(acc, attr::storage_scope, StringImm("local"), body);
+
+    // the remaining iterations.
+    PrimExpr tail_extent = analyzer_.Simplify(loop->extent - main_extent * vector_lanes);
+    if (!is_zero(tail_extent)) {
+      Var tail(name + ".tail", itype);
+      PrimExpr k_tail = loop->min + main_extent * vector_lanes + tail;
+      Stmt tail_body = Substitute(loop->body, Map<Var, PrimExpr>{{loop->loop_var, k_tail}});
+      body = SeqStmt({body, For(tail, zero, tail_extent, ForKind::kSerial, tail_body)});
+    }
+    return body;
+  }
+
+  // the width of the accumulator in bits.
+  int vector_bits_;
+  // analyzer
+  arith::Analyzer analyzer_;
+};
+
+namespace transform {
+
+Pass VectorizeReduction() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    // The vector_reduce intrinsics are only lowered by the LLVM backend.
+    auto target = f->GetAttr<Target>(tvm::attr::kTarget);
+    if (!target.defined() || target.value()->kind->name != "llvm") return f;
+    auto cfg = ctx->GetConfig<VectorizeReductionConfig>("tir.VectorizeReduction");
+    if (!cfg.defined()) {
+      cfg = AttrsWithDefaultValues<VectorizeReductionConfig>();
+    }
+    auto* n = f.CopyOnWrite();
+    n->body = ReductionVectorizer(cfg.value()->vector_bits)(std::move(n->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.VectorizeReduction", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.VectorizeReduction").set_body_typed(VectorizeReduction);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
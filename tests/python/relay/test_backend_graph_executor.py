@@ -146,6 +146,73 @@ def test_plan_memory():
     assert len(device_types) == 1
 
 
+def test_plan_memory_inplace():
+    x = relay.var("x", shape=(10,))
+    y = relay.var("y", shape=(10,))
+    z = relay.add(x, y)
+    z1 = relay.exp(z)
+    z2 = relay.sigmoid(z1)
+    z3 = relay.nn.relu(z2)
+    # z3 is still alive after the transpose.
+    out = relay.add(relay.transpose(relay.reshape(z3, (2, 5))), relay.reshape(z3, (5, 2)))
+    func = relay.Function([x, y], out)
+    mod = tvm.IRModule.from_expr(func)
+    mod = relay.transform.InferType()(mod)
+    mod = relay.transform.FuseOps(0)(mod)
+    mod = relay.transform.InferType()(mod)
+    func = mod["main"]
+
+    def plan():
+        smap = relay.backend._backend.GraphPlanMemory(func)
+        return {k: [x.value for x in v[0]] for k, v in smap.items()}
+
+    no_inplace = plan()
+    with tvm.transform.PassContext(config={"relay.backend.enable_inplace": True}):
+        inplace = plan()
+
+    calls = {}
+
+    def _visit(expr):
+        if isinstance(expr, relay.Call) and isinstance(expr.op, relay.Function):
+            calls.setdefault(expr.op.body.op.name, []).append(expr)
+
+    relay.analysis.post_order_visit(func.body, _visit)
+    # the params are never written.
+    assert inplace[calls["add"][0]] not in (inplace[func.params[0]], inplace[func.params[1]])
+    # the elementwise chain runs in the buffer of the first add.
+    chain = [calls[name][0] for name in ["exp", "sigmoid", "nn.relu"]]
+    assert all(inplace[call] == inplace[calls["add"][0]] for call in chain)
+    assert len({tuple(v) for v in no_inplace.values()}) > len({tuple(v) for v in inplace.values()})
+    # the reshapes read z3, which cannot be overwritten by the transpose.
+    assert inplace[calls["transpose"][0]] != inplace[calls["nn.relu"][0]]
+
+
+@tvm.testing.requires_llvm
+def test_inplace_executor():
+    x = relay.var("x", shape=(4, 8))
+    y = relay.var("y", shape=(4, 8))
+    z = relay.nn.relu(relay.exp(relay.add(x, y)))
+    z = relay.multiply(z, relay.nn.dense(z, relay.const(np.ones((8, 8), "float32"))))
+    z = relay.sigmoid(relay.subtract(z, y))
+    func = relay.Function([x, y], z)
+    mod = tvm.IRModule.from_expr(func)
+    x_data = np.random.uniform(size=(4, 8)).astype("float32")
+    y_data = np.random.uniform(size=(4, 8)).astype("float32")
+    ref = np.maximum(np.exp(x_data + y_data), 0)
+    ref = 1 / (1 + np.exp(-(ref * np.matmul(ref, np.ones((8, 8), "float32")) - y_data)))
+    for opt_level in [0, 3]:
+        config = {"relay.backend.enable_inplace": True}
+        with tvm.transform.PassContext(opt_level=opt_level, config=config):
+            lib = relay.build(mod, "llvm")
+        m = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+        m.set_input("x", x_data)
+        m.set_input("y", y_data)
+        m.run()
+        tvm.testing.assert_allclose(m.get_output(0).asnumpy(), ref, rtol=1e-5)
+        # the inputs are not overwritten.
+        tvm.testing.assert_allclose(m.get_input("y").asnumpy(), y_data)
+
+
 @tvm.testing.uses_gpu
 def test_gru_like():
     def unit(rnn_dim):
@@ -232,6 +299,8 @@ def test_graph_executor_nested_tuples():
 
 if __name__ == "__main__":
     test_plan_memory()
+    test_plan_memory_inplace()
+    test_inplace_executor()
     test_with_params()
     test_add_op_scalar()
     test_add_op_tensor()
@@ -1718,6 +1718,31 @@ def test_partition_constant_embedding():
     assert tvm.ir.structural_equal(embeded_func(x, b), pattern.partition(reluc))
 
 
+def test_match_patterns():
+    x = relay.var("x")
+    w = relay.var("w")
+    b = relay.var("b")
+    conv = relay.op.nn.conv2d(x, w)
+    relu = relay.op.nn.relu(relay.op.nn.bias_add(conv, b))
+    out = relay.op.divide(relay.op.multiply(relu, x), w)
+
+    conv_bias = is_op("nn.bias_add")(is_op("nn.conv2d")(wildcard(), wildcard()), wildcard())
+    conv_bias_relu = is_op("nn.relu")(conv_bias)
+    dense = is_op("nn.dense")(wildcard(), wildcard())
+    # the quotient of a product matches with the operators reassociated.
+    mul_div = is_op("divide")(is_op("multiply")(wildcard(), wildcard()), wildcard())
+    unary = wildcard()(wildcard())
+    matches = match_patterns([conv_bias_relu, dense, mul_div, unary], out)
+    assert len(matches) == 4
+    assert len(matches[0]) == 1 and matches[0][0].same_as(relu)
+    assert len(matches[1]) == 0
+    assert len(matches[2]) == 1 and matches[2][0].same_as(out)
+    assert len(matches[3]) == 1 and matches[3][0].same_as(relu)
+    for pattern, roots in zip([conv_bias_relu, dense, mul_div, unary], matches):
+        for root in roots:
+            assert pattern.match(root)
+
+
 if __name__ == "__main__":
     test_expr_pattern()
     test_var_pattern()
@@ -1784,3 +1809,4 @@ if __name__ == "__main__":
     test_IfPattern()
     test_match_if()
     test_no_match_if()
+    test_match_patterns()
@@ -114,7 +114,53 @@ def test_no_fuse():
     check_memory_plan(func, check_no_fuse)
 
 
+def count_alloc_storage(func):
+    count = [0]
+
+    def _visit(expr):
+        if isinstance(expr, relay.Call) and expr.op == relay.op.get("memory.alloc_storage"):
+            count[0] += 1
+
+    relay.analysis.post_order_visit(func, _visit)
+    return count[0]
+
+
+def test_inplace():
+    x = relay.var("x", shape=(10,))
+    y = relay.var("y", shape=(10,))
+    z = relay.add(x, y)
+    z = relay.exp(z)
+    z = relay.sigmoid(z)
+    z = relay.add(z, relay.reshape(z, (10,)))
+    func = relay.Function([x, y], z)
+
+    def manifest_alloc():
+        mod = tvm.IRModule.from_expr(func)
+        mod = relay.transform.InferType()(mod)
+        mod = relay.transform.FuseOps(0)(mod)
+        mod = relay.transform.ToANormalForm()(mod)
+        mod = relay.transform.InferType()(mod)
+        target = tvm.target.Target("llvm")
+        manifest = tvm.get_global_func("relay.transform.ManifestAlloc")
+        return manifest(target, {int(tvm.cpu(0).device_type): target})(mod)["main"]
+
+    # exp and sigmoid write into the output of the first add, the last add
+    # cannot overwrite z which is also viewed by the reshape.
+    assert count_alloc_storage(manifest_alloc()) == 4
+    with tvm.transform.PassContext(config={"relay.backend.enable_inplace": True}):
+        assert count_alloc_storage(manifest_alloc()) == 2
+
+    mod = tvm.IRModule.from_expr(func)
+    x_data = np.random.rand(10).astype("float32")
+    y_data = np.random.rand(10).astype("float32")
+    z_data = 1 / (1 + np.exp(-np.exp(x_data + y_data)))
+    with tvm.transform.PassContext(opt_level=0, config={"relay.backend.enable_inplace": True}):
+        res = relay.create_executor("vm", mod).evaluate()(x_data, y_data)
+    np.testing.assert_allclose(res.asnumpy(), z_data * 2, rtol=1e-5)
+
+
 if __name__ == "__main__":
     test_tyck_alloc_tensor()
     test_add()
     test_add_sub()
+    test_inplace()
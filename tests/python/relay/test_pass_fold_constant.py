@@ -298,6 +298,38 @@ def test_fold_dropout():
     assert tvm.ir.structural_equal(run_infer_type(before_mod["main"]), after_mod["main"])
 
 
+def test_fold_batched():
+    c_data = np.random.uniform(size=(4, 8)).astype("float32")
+    t = relay.TensorType([8, 4], "float32")
+
+    def before():
+        c = relay.const(c_data)
+        x = relay.var("x", t)
+        # two constant subgraphs, sharing c.
+        w0 = relay.transpose(relay.multiply(c, relay.const(2, "float32")))
+        w1 = relay.split(relay.transpose(c), 2, axis=1)
+        y = relay.add(x, w0)
+        y = relay.concatenate([y, w1[0], w1[1]], axis=1)
+        # a constant subgraph only used through a let binding.
+        v = relay.var("v")
+        y = relay.Let(v, relay.exp(c), relay.add(y, relay.sum(v)))
+        return relay.Function([x], y)
+
+    def fold(batched):
+        config = {"relay.FoldConstant.batched": batched}
+        with tvm.transform.PassContext(config=config):
+            return run_opt_pass(before(), transform.FoldConstant())
+
+    zz = fold(True)
+    assert tvm.ir.structural_equal(zz, fold(False))
+    # only the operations on x are left.
+    ops = set()
+    relay.analysis.post_order_visit(
+        zz, lambda e: ops.add(e.op.name) if isinstance(e, relay.Call) else None
+    )
+    assert ops == {"add", "concatenate"}
+
+
 if __name__ == "__main__":
     test_fold_const()
     test_fold_let()
@@ -307,3 +339,4 @@ if __name__ == "__main__":
     test_fold_batch_norm()
     test_fold_ndarray_size()
     test_fold_dropout()
+    test_fold_batched()
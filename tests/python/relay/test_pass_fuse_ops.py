@@ -784,6 +784,45 @@ def test_fuse_dynamic_squeeze_slice_take():
     assert np.allclose(result.asnumpy(), np_result)
 
 
+def test_fuse_cost_model():
+    """Do not fuse a producer which a broadcast would recompute many times."""
+
+    def before():
+        x = relay.var("x", shape=(64,))
+        y = relay.var("y", shape=(4096, 64))
+        z = relay.sigmoid(relay.exp(x))
+        z = relay.add(z, y)
+        return relay.Function([x, y], z)
+
+    def expected():
+        x = relay.var("p0", shape=(64,))
+        z = relay.sigmoid(relay.exp(x))
+        f0 = relay.Function([x], z)
+        f0 = f0.with_attr("Primitive", tvm.tir.IntImm("int32", 1))
+
+        p0 = relay.var("p0", shape=(64,))
+        p1 = relay.var("p1", shape=(4096, 64))
+        f1 = relay.Function([p0, p1], relay.add(p0, p1))
+        f1 = f1.with_attr("Primitive", tvm.tir.IntImm("int32", 1))
+
+        x = relay.var("x", shape=(64,))
+        y = relay.var("y", shape=(4096, 64))
+        z = relay.Call(f0, [x])
+        z = relay.Call(f1, [z, y])
+        return relay.Function([x, y], z)
+
+    # the rules fuse the three ops together.
+    zz = run_opt_pass(before(), transform.FuseOps())
+    assert len(zz.body.op.params) == 2
+
+    with tvm.transform.PassContext(config={"relay.FuseOps.cost_model": {}}):
+        zz = run_opt_pass(before(), transform.FuseOps())
+        modeled = relay.analysis.estimate_fused_latency(zz)
+    after = run_opt_pass(expected(), transform.InferType())
+    assert tvm.ir.structural_equal(zz, after)
+    assert modeled > 0
+
+
 if __name__ == "__main__":
     test_fuse_simple()
     test_conv2d_fuse()
@@ -804,3 +843,4 @@ if __name__ == "__main__":
     test_fuse_gather_nd()
     test_fuse_bcast_reduce_scalar()
     test_fuse_max_diamond()
+    test_fuse_cost_model()
@@ -0,0 +1,130 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name,too-many-locals,missing-module-docstring
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relay
+from tvm.relay import transform
+
+
+def run_opt_pass(expr, opt_pass):
+    mod = tvm.IRModule.from_expr(expr)
+    mod = transform.InferType()(mod)
+    mod = opt_pass(mod)
+    return mod["main"]
+
+
+def check_numerics(before, after):
+    inputs = [
+        np.random.uniform(-1, 1, size=[int(dim) for dim in param.checked_type.shape]).astype(
+            "float32"
+        )
+        for param in before.params
+    ]
+    results = []
+    for func in [before, after]:
+        mod = tvm.IRModule.from_expr(func)
+        ex = relay.create_executor("graph", mod=mod, device=tvm.cpu(), target="llvm")
+        results.append(ex.evaluate()(*inputs))
+    for expected, actual in zip(results[0], results[1]):
+        tvm.testing.assert_allclose(expected.asnumpy(), actual.asnumpy(), rtol=1e-5, atol=1e-5)
+
+
+def test_elemwise_chains():
+    """Parallel chains stay batched between one stack and one split."""
+    n = 3
+
+    def before():
+        xs = [relay.var("x%d" % i, shape=(2, 3)) for i in range(n)]
+        ys = [relay.var("y%d" % i, shape=(2, 3)) for i in range(n)]
+        outs = [relay.nn.relu(relay.add(x, y)) for x, y in zip(xs, ys)]
+        return relay.Function(xs + ys, relay.Tuple(outs))
+
+    def expected():
+        xs = [relay.var("x%d" % i, shape=(2, 3)) for i in range(n)]
+        ys = [relay.var("y%d" % i, shape=(2, 3)) for i in range(n)]
+        x = relay.stack(xs, axis=0)
+        y = relay.stack(ys, axis=0)
+        out = relay.split(relay.nn.relu(relay.add(x, y)), n, axis=0).astuple()
+        outs = [relay.squeeze(relay.TupleGetItem(out, i), axis=[0]) for i in range(n)]
+        return relay.Function(xs + ys, relay.Tuple(outs))
+
+    after = run_opt_pass(before(), transform.HorizontalFusion(n))
+    tvm.ir.assert_structural_equal(after, run_opt_pass(expected(), transform.InferType()))
+    check_numerics(run_opt_pass(before(), transform.InferType()), after)
+
+
+def test_per_head_dense():
+    """Independent dense ops become one batch_matmul, with their shared bias."""
+    heads = 4
+
+    def before():
+        xs = [relay.var("x%d" % i, shape=(8, 16)) for i in range(heads)]
+        ws = [relay.var("w%d" % i, shape=(4, 16)) for i in range(heads)]
+        b = relay.var("b", shape=(4,))
+        outs = [relay.add(relay.nn.dense(x, w), b) for x, w in zip(xs, ws)]
+        return relay.Function(xs + ws + [b], relay.Tuple(outs))
+
+    def expected():
+        xs = [relay.var("x%d" % i, shape=(8, 16)) for i in range(heads)]
+        ws = [relay.var("w%d" % i, shape=(4, 16)) for i in range(heads)]
+        b = relay.var("b", shape=(4,))
+        y = relay.nn.batch_matmul(relay.stack(xs, axis=0), relay.stack(ws, axis=0))
+        out = relay.split(relay.add(y, b), heads, axis=0).astuple()
+        outs = [relay.squeeze(relay.TupleGetItem(out, i), axis=[0]) for i in range(heads)]
+        return relay.Function(xs + ws + [b], relay.Tuple(outs))
+
+    after = run_opt_pass(before(), transform.HorizontalFusion(heads))
+    tvm.ir.assert_structural_equal(after, run_opt_pass(expected(), transform.InferType()))
+    check_numerics(run_opt_pass(before(), transform.InferType()), after)
+
+
+def test_dependent_or_mismatched():
+    """Dependent ops, ops of other shapes and too few ops are left alone."""
+    x = relay.var("x", shape=(2, 3))
+    y = relay.var("y", shape=(4, 3))
+    # the chain depends on itself, and the op on y has another shape
+    out = relay.exp(relay.exp(relay.exp(x)))
+    func = relay.Function([x, y], relay.Tuple([out, relay.exp(y), relay.exp(x)]))
+    before = run_opt_pass(func, transform.InferType())
+    after = run_opt_pass(func, transform.HorizontalFusion(3))
+    tvm.ir.assert_structural_equal(after, before)
+
+
+def test_static_shape_or_broadcast_batch():
+    """Ops with static output shapes and broadcast batch_matmul are left alone."""
+    n = 3
+    xs = [relay.var("x%d" % i, shape=(3,)) for i in range(n)]
+    ys = [relay.var("y%d" % i, shape=(2, 4, 8)) for i in range(n)]
+    ws = [relay.var("w%d" % i, shape=(1, 5, 8)) for i in range(n)]
+    outs = [relay.broadcast_to(x, (2, 3)) for x in xs]
+    outs += [relay.zeros((2, 3), "float32") for _ in range(n)]
+    outs += [relay.full(relay.const(1.0), (2, 3)) for _ in range(n)]
+    outs += [relay.nn.batch_matmul(y, w) for y, w in zip(ys, ws)]
+    func = relay.Function(xs + ys + ws, relay.Tuple(outs))
+    before = run_opt_pass(func, transform.InferType())
+    after = run_opt_pass(func, transform.HorizontalFusion(n))
+    tvm.ir.assert_structural_equal(after, before)
+
+
+if __name__ == "__main__":
+    test_elemwise_chains()
+    test_per_head_dense()
+    test_dependent_or_mismatched()
+    test_static_shape_or_broadcast_batch()
@@ -0,0 +1,104 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Test the layout planning pass"""
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.relay import transform
+from tvm.relay.testing import run_infer_type
+
+
+def run_opt_pass(expr, passes, config=None):
+    passes = passes if isinstance(passes, list) else [passes]
+    mod = tvm.IRModule.from_expr(expr)
+    seq = tvm.transform.Sequential(passes)
+    with tvm.transform.PassContext(opt_level=3, config=config):
+        mod = seq(mod)
+    return mod["main"]
+
+
+def conv_chain(channels, width):
+    """Two 3x3 convolutions with a bias and a relu in between."""
+    shape = (1, channels, width, width)
+    x = relay.var("x", shape=shape)
+    y = x
+    for _ in range(2):
+        w = np.random.uniform(-1, 1, size=(channels, channels, 3, 3)).astype("float32")
+        b = np.random.uniform(-1, 1, size=(channels, 1, 1)).astype("float32")
+        y = relay.nn.conv2d(y, relay.const(w), channels=channels, kernel_size=(3, 3), padding=1)
+        y = relay.nn.relu(relay.add(y, relay.const(b)))
+    return relay.Function([x], y), shape
+
+
+def collect_ops(func):
+    ops = []
+    relay.analysis.post_order_visit(
+        func,
+        lambda expr: ops.append(expr) if isinstance(expr, relay.Call) else None,
+    )
+    return ops
+
+
+def check_result(before, after, shape):
+    data = np.random.uniform(-1, 1, size=shape).astype("float32")
+    results = []
+    for func in [before, after]:
+        mod = tvm.IRModule.from_expr(func)
+        results.append(relay.create_executor("graph", mod=mod).evaluate()(data).asnumpy())
+    np.testing.assert_allclose(results[0], results[1], rtol=1e-4, atol=1e-4)
+
+
+def test_plan_blocked_layout():
+    # With 256 channels the NHWC accumulators spill, and the width of 7 wastes
+    # a lane of NCHW, so both convolutions take the first block that fits.
+    before, shape = conv_chain(256, 7)
+    after = run_opt_pass(before, [transform.PlanLayout(), transform.FoldConstant()])
+
+    convs = [call for call in collect_ops(after) if call.op.name == "nn.contrib_conv2d_NCHWc"]
+    assert len(convs) == 2, "Actual = \n" + str(after)
+    assert all(conv.attrs.data_layout == "NCHW8c" for conv in convs)
+    # Only the input and the output of the function are transformed.
+    transforms = [call for call in collect_ops(after) if call.op.name == "layout_transform"]
+    assert len(transforms) == 2, "Actual = \n" + str(after)
+    check_result(before, after, shape)
+
+
+def test_plan_keeps_layout():
+    # With a width of 56 NCHW is as fast as any other layout, so no transform pays off.
+    before, _ = conv_chain(64, 56)
+    after = run_opt_pass(before, transform.PlanLayout())
+    expected = run_infer_type(before)
+
+    assert tvm.ir.structural_equal(after, expected), "Actual = \n" + str(after)
+
+
+def test_plan_with_config():
+    before, shape = conv_chain(256, 7)
+    config = {"relay.PlanLayout.cost_model": {"blocks": [16]}}
+    after = run_opt_pass(before, [transform.PlanLayout(), transform.FoldConstant()], config)
+
+    convs = [call for call in collect_ops(after) if call.op.name == "nn.contrib_conv2d_NCHWc"]
+    assert len(convs) == 2, "Actual = \n" + str(after)
+    assert all(conv.attrs.data_layout == "NCHW16c" for conv in convs)
+    check_result(before, after, shape)
+
+
+if __name__ == "__main__":
+    test_plan_blocked_layout()
+    test_plan_keeps_layout()
+    test_plan_with_config()
@@ -0,0 +1,88 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Test the rematerialization pass"""
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.relay import transform
+from tvm.relay.testing import count_ops, run_infer_type
+
+plan_memory_bytes = tvm.get_global_func("relay.backend.GraphPlanMemoryBytes")
+
+
+def run_opt_pass(expr, opt_pass):
+    mod = tvm.IRModule.from_expr(expr)
+    mod = tvm.transform.Sequential([transform.InferType(), opt_pass, transform.InferType()])(mod)
+    return mod["main"]
+
+
+def saved_activations():
+    # a1 and a2 are both alive until the end, as if kept for a backward pass.
+    x = relay.var("x", shape=(64, 64))
+    a1 = relay.nn.relu(x)
+    a2 = relay.exp(a1)
+    y = relay.exp(relay.exp(a2))
+    y = relay.add(y, a2)
+    return relay.Function([x], relay.add(y, a1))
+
+
+def test_rematerialize_within_budget():
+    before = run_infer_type(saved_activations())
+    after = run_opt_pass(saved_activations(), transform.Rematerialize(1 << 40))
+    assert tvm.ir.structural_equal(after, before), "Actual = \n" + str(after)
+
+
+def test_rematerialize_saved_activation():
+    before = run_infer_type(saved_activations())
+    before_bytes = plan_memory_bytes(before)
+    after = run_opt_pass(saved_activations(), transform.Rematerialize(before_bytes - 1))
+    assert plan_memory_bytes(after) < before_bytes
+    # relu is recomputed from the parameter for the last add.
+    assert count_ops(after)["nn.relu"] == 2
+
+    x = np.random.uniform(-1, 1, size=(64, 64)).astype("float32")
+    results = [relay.create_executor().evaluate(f)(x).asnumpy() for f in [before, after]]
+    np.testing.assert_allclose(results[0], results[1], rtol=1e-5)
+
+
+def test_rematerialize_gradient():
+    x = relay.var("x", shape=(16, 32))
+    w1 = relay.var("w1", shape=(64, 32))
+    w2 = relay.var("w2", shape=(8, 64))
+    y = relay.nn.relu(relay.nn.dense(x, w1))
+    y = relay.sum(relay.nn.dense(relay.sigmoid(y), w2))
+    mod = tvm.IRModule.from_expr(relay.Function([x, w1, w2], y))
+    mod = tvm.transform.Sequential([transform.InferType(), transform.FirstOrderGradient()])(mod)
+    before = run_infer_type(mod["main"])
+    after = run_opt_pass(mod["main"], transform.Rematerialize(1))
+    graph = run_opt_pass(mod["main"], transform.ToGraphNormalForm())
+    assert plan_memory_bytes(after) <= plan_memory_bytes(graph)
+
+    args = [np.random.uniform(-1, 1, size=v.type_annotation.concrete_shape) for v in [x, w1, w2]]
+    args = [arg.astype("float32") for arg in args]
+    ref_forward, ref_grads = relay.create_executor().evaluate(before)(*args)
+    forward, grads = relay.create_executor().evaluate(after)(*args)
+    np.testing.assert_allclose(ref_forward.asnumpy(), forward.asnumpy(), rtol=1e-5)
+    for ref_grad, grad in zip(ref_grads, grads):
+        np.testing.assert_allclose(ref_grad.asnumpy(), grad.asnumpy(), rtol=1e-5)
+
+
+if __name__ == "__main__":
+    test_rematerialize_within_budget()
+    test_rematerialize_saved_activation()
+    test_rematerialize_gradient()
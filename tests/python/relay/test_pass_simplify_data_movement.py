@@ -0,0 +1,148 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Test the data movement canonicalization pass"""
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.relay import transform
+from tvm.relay.analysis import data_movement_bytes
+from tvm.relay.testing import run_infer_type
+
+
+def run_opt_pass(expr, opt_pass):
+    mod = tvm.IRModule.from_expr(expr)
+    mod = tvm.transform.Sequential([transform.InferType(), opt_pass])(mod)
+    return mod["main"]
+
+
+def check(before, expected):
+    after = run_opt_pass(before, transform.SimplifyDataMovement())
+    expected = run_infer_type(expected)
+    assert tvm.ir.structural_equal(after, expected), "Actual = \n" + str(after)
+
+
+def test_cancel_layout_transforms():
+    def before():
+        x = relay.var("x", shape=(1, 32, 8, 8))
+        y = relay.layout_transform(x, "NCHW", "NCHW16c")
+        y = relay.layout_transform(y, "NCHW16c", "NHWC")
+        y = relay.layout_transform(y, "NHWC", "NCHW")
+        return relay.Function([x], relay.nn.relu(y))
+
+    def expected():
+        x = relay.var("x", shape=(1, 32, 8, 8))
+        return relay.Function([x], relay.nn.relu(x))
+
+    check(before(), expected())
+
+
+def test_merge_layout_transforms():
+    def before():
+        x = relay.var("x", shape=(1, 32, 8, 8))
+        y = relay.layout_transform(x, "NCHW", "NHWC")
+        y = relay.layout_transform(y, "NHWC", "NCHW8c")
+        return relay.Function([x], y)
+
+    def expected():
+        x = relay.var("x", shape=(1, 32, 8, 8))
+        return relay.Function([x], relay.layout_transform(x, "NCHW", "NCHW8c"))
+
+    check(before(), expected())
+
+
+def test_keep_mismatched_layout_transforms():
+    def before():
+        x = relay.var("x", shape=(1, 8, 8, 8))
+        y = relay.layout_transform(x, "NCHW", "NHWC")
+        y = relay.layout_transform(y, "NCHW", "NHWC")
+        z = relay.layout_transform(x, "NCHW", "NHWC")
+        z = relay.layout_transform(z, "NHCW", "NCHW")
+        return relay.Function([x], relay.Tuple([y, z]))
+
+    check(before(), before())
+
+
+def test_merge_transposes():
+    def before():
+        x = relay.var("x", shape=(2, 3, 4, 5))
+        y = relay.transpose(x, axes=[0, 2, 3, 1])
+        y = relay.layout_transform(y, "NHWC", "HWNC")
+        return relay.Function([x], relay.transpose(relay.transpose(y, [1, 0, 2, 3]), [1, 0, 2, 3]))
+
+    def expected():
+        x = relay.var("x", shape=(2, 3, 4, 5))
+        return relay.Function([x], relay.transpose(x, axes=[2, 3, 0, 1]))
+
+    check(before(), expected())
+
+
+def test_merge_reshapes():
+    def before():
+        x = relay.var("x", shape=(4, 1, 6))
+        y = relay.squeeze(x, axis=[1])
+        y = relay.expand_dims(relay.reshape(y, (2, 12)), axis=0)
+        z = relay.nn.batch_flatten(relay.reshape(x, (4, 6, 1)))
+        return relay.Function([x], relay.Tuple([y, z]))
+
+    def expected():
+        x = relay.var("x", shape=(4, 1, 6))
+        y = relay.reshape(x, (1, 2, 12))
+        z = relay.reshape(x, (4, 6))
+        return relay.Function([x], relay.Tuple([y, z]))
+
+    check(before(), expected())
+
+
+def test_remove_device_copy_round_trip():
+    def before():
+        x = relay.var("x", shape=(8, 8))
+        y = relay.device_copy(x, tvm.cpu(), tvm.gpu())
+        y = relay.device_copy(y, tvm.gpu(), tvm.cpu())
+        return relay.Function([x], relay.exp(y))
+
+    def expected():
+        x = relay.var("x", shape=(8, 8))
+        return relay.Function([x], relay.exp(x))
+
+    check(before(), expected())
+
+
+def test_data_movement_bytes():
+    x = relay.var("x", shape=(1, 32, 8, 8))
+    y = relay.layout_transform(x, "NCHW", "NHWC")
+    y = relay.layout_transform(relay.nn.relu(y), "NHWC", "NCHW")
+    y = relay.layout_transform(relay.layout_transform(y, "NCHW", "NHWC"), "NHWC", "NCHW")
+    func = relay.Function([x], y)
+    after = run_opt_pass(func, transform.SimplifyDataMovement())
+    # The two transforms of 8 KiB around relu remain.
+    assert data_movement_bytes(func) == 4 * 32 * 64 * 4
+    assert data_movement_bytes(after) == 2 * 32 * 64 * 4
+
+    data = np.random.uniform(-1, 1, size=(1, 32, 8, 8)).astype("float32")
+    results = [relay.create_executor().evaluate(f)(data).asnumpy() for f in [func, after]]
+    np.testing.assert_allclose(results[0], results[1])
+
+
+if __name__ == "__main__":
+    test_cancel_layout_transforms()
+    test_merge_layout_transforms()
+    test_keep_mismatched_layout_transforms()
+    test_merge_transposes()
+    test_merge_reshapes()
+    test_remove_device_copy_round_trip()
+    test_data_movement_bytes()
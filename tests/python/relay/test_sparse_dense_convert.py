@@ -86,5 +86,63 @@ def test_bsr_sparse_dense():
     np.testing.assert_allclose(sparse_output, dense_output, atol=1e-5, rtol=1e-5)
 
 
+def test_select_bsr_block_size():
+    w_np = random_bsr_matrix(768, 128, 16, 1, 0.1).todense()
+    block_sizes = relay.analysis.sparse_dense.DEFAULT_BLOCK_SIZES
+    block_size, speedup = relay.analysis.sparse_dense.select_bsr_block_size(w_np, block_sizes, 16)
+    assert block_size == (16, 1)
+    assert speedup > 1.5
+    # A dense weight never gains from a sparse format.
+    w_np = np.random.randn(768, 128).astype("float32")
+    _, speedup = relay.analysis.sparse_dense.select_bsr_block_size(w_np, block_sizes, 16)
+    assert speedup < 1.0
+
+
+def test_bsr_auto_sparse_dense():
+    data = relay.var("data", shape=(1, 128), dtype="float32")
+    w0 = relay.var("weight0", shape=(768, 128), dtype="float32")
+    w1 = relay.var("weight1", shape=(64, 768), dtype="float32")
+    y = relay.nn.relu(relay.nn.dense(data, w0))
+    z = relay.nn.dense(y, w1)
+    func = relay.Function(relay.analysis.free_vars(z), z)
+
+    params = {
+        "weight0": tvm.nd.array(random_bsr_matrix(768, 128, 16, 1, 0.1).todense()),
+        "weight1": tvm.nd.array(np.random.randn(64, 768).astype("float32")),
+    }
+
+    x_np = np.random.randn(1, 128).astype("float32")
+    dense_output = run_func(func, params, x_np)
+    sparse_func, params = relay.data_dep_optimization.bsr_auto.convert(func, params, simd_width=16)
+    # Only the sparse weight is converted, with its own block size.
+    assert "weight1" in params
+    assert params["weight0.data"].shape[1:] == (16, 1)
+    sparse_output = run_func(sparse_func, params, x_np)
+    np.testing.assert_allclose(sparse_output, dense_output, atol=1e-5, rtol=1e-5)
+
+
+def test_bsr_auto_sparse_conv2d():
+    data = relay.var("data", shape=(1, 14, 14, 128), dtype="float32")
+    w = relay.var("weight", shape=(1, 1, 128, 256), dtype="float32")
+    y = relay.nn.conv2d(
+        relay.nn.relu(data), w, kernel_size=(1, 1), data_layout="NHWC", kernel_layout="HWIO"
+    )
+    z = relay.nn.relu(y)
+    func = relay.Function(relay.analysis.free_vars(z), z)
+
+    w_np = np.asarray(random_bsr_matrix(256, 128, 16, 1, 0.1).todense())
+    params = {"weight": tvm.nd.array(w_np.T.reshape(1, 1, 128, 256).copy())}
+
+    x_np = np.random.randn(1, 14, 14, 128).astype("float32")
+    dense_output = run_func(func, params, x_np)
+    sparse_func, params = relay.data_dep_optimization.bsr_auto.convert(func, params, simd_width=16)
+    assert "weight" not in params
+    sparse_output = run_func(sparse_func, params, x_np)
+    np.testing.assert_allclose(sparse_output, dense_output, atol=1e-4, rtol=1e-4)
+
+
 if __name__ == "__main__":
     test_bsr_sparse_dense()
+    test_select_bsr_block_size()
+    test_bsr_auto_sparse_dense()
+    test_bsr_auto_sparse_conv2d()
@@ -0,0 +1,149 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Test the mixed precision conversion pass"""
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.relay import transform
+from tvm.relay.testing import run_infer_type
+
+
+def run_opt_pass(expr, opt_pass):
+    mod = tvm.IRModule.from_expr(expr)
+    mod = tvm.transform.Sequential([transform.InferType(), opt_pass])(mod)
+    return mod["main"]
+
+
+def conv_softmax():
+    x = relay.var("x", shape=(1, 8, 16, 16))
+    w = relay.var("w", shape=(8, 8, 3, 3))
+    y = relay.nn.conv2d(x, w, channels=8, kernel_size=(3, 3), padding=(1, 1))
+    y = relay.nn.softmax(relay.nn.relu(y))
+    return relay.Function([x, w], y)
+
+
+def test_convert_conv_softmax():
+    def expected():
+        x = relay.var("x", shape=(1, 8, 16, 16))
+        w = relay.var("w", shape=(8, 8, 3, 3))
+        y = relay.nn.conv2d(
+            relay.cast(x, "float16"),
+            relay.cast(w, "float16"),
+            channels=8,
+            kernel_size=(3, 3),
+            padding=(1, 1),
+            out_dtype="float32",
+        )
+        y = relay.nn.relu(relay.cast(y, "float16"))
+        y = relay.nn.softmax(relay.cast(y, "float32"))
+        return relay.Function([x, w], y)
+
+    after = run_opt_pass(conv_softmax(), transform.ToMixedPrecision("float16"))
+    assert tvm.ir.structural_equal(after, run_infer_type(expected())), "Actual = \n" + str(after)
+
+
+def test_deny_list():
+    # The accumulator of the convolution goes to relu as it is, without a
+    # round trip through float16.
+    def expected():
+        x = relay.var("x", shape=(1, 8, 16, 16))
+        w = relay.var("w", shape=(8, 8, 3, 3))
+        y = relay.nn.conv2d(
+            relay.cast(x, "float16"),
+            relay.cast(w, "float16"),
+            channels=8,
+            kernel_size=(3, 3),
+            padding=(1, 1),
+            out_dtype="float32",
+        )
+        y = relay.nn.softmax(relay.nn.relu(y))
+        return relay.Function([x, w], y)
+
+    opt_pass = transform.ToMixedPrecision("float16", deny_list=["nn.relu"])
+    after = run_opt_pass(conv_softmax(), opt_pass)
+    assert tvm.ir.structural_equal(after, run_infer_type(expected())), "Actual = \n" + str(after)
+
+
+def test_follow_inputs():
+    bias = np.random.uniform(size=(16,)).astype("float32")
+
+    def before():
+        x = relay.var("x", shape=(4, 16))
+        w = relay.var("w", shape=(16, 16))
+        b = relay.var("b", shape=(16,))
+        y = relay.nn.dense(x, w)
+        return relay.Function([x, w, b], relay.add(relay.add(y, relay.const(bias)), b))
+
+    def expected():
+        x = relay.var("x", shape=(4, 16))
+        w = relay.var("w", shape=(16, 16))
+        b = relay.var("b", shape=(16,))
+        y = relay.nn.dense(relay.cast(x, "float16"), relay.cast(w, "float16"), out_dtype="float32")
+        # The constant follows the dense, the variable does not.
+        y = relay.add(relay.cast(y, "float16"), relay.cast(relay.const(bias), "float16"))
+        return relay.Function([x, w, b], relay.add(relay.cast(y, "float32"), b))
+
+    after = run_opt_pass(before(), transform.ToMixedPrecision("float16"))
+    assert tvm.ir.structural_equal(after, run_infer_type(expected())), "Actual = \n" + str(after)
+
+
+def test_accumulation_dtype():
+    def before():
+        x = relay.var("x", shape=(2, 4, 16))
+        w = relay.var("w", shape=(2, 8, 16))
+        v = relay.var("v", shape=(8, 8))
+        y = relay.nn.batch_matmul(x, w)
+        return relay.Function([x, w, v], relay.nn.dense(relay.reshape(y, (8, 8)), v))
+
+    # dense accumulates in float32 through its out_dtype, batch_matmul has none
+    # and stays in float32, even when it is allowed.
+    for allow_list in [None, ["nn.batch_matmul"]]:
+        opt_pass = transform.ToMixedPrecision("float16", allow_list=allow_list)
+        after = run_opt_pass(before(), opt_pass)
+        calls = []
+        relay.analysis.post_order_visit(
+            after, lambda e: calls.append(e) if isinstance(e, relay.Call) else None
+        )
+        batch_matmul = [c for c in calls if c.op.name == "nn.batch_matmul"][0]
+        dense = [c for c in calls if c.op.name == "nn.dense"][0]
+        assert [a.checked_type.dtype for a in batch_matmul.args] == ["float32", "float32"]
+        assert batch_matmul.checked_type.dtype == "float32"
+        assert [a.checked_type.dtype for a in dense.args] == ["float16", "float16"]
+        assert dense.attrs.out_dtype == "float32"
+        assert dense.checked_type.dtype == "float32"
+
+
+def test_mixed_precision_result():
+    func = conv_softmax()
+    x = np.random.uniform(-1, 1, size=(1, 8, 16, 16)).astype("float32")
+    w = np.random.uniform(-1, 1, size=(8, 8, 3, 3)).astype("float32")
+    mod = tvm.IRModule.from_expr(func)
+    mixed_mod = transform.ToMixedPrecision("float16")(transform.InferType()(mod))
+    results = [
+        relay.create_executor("graph", mod=m).evaluate()(x, w).asnumpy() for m in [mod, mixed_mod]
+    ]
+    assert results[1].dtype == "float32"
+    np.testing.assert_allclose(results[0], results[1], rtol=1e-2, atol=1e-3)
+
+
+if __name__ == "__main__":
+    test_convert_conv_softmax()
+    test_deny_list()
+    test_follow_inputs()
+    test_accumulation_dtype()
+    test_mixed_precision_result()
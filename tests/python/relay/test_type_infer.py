@@ -416,6 +416,38 @@ def test_dynamic_function():
     assert mod["main"].params[0].checked_type == s_tt
 
 
+def test_incremental():
+    x = relay.var("x", shape=(10, 10))
+    y = relay.var("y", shape=(10, 10))
+    mod = tvm.IRModule()
+    mod["main"] = relay.Function([x], relay.nn.relu(x))
+    mod["other"] = relay.Function([y], relay.exp(y))
+
+    def infer(mod):
+        with tvm.transform.PassContext(config={"relay.InferType.incremental": True}):
+            return transform.InferType()(mod)
+
+    typed = infer(mod)
+    main, other = typed["main"], typed["other"]
+    # an unchanged module is not inferred again.
+    retyped = infer(typed)
+    assert retyped["main"].same_as(main)
+    assert retyped["other"].same_as(other)
+
+    # only the rewritten function is inferred, and its unchanged operands keep their types.
+    relu = main.body
+    retyped["main"] = relay.Function(main.params, relay.add(relu, relu))
+    retyped = infer(retyped)
+    assert retyped["other"].same_as(other)
+    assert retyped["main"].body.args[0].same_as(relu)
+    expected = transform.InferType()(tvm.IRModule(retyped.functions))
+    tvm.ir.assert_structural_equal(retyped["main"], expected["main"])
+    tvm.ir.assert_structural_equal(
+        retyped["main"].checked_type,
+        relay.FuncType([relay.TensorType((10, 10))], relay.TensorType((10, 10))),
+    )
+
+
 if __name__ == "__main__":
     import sys
 
@@ -328,6 +328,43 @@ def test_floormod_negative_divisor():
     assert bd.max_value == 6
 
 
+def test_memo_bound():
+    analyzer = tvm.arith.Analyzer()
+    analyzer.enable_memo()
+    x, y = te.var("x"), te.var("y")
+
+    bd = analyzer.const_int_bound(x + y)
+    assert bd.min_value == bd.NEG_INF
+    assert bd.max_value == bd.POS_INF
+
+    # the memo table is cleared when the bound of a var changes
+    analyzer.update(x, tvm.arith.ConstIntBound(0, 4))
+    analyzer.update(y, tvm.arith.ConstIntBound(1, 3))
+    bd = analyzer.const_int_bound(x + y)
+    assert bd.min_value == 1
+    assert bd.max_value == 7
+
+    # each constraint scope has its own memo table
+    with analyzer.constraint_scope(x < 2):
+        bd = analyzer.const_int_bound(x + y)
+        assert bd.min_value == 1
+        assert bd.max_value == 4
+        assert analyzer.simplify(tvm.te.floordiv(x, 2)).value == 0
+
+    bd = analyzer.const_int_bound(x + y)
+    assert bd.min_value == 1
+    assert bd.max_value == 7
+    assert not isinstance(analyzer.simplify(tvm.te.floordiv(x, 2)), tvm.tir.IntImm)
+
+    z = te.var("z")
+    assert not isinstance(analyzer.simplify(tvm.te.floordiv(z, 2)), tvm.tir.IntImm)
+    analyzer.bind(z, 3)
+    assert analyzer.simplify(tvm.te.floordiv(z, 2)).value == 1
+    bd = analyzer.const_int_bound(z + y)
+    assert bd.min_value == 4
+    assert bd.max_value == 6
+
+
 if __name__ == "__main__":
     test_let_bound()
     test_dtype_bound()
@@ -344,3 +381,4 @@ if __name__ == "__main__":
     test_mix_index_bound()
     test_size_var_bound()
     test_floormod_negative_divisor()
+    test_memo_bound()
@@ -17,6 +17,8 @@
 
 """ Test measurement and log serialization. """
 import json
+import random
+import time
 
 import multiprocessing
 import numpy as np
@@ -26,8 +28,9 @@ from tvm import te, auto_scheduler
 import tempfile
 import tvm.testing
 import pickle
-from test_auto_scheduler_common import matmul_auto_scheduler_test
+from test_auto_scheduler_common import matmul_auto_scheduler_test, softmax_nm_auto_scheduler_test
 from tvm.auto_scheduler import workload_registry
+from tvm.contrib import tar
 
 
 def record_common(dag, s):
@@ -257,6 +260,70 @@ def test_measure_local_builder_runner():
         assert mress[0].error_no == 0
 
 
+def test_measure_async_build_and_run():
+    if not tvm.testing.device_enabled("llvm"):
+        return
+
+    task = auto_scheduler.SearchTask(
+        func=matmul_auto_scheduler_test, args=(64, 64, 64), target="llvm"
+    )
+    policy = auto_scheduler.SketchPolicy(task, verbose=0)
+
+    # n_parallel=1 gives a batch size of 2, so 8 trials are measured in 4 pipelined batches
+    measurer = auto_scheduler.measure.ProgramMeasurer(
+        auto_scheduler.LocalBuilder(n_parallel=1),
+        auto_scheduler.LocalRunner(timeout=60),
+        [],
+        verbose=0,
+        async_queue_size=1,
+    )
+    inputs, results = policy.continue_search_one_round(8, measurer)
+    assert len(inputs) == len(results) == 8
+    for res in results:
+        assert res.error_no == 0
+
+
+def slow_tar(output, files):
+    """Pack a module after a random delay, so that the builds of a batch finish out of order."""
+    time.sleep(random.SystemRandom().uniform(0, 0.5))
+    tar.tar(output, files)
+
+
+slow_tar.output_format = "tar"
+
+
+def test_measure_async_build_out_of_order():
+    if not tvm.testing.device_enabled("llvm"):
+        return
+
+    task = auto_scheduler.SearchTask(
+        func=matmul_auto_scheduler_test, args=(64, 64, 64), target="llvm"
+    )
+    other_task = auto_scheduler.SearchTask(
+        func=softmax_nm_auto_scheduler_test, args=(64, 64), target="llvm"
+    )
+    policy = auto_scheduler.SketchPolicy(task, verbose=0)
+    good_states = policy.sample_initial_population()[:6]
+    # The steps of another workload cannot be applied to the task, so their builds fail
+    bad_states = auto_scheduler.SketchPolicy(other_task, verbose=0).sample_initial_population()[:6]
+    inputs, expect_valid = [], []
+    for i, (good, bad) in enumerate(zip(good_states, bad_states)):
+        states = [good, bad] if i % 2 == 0 else [bad, good]
+        inputs += [auto_scheduler.MeasureInput(task, state) for state in states]
+        expect_valid += [i % 2 == 0, i % 2 != 0]
+
+    # n_parallel=2 gives a batch size of 4, so 12 inputs are measured in 3 pipelined batches
+    measurer = auto_scheduler.measure.ProgramMeasurer(
+        auto_scheduler.LocalBuilder(n_parallel=2, build_func=slow_tar),
+        auto_scheduler.LocalRunner(timeout=60),
+        [],
+        verbose=0,
+        async_queue_size=2,
+    )
+    results = measurer.measure(task, policy, inputs)
+    assert [res.error_no == 0 for res in results] == expect_valid
+
+
 def test_dag_measure_local_builder_runner():
     if not tvm.testing.device_enabled("llvm"):
         return
@@ -422,6 +489,8 @@ if __name__ == "__main__":
     test_recover_measure_input()
     test_workload_dis_factor()
     test_measure_local_builder_runner()
+    test_measure_async_build_and_run()
+    test_measure_async_build_out_of_order()
     test_dag_measure_local_builder_runner()
     test_measure_local_builder_rpc_runner()
     test_measure_target_host()
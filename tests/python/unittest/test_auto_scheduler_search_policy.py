@@ -29,6 +29,7 @@ from tvm.auto_scheduler.utils import get_const_tuple
 
 from test_auto_scheduler_common import (
     matmul_auto_scheduler_test,
+    softmax_nm_auto_scheduler_test,
     zero_rank_compute_auto_scheduler_test,
     zero_rank_reduce_auto_scheduler_test,
 )
@@ -209,6 +210,63 @@ def test_sketch_search_policy_custom_sketch():
     )
 
 
+@tvm.testing.requires_llvm
+def test_sketch_search_policy_preload_similar_states():
+    with tempfile.NamedTemporaryFile() as fp:
+        log_file = fp.name
+
+        # Measure a few states of a smaller matmul
+        src_task = auto_scheduler.SearchTask(
+            func=matmul_auto_scheduler_test, args=(64, 64, 64), target="llvm"
+        )
+        src_task.tune(
+            auto_scheduler.TuningOptions(
+                num_measure_trials=4,
+                num_measures_per_round=2,
+                measure_callbacks=[auto_scheduler.RecordToFile(log_file)],
+            ),
+            search_policy=auto_scheduler.SketchPolicy(src_task, auto_scheduler.RandomModel()),
+        )
+
+        num_valid = sum(res.error_no == 0 for _, res in auto_scheduler.load_records(log_file))
+        assert num_valid > 0
+
+        # Warm-start a larger one from them
+        task = auto_scheduler.SearchTask(
+            func=matmul_auto_scheduler_test, args=(128, 96, 64), target="llvm"
+        )
+        # At most num_states of the valid records are transferred, and identical
+        # states after the adaptation of their split factors only once
+        num_loaded = []
+        for num_states in [1, 64]:
+            policy = auto_scheduler.SketchPolicy(
+                task,
+                auto_scheduler.RandomModel(),
+                init_search_callbacks=[auto_scheduler.PreloadSimilarStates(log_file, num_states)],
+            )
+            num_loaded.append(len(policy.transferred_states()))
+        assert num_loaded[0] == 1
+        assert 1 <= num_loaded[1] <= num_valid
+
+        # Nothing is transferred to a workload of another function
+        other_task = auto_scheduler.SearchTask(
+            func=softmax_nm_auto_scheduler_test, args=(64, 64), target="llvm"
+        )
+        policy = auto_scheduler.SketchPolicy(
+            other_task,
+            auto_scheduler.RandomModel(),
+            init_search_callbacks=[auto_scheduler.PreloadSimilarStates(log_file)],
+        )
+        assert len(policy.transferred_states()) == 0
+
+        search_common(
+            task=task,
+            num_measure_trials=4,
+            cost_model=auto_scheduler.XGBModel(),
+            init_search_callbacks=[auto_scheduler.PreloadSimilarStates(log_file)],
+        )
+
+
 if __name__ == "__main__":
     test_workload_registry_empty_policy()
     test_sketch_search_policy_basic()
@@ -218,3 +276,4 @@ if __name__ == "__main__":
     test_sketch_search_policy_cuda_xgbmodel_rpc_runner()
     test_sketch_search_policy_zero_rank()
     test_sketch_search_policy_custom_sketch()
+    test_sketch_search_policy_preload_similar_states()
@@ -126,6 +126,41 @@ def test_cpu_matmul_sketch():
     assert_is_tiled(sketches[8].stages[5])
 
 
+@auto_scheduler.register_workload
+def int8_dense_auto_scheduler_test(N, M, K):
+    A = te.placeholder((N, K), name="A", dtype="uint8")
+    B = te.placeholder((M, K), name="B", dtype="int8")
+    k = te.reduce_axis((0, K), name="k")
+    C = te.compute(
+        (N, M),
+        lambda i, j: te.sum(A[i][k].astype("int32") * B[j][k].astype("int32"), axis=[k]),
+        name="C",
+    )
+    return [A, B, C]
+
+
+def test_cpu_int8_dense_vnni_sketch():
+    sketches = generate_sketches(int8_dense_auto_scheduler_test, (128, 128, 128), "llvm")
+    """ 3 multi-level tiling sketches, same as the fp32 matmul """
+    assert len(sketches) == 3
+
+    sketches = generate_sketches(
+        int8_dense_auto_scheduler_test, (128, 128, 128), "llvm -mcpu=cascadelake"
+    )
+    """ 3 multi-level tiling sketches + 2 dot-product sketches (with and without cache write),
+        which keep a reduction iterator (the groups) and a space iterator (the lanes) innermost
+    """
+    assert len(sketches) == 5
+    vnni_sketches = [
+        sketch
+        for sketch in sketches
+        if [it.iter_kind for it in sketch.stages[2].iters[-2:]] == [1, 0]
+    ]
+    assert len(vnni_sketches) == 2
+    for sketch in vnni_sketches:
+        assert_is_tiled(sketch.stages[2])
+
+
 def test_cpu_conv2d_bn_relu_sketch():
     sketches = generate_sketches(
         conv2d_nchw_bn_relu_auto_scheduler_test, (1, 56, 56, 512, 512, 3, 1, 1), "llvm"
@@ -441,6 +476,7 @@ def test_cuda_zero_rank_sketch():
 
 if __name__ == "__main__":
     test_cpu_matmul_sketch()
+    test_cpu_int8_dense_vnni_sketch()
     test_cpu_conv2d_bn_relu_sketch()
     test_cpu_max_pool2d_sketch()
     test_cpu_min_sketch()
@@ -137,7 +137,154 @@ def test_task_scheduler_gradient():
         del measure_ctx
 
 
+def test_native_task_scheduler():
+    tasks = []
+    for n in [2, 4, 8]:
+        tasks.append(
+            auto_scheduler.SearchTask(
+                func=matmul_auto_scheduler_test, args=(n, n, n), target="llvm"
+            )
+        )
+
+    with tempfile.NamedTemporaryFile() as fp:
+        log_file = fp.name
+        num_trials_per_task = 2
+
+        # Tune all tasks
+        measure_ctx = auto_scheduler.LocalRPCMeasureContext()
+        tune_option = auto_scheduler.TuningOptions(
+            num_measure_trials=num_trials_per_task * len(tasks),
+            runner=measure_ctx.runner,
+            num_measures_per_round=1,
+            measure_callbacks=[auto_scheduler.RecordToFile(log_file)],
+        )
+        task_scheduler = auto_scheduler.NativeTaskScheduler(
+            tasks,
+            strategy="round-robin",
+            search_policy="sketch.random",
+            num_measures_per_round=1,
+        )
+        task_scheduler.tune(tune_option)
+
+        # Check the result of round robin
+        counters = {}
+        for task in tasks:
+            counters[task.workload_key] = 0
+
+        for inp, _ in auto_scheduler.load_records(log_file):
+            counters[inp.task.workload_key] += 1
+
+        for task in tasks:
+            assert counters[task.workload_key] == num_trials_per_task
+        assert len(task_scheduler.best_costs) == len(tasks)
+        del measure_ctx
+
+
+@tvm.testing.requires_llvm
+def test_native_task_scheduler_concurrent():
+    tasks = []
+    for n in [4, 8, 16]:
+        tasks.append(
+            auto_scheduler.SearchTask(
+                func=matmul_auto_scheduler_test, args=(n, n, n), target="llvm"
+            )
+        )
+
+    with tempfile.NamedTemporaryFile() as fp:
+        log_file = fp.name
+        num_trials_per_task = 3
+
+        # Tune two tasks at a time
+        measure_ctx = auto_scheduler.LocalRPCMeasureContext()
+        tune_option = auto_scheduler.TuningOptions(
+            num_measure_trials=num_trials_per_task * len(tasks),
+            runner=measure_ctx.runner,
+            num_measures_per_round=1,
+            measure_callbacks=[auto_scheduler.RecordToFile(log_file)],
+        )
+        task_scheduler = auto_scheduler.NativeTaskScheduler(
+            tasks,
+            strategy="round-robin",
+            num_parallel_tasks=2,
+            search_policy="sketch.random",
+            num_measures_per_round=1,
+        )
+        task_scheduler.tune(tune_option)
+
+        # Every task is measured once per round, and the budget is not exceeded
+        counters = {}
+        for task in tasks:
+            counters[task.workload_key] = 0
+
+        for inp, _ in auto_scheduler.load_records(log_file):
+            counters[inp.task.workload_key] += 1
+
+        assert sum(counters.values()) == num_trials_per_task * len(tasks)
+        for task in tasks:
+            assert counters[task.workload_key] >= 1
+        assert all(cost < 1e9 for cost in task_scheduler.best_costs)
+        del measure_ctx
+
+
+def _update_task(task_scheduler, task, task_idx, cost):
+    inp = auto_scheduler.MeasureInput(task, task.compute_dag.init_state)
+    res = auto_scheduler.MeasureResult([cost], 0, "", 0.1, 0)
+    task_scheduler.update_task(task_idx, [inp], [res])
+
+
+def test_native_task_scheduler_plateau():
+    task = auto_scheduler.SearchTask(func=matmul_auto_scheduler_test, args=(8, 8, 8), target="llvm")
+    task_scheduler = auto_scheduler.NativeTaskScheduler(
+        [task],
+        backward_window_size=2,
+        plateau_threshold=0.1,
+        search_policy="sketch.random",
+        verbose=0,
+    )
+
+    # Improved by 11% over the last two rounds
+    for cost in [1.0, 0.9, 0.89]:
+        _update_task(task_scheduler, task, 0, cost)
+    assert task_scheduler.dead_tasks == []
+
+    # Improved by 2% over the last two rounds
+    _update_task(task_scheduler, task, 0, 0.88)
+    assert task_scheduler.dead_tasks == [0]
+    assert task_scheduler.best_costs[0] == 0.88
+
+
+def test_native_task_scheduler_per_task_early_stopping():
+    tasks = []
+    for n in [4, 8]:
+        tasks.append(
+            auto_scheduler.SearchTask(
+                func=matmul_auto_scheduler_test, args=(n, n, n), target="llvm"
+            )
+        )
+    task_scheduler = auto_scheduler.NativeTaskScheduler(
+        tasks,
+        per_task_early_stopping=2,
+        search_policy="sketch.random",
+        verbose=0,
+    )
+
+    # Task 0 does not improve after its first round, while task 1 keeps improving
+    for i in range(3):
+        _update_task(task_scheduler, tasks[0], 0, 1.0)
+        _update_task(task_scheduler, tasks[1], 1, 1.0 / (i + 1))
+    assert task_scheduler.dead_tasks == []
+
+    # 3 trials without improvement exceed the limit of 2
+    _update_task(task_scheduler, tasks[0], 0, 1.0)
+    _update_task(task_scheduler, tasks[1], 1, 0.2)
+    assert task_scheduler.dead_tasks == [0]
+
+
 if __name__ == "__main__":
     test_task_scheduler_round_robin()
     test_task_scheduler_round_robin_spawn()
     test_task_scheduler_gradient()
+    test_native_task_scheduler()
+    test_native_task_scheduler_concurrent()
+    test_native_task_scheduler_plateau()
+    test_native_task_scheduler_per_task_early_stopping()
@@ -651,6 +651,78 @@ def test_dwarf_debug_information():
     check_llvm_ir()
 
 
+@tvm.testing.requires_llvm
+def test_llvm_gather_scatter():
+    n = 64
+    A = te.placeholder((n,), name="A")
+    Idx = te.placeholder((n,), name="Idx", dtype="int32")
+    B = te.compute((n,), lambda i: A[Idx[i]] * 2, name="B")
+    s = te.create_schedule(B.op)
+    _, xi = s[B].split(B.op.axis[0], factor=8)
+    s[B].vectorize(xi)
+    # gathers are only emitted when enabled.
+    f = tvm.build(s, [A, Idx, B], "llvm")
+    assert "llvm.masked.gather" not in f.get_source("ll")
+    with tvm.transform.PassContext(config={"tir.enable_vectorize_gather": True}):
+        f = tvm.build(s, [A, Idx, B], "llvm")
+    assert "llvm.masked.gather" in f.get_source("ll")
+
+    dev = tvm.cpu(0)
+    a = np.random.uniform(size=n).astype(A.dtype)
+    idx = np.random.randint(0, n, size=n).astype(Idx.dtype)
+    b = tvm.nd.empty((n,), B.dtype, dev)
+    f(tvm.nd.array(a, dev), tvm.nd.array(idx, dev), b)
+    tvm.testing.assert_allclose(b.asnumpy(), a[idx] * 2)
+
+
+@tvm.testing.requires_llvm
+def test_llvm_broadcast_index_load():
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, 4, name="i") as i:
+        index = tvm.tir.Ramp(i * 8, 1, 8)
+        B[index] = tvm.tir.Load("float32x8", A.asobject(), tvm.tir.Broadcast(i, 8))
+    func = tvm.tir.PrimFunc([A.asobject(), B.asobject()], ib.get())
+    mod = tvm.IRModule.from_expr(func.with_attr("global_symbol", "main"))
+    # a broadcast index is loaded lane by lane, with or without gathers.
+    for enable_gather in [False, True]:
+        with tvm.transform.PassContext(config={"tir.enable_vectorize_gather": enable_gather}):
+            ll = tvm.build(mod, None, "llvm").get_source("ll")
+        assert "llvm.masked.gather" not in ll
+
+    dev = tvm.cpu(0)
+    a = np.random.uniform(size=4).astype("float32")
+    b = tvm.nd.empty((32,), "float32", dev)
+    tvm.build(mod, None, "llvm")(tvm.nd.array(a, dev), b)
+    tvm.testing.assert_allclose(b.asnumpy(), np.repeat(a, 8))
+
+
+@tvm.testing.requires_llvm
+def test_llvm_predicated_vectorize():
+    n = 30
+    A = te.placeholder((n,), name="A")
+    # boundary padding, as in a padded convolution.
+    B = te.compute(
+        (n + 2,),
+        lambda i: tvm.tir.if_then_else(tvm.tir.all(i >= 1, i < n + 1), A[i - 1], 0.0),
+        name="B",
+    )
+    s = te.create_schedule(B.op)
+    _, xi = s[B].split(B.op.axis[0], factor=8)
+    s[B].vectorize(xi)
+    config = {"tir.VectorizeLoop": {"enable_predication": True}}
+    with tvm.transform.PassContext(config=config):
+        f = tvm.build(s, [A, B], "llvm")
+    assert "llvm.masked.load" in f.get_source("ll")
+
+    dev = tvm.cpu(0)
+    a = np.random.uniform(size=n).astype(A.dtype)
+    b = tvm.nd.empty((n + 2,), B.dtype, dev)
+    f(tvm.nd.array(a, dev), b)
+    tvm.testing.assert_allclose(b.asnumpy(), np.pad(a, 1))
+
+
 @tvm.testing.requires_llvm
 def test_llvm_shuffle():
     a = te.placeholder((8,), "int32")
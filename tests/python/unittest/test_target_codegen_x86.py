@@ -63,5 +63,59 @@ def test_fp16_to_fp32():
     fp16_to_fp32("llvm", 9, not_match="vcvtph2ps")
 
 
+def test_int8_dot_product_vnni():
+    if tvm.target.codegen.llvm_version_major() < 8:
+        print(
+            "Skipping due to LLVM version being {} < 8".format(
+                tvm.target.codegen.llvm_version_major()
+            )
+        )
+        return
+
+    import platform
+
+    machine = platform.machine()
+    if machine not in ["x86_64", "i386", "AMD64"]:
+        print("Skipping test because the platform is: {} ".format(machine))
+        return
+
+    def int8_dense(target, lhs_dtype, rhs_dtype, factor, unroll, match=None, not_match=None):
+        n, m, l = 4, 32, 64
+        A = te.placeholder((n, l), dtype=lhs_dtype, name="A")
+        B = te.placeholder((m, l), dtype=rhs_dtype, name="B")
+        k = te.reduce_axis((0, l), name="k")
+        C = te.compute(
+            (n, m),
+            lambda i, j: te.sum(A[i, k].astype("int32") * B[j, k].astype("int32"), axis=k),
+            name="C",
+        )
+        s = te.create_schedule(C.op)
+        i, j = s[C].op.axis
+        jo, ji = s[C].split(j, factor=16)
+        ko, ki = s[C].split(k, factor=factor)
+        s[C].reorder(i, jo, ko, ki, ji)
+        s[C].vectorize(ji)
+        s[C].pragma(ki, "x86_vnni")
+        if unroll:
+            s[C].unroll(ki)
+        f = tvm.build(s, [A, B, C], target)
+
+        assembly = f.get_source("asm").splitlines()
+        if match:
+            matches = [l for l in assembly if re.search(match, l)]
+            assert matches
+        if not_match:
+            not_matches = [l for l in assembly if re.search(not_match, l)]
+            assert not not_matches
+
+    int8_dense("llvm -mcpu=cascadelake", "uint8", "int8", 4, False, match="vpdpbusd")
+    int8_dense("llvm -mcpu=cascadelake", "int8", "uint8", 4, True, match="vpdpbusd")
+    int8_dense("llvm -mcpu=cascadelake", "uint8", "int8", 8, False, match="vpdpbusd")
+    int8_dense("llvm -mcpu=cascadelake", "uint8", "int8", 2, False, not_match="vpdpbusd")
+    int8_dense("llvm -mcpu=cascadelake", "int8", "int8", 4, False, not_match="vpdpbusd")
+    int8_dense("llvm -mcpu=skylake-avx512", "uint8", "int8", 4, False, not_match="vpdpbusd")
+
+
 if __name__ == "__main__":
     test_fp16_to_fp32()
+    test_int8_dot_product_vnni()
@@ -0,0 +1,165 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import tvm
+import tvm.testing
+from tvm import te
+
+
+def run_pass(stmt, args, config=None):
+    func = tvm.tir.PrimFunc(args, stmt)
+    mod = tvm.IRModule.from_expr(func)
+    with tvm.transform.PassContext(config={"tir.IndexStrengthReduction": config or {}}):
+        mod = tvm.tir.transform.IndexStrengthReduction()(mod)
+    return mod["main"].body
+
+
+def count_divmod(stmt):
+    count = [0]
+
+    def _visit(op):
+        if isinstance(op, (tvm.tir.FloorDiv, tvm.tir.FloorMod)):
+            count[0] += 1
+
+    tvm.tir.stmt_functor.post_order_visit(stmt, _visit)
+    return count[0]
+
+
+def find_loop(stmt, name):
+    loops = []
+
+    def _visit(op):
+        if isinstance(op, tvm.tir.For) and op.loop_var.name == name:
+            loops.append(op)
+
+    tvm.tir.stmt_functor.post_order_visit(stmt, _visit)
+    return loops[0]
+
+
+def test_hoist_invariant():
+    ib = tvm.tir.ir_builder.create()
+    n = te.size_var("n")
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, n, name="i") as i:
+        with ib.for_range(0, n, name="j") as j:
+            B[i * n + tvm.tir.floordiv(i, 3) * 7 + j] = A[j]
+    stmt = run_pass(ib.get(), [A.asobject(), B.asobject(), n])
+
+    inner = stmt.body
+    assert isinstance(inner, tvm.tir.LetStmt)
+    assert isinstance(inner.body, tvm.tir.For)
+    store = inner.body.body
+    assert isinstance(store.index, tvm.tir.Add)
+    assert store.index.a.same_as(inner.var)
+    assert count_divmod(inner.body) == 0
+
+
+def test_reduce_divmod():
+    ib = tvm.tir.ir_builder.create()
+    n = te.size_var("n")
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, n, name="i") as i:
+        B[tvm.tir.floordiv(i, 7) * 8 + tvm.tir.floormod(i, 7)] = A[i]
+    stmt = run_pass(ib.get(), [A.asobject(), B.asobject(), n])
+
+    # the quotient and the remainder share a counter.
+    assert isinstance(stmt, tvm.tir.AttrStmt)
+    assert isinstance(stmt.body, tvm.tir.Allocate)
+    loop = find_loop(stmt, "i")
+    assert count_divmod(loop) == 0
+    assert isinstance(loop.body[-1], tvm.tir.IfThenElse)
+
+    # the divisors of powers of two are left to the backend.
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, n, name="i") as i:
+        B[tvm.tir.floordiv(i, 8) * 9 + tvm.tir.floormod(i, 8)] = A[i]
+    stmt = run_pass(ib.get(), [A.asobject(), B.asobject(), n])
+    assert isinstance(stmt, tvm.tir.For)
+    assert count_divmod(stmt) == 2
+    stmt = run_pass(ib.get(), [A.asobject(), B.asobject(), n], {"reduce_power_of_two": True})
+    assert count_divmod(find_loop(stmt, "i")) == 0
+
+
+def test_non_affine():
+    ib = tvm.tir.ir_builder.create()
+    n = te.size_var("n")
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, n, name="i") as i:
+        B[i] = A[tvm.tir.floordiv(i * i, 7)]
+    stmt = run_pass(ib.get(), [A.asobject(), B.asobject(), n])
+    assert isinstance(stmt, tvm.tir.For)
+    assert count_divmod(stmt) == 1
+
+
+@tvm.testing.requires_llvm
+def test_build_layout_transform():
+    n, c, h, w = 1, 30, 14, 14
+    A = te.placeholder((n, c, h, w), name="A")
+    # NCHW -> NCHW3c, the fused spatial index is split back with div/mod.
+    B = te.compute(
+        (n, c // 3, h, w, 3), lambda i, co, y, x, ci: A[i, co * 3 + ci, y, x] * 2.0, name="B"
+    )
+    s = te.create_schedule(B.op)
+    fused = s[B].fuse(*s[B].op.axis)
+    s[B].split(fused, factor=3 * w * 5)
+    a = np.random.uniform(size=(n, c, h, w)).astype("float32")
+    expected = (a * 2.0).reshape(n, c // 3, 3, h, w).transpose(0, 1, 3, 4, 2)
+
+    dev = tvm.cpu(0)
+    for config in [{}, {"reduce_power_of_two": True}]:
+        pass_config = {
+            "tir.enable_index_strength_reduction": True,
+            "tir.IndexStrengthReduction": config,
+        }
+        with tvm.transform.PassContext(config=pass_config):
+            f = tvm.build(s, [A, B], "llvm")
+        b = tvm.nd.empty(expected.shape, "float32", dev)
+        f(tvm.nd.array(a, dev), b)
+        tvm.testing.assert_allclose(b.asnumpy(), expected)
+
+
+@tvm.testing.requires_llvm
+def test_build_strided():
+    m = 100
+    A = te.placeholder((3 * m + 2,), name="A")
+    B = te.compute(
+        (m,),
+        lambda i: A[tvm.tir.floordiv(i * 3 + 2, 7)] + A[tvm.tir.floormod(i * 3 + 2, 7) + 5 * i],
+        name="B",
+    )
+    s = te.create_schedule(B.op)
+    with tvm.transform.PassContext(config={"tir.enable_index_strength_reduction": True}):
+        f = tvm.build(s, [A, B], "llvm")
+    dev = tvm.cpu(0)
+    a = np.random.uniform(size=(3 * m + 2,)).astype("float32")
+    b = tvm.nd.empty((m,), "float32", dev)
+    f(tvm.nd.array(a, dev), b)
+    i = np.arange(m)
+    tvm.testing.assert_allclose(b.asnumpy(), a[(i * 3 + 2) // 7] + a[(i * 3 + 2) % 7 + 5 * i])
+
+
+if __name__ == "__main__":
+    test_hoist_invariant()
+    test_reduce_divmod()
+    test_non_affine()
+    test_build_layout_transform()
+    test_build_strided()
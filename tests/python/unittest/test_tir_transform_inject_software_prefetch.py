@@ -0,0 +1,133 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import tvm
+import tvm.testing
+from tvm import te
+
+
+def run_prefetch(stmt, args, target="llvm", config=None):
+    func = tvm.tir.PrimFunc(args, stmt).with_attr("target", tvm.target.Target(target))
+    mod = tvm.IRModule.from_expr(func)
+    with tvm.transform.PassContext(config={"tir.InjectSoftwarePrefetch": config or {}}):
+        mod = tvm.tir.transform.InjectSoftwarePrefetch()(mod)
+    return mod["main"].body
+
+
+def collect_prefetch(stmt):
+    prefetch = []
+
+    def _visit(op):
+        if isinstance(op, tvm.tir.Call) and op.op.same_as(tvm.ir.Op.get("tir.prefetch")):
+            prefetch.append(op)
+
+    tvm.tir.stmt_functor.post_order_visit(stmt, _visit)
+    return prefetch
+
+
+def test_strided_load():
+    n = 1024
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, n, name="i") as i:
+        with ib.for_range(0, n, name="j") as j:
+            B[i] = B[i] + A[j * n + i]
+    stmt = run_prefetch(ib.get(), [A.asobject(), B.asobject()])
+
+    prefetch = collect_prefetch(stmt)
+    assert len(prefetch) == 1
+    load = prefetch[0].args[0].args[0]
+    assert load.buffer_var.same_as(A.asobject())
+    analyzer = tvm.arith.Analyzer()
+    j = stmt.body.loop_var
+    i = stmt.loop_var
+    assert analyzer.simplify(load.index - ((j + 16) * n + i)).value == 0
+
+    # a smaller distance.
+    stmt = run_prefetch(ib.get(), [A.asobject(), B.asobject()], config={"distance": 4})
+    load = collect_prefetch(stmt)[0].args[0].args[0]
+    j, i = stmt.body.loop_var, stmt.loop_var
+    assert analyzer.simplify(load.index - ((j + 4) * n + i)).value == 0
+
+
+def test_unit_stride_load():
+    n = 1024
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, n, name="i") as i:
+        B[i] = A[i] + A[i + 1]
+    stmt = run_prefetch(ib.get(), [A.asobject(), B.asobject()])
+    # left to the hardware prefetcher.
+    assert len(collect_prefetch(stmt)) == 0
+
+
+def test_indirect_load():
+    n = 1024
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    Idx = ib.pointer("int32", name="Idx")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, n, name="i") as i:
+        B[i] = A[Idx[i] * 64]
+        with ib.if_scope(i > 2):
+            B[i] = B[i] + A[Idx[i - 1]]
+    stmt = run_prefetch(ib.get(), [A.asobject(), Idx.asobject(), B.asobject()])
+
+    # only the unconditional indirect load is prefetched, under the loop bound.
+    prefetch = collect_prefetch(stmt)
+    assert len(prefetch) == 1
+    guard = stmt.body[0]
+    assert isinstance(guard, tvm.tir.IfThenElse)
+    assert prefetch[0].args[0].args[0].buffer_var.same_as(A.asobject())
+
+
+def test_non_llvm_target():
+    n = 1024
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, n, name="i") as i:
+        B[i] = A[i * n]
+    stmt = run_prefetch(ib.get(), [A.asobject(), B.asobject()], target="c")
+    assert len(collect_prefetch(stmt)) == 0
+
+
+@tvm.testing.requires_llvm
+def test_build_column_sum():
+    n = 256
+    A = te.placeholder((n, n), name="A")
+    k = te.reduce_axis((0, n), name="k")
+    B = te.compute((n,), lambda i: te.sum(A[k, i], axis=k), name="B")
+    s = te.create_schedule(B.op)
+
+    with tvm.transform.PassContext(config={"tir.enable_software_prefetch": True}):
+        f = tvm.build(s, [A, B], "llvm")
+    dev = tvm.cpu(0)
+    a = np.random.uniform(size=(n, n)).astype("float32")
+    b = tvm.nd.empty((n,), "float32", dev)
+    f(tvm.nd.array(a, dev), b)
+    tvm.testing.assert_allclose(b.asnumpy(), a.sum(axis=0), rtol=1e-5)
+
+
+if __name__ == "__main__":
+    test_strided_load()
+    test_unit_stride_load()
+    test_indirect_load()
+    test_non_llvm_target()
+    test_build_column_sum()
@@ -0,0 +1,171 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import tvm
+import tvm.testing
+from tvm import te
+from tvm.contrib import utils
+
+
+def run_loop_profile(stmt, args, config):
+    func = tvm.tir.PrimFunc(args, stmt).with_attr("global_symbol", "main")
+    mod = tvm.IRModule.from_expr(func)
+    with tvm.transform.PassContext(config={"tir.LoopProfile": config}):
+        mod = tvm.tir.transform.LoopProfile()(mod)
+    return mod["main"].body
+
+
+def collect_extern(stmt):
+    calls = []
+
+    def _visit(op):
+        if isinstance(op, tvm.tir.Call) and op.op.same_as(tvm.ir.Op.get("tir.call_extern")):
+            calls.append((op.args[0].value, op.args[1].value))
+
+    tvm.tir.stmt_functor.post_order_visit(stmt, _visit)
+    return calls
+
+
+def nested_loops():
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    n = te.size_var("n")
+    with ib.for_range(0, n, name="i") as i:
+        with ib.for_range(0, 4, name="j") as j:
+            A[i * 4 + j] = A[i * 4 + j] + 1.0
+        with ib.for_range(0, 8, name="k") as k:
+            with ib.if_scope(tvm.tir.likely(i * 8 + k < n)):
+                A[i * 8 + k] = 0.0
+    return ib.get(), [A.asobject(), n]
+
+
+def test_instrument():
+    stmt, args = nested_loops()
+    stmt = run_loop_profile(stmt, args, {"instrument": True})
+    calls = collect_extern(stmt)
+    keys = ["main/0:i", "main/1:j", "main/2:k"]
+    assert sorted(calls) == sorted(
+        [("TVMBackendLoopProfileEnter", key) for key in keys]
+        + [("TVMBackendLoopProfileExit", key) for key in keys]
+    )
+    assert isinstance(stmt, tvm.tir.LetStmt)
+    assert isinstance(stmt.body[0], tvm.tir.For)
+
+
+def test_instrument_skip_vectorized():
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    with ib.for_range(0, 16, name="i") as i:
+        with ib.for_range(0, 4, name="j", kind="vectorize") as j:
+            with ib.for_range(0, 2, name="k") as k:
+                A[i * 8 + j * 2 + k] = 0.0
+    stmt = run_loop_profile(ib.get(), [A.asobject()], {"instrument": True})
+    keys = {key for _, key in collect_extern(stmt)}
+    assert keys == {"main/0:i", "main/1:j"}
+
+
+def test_apply_profile():
+    stmt, args = nested_loops()
+    profile = {
+        "main/0:i": [1.0, 1000.0, 1e6],
+        "main/1:j": [1000.0, 4000.0, 5e5],
+        "main/2:k": [1000.0, 8000.0, 1e3],
+    }
+    stmt = run_loop_profile(stmt, args, {"profile": profile})
+    # the hot innermost loop is unrolled.
+    j_loop = stmt.body[0]
+    assert j_loop.kind == tvm.tir.ForKind.UNROLLED
+    # the cold loop is neither unrolled nor partitioned.
+    k_attr = stmt.body[1]
+    assert isinstance(k_attr, tvm.tir.AttrStmt)
+    assert k_attr.attr_key == "pragma_auto_unroll_max_step"
+    assert k_attr.value.value == 0
+    assert k_attr.body.annotations["pragma_loop_partition"].value == 0
+    # the hot outer loop with a likely condition is partitioned.
+    assert stmt.kind == tvm.tir.ForKind.SERIAL
+    assert stmt.annotations["pragma_loop_partition"].value == 1
+
+    # the profile of another function is ignored.
+    stmt, args = nested_loops()
+    profile = {"other/0:i": [1.0, 1000.0, 1e6]}
+    stmt = run_loop_profile(stmt, args, {"profile": profile})
+    assert stmt.body[0].kind == tvm.tir.ForKind.SERIAL
+    assert "pragma_loop_partition" not in stmt.annotations
+
+
+@tvm.testing.requires_llvm
+def test_profile_guided_build():
+    n = 64
+    A = te.placeholder((n, n), name="A")
+    k = te.reduce_axis((0, n), name="k")
+    B = te.compute((n,), lambda i: te.sum(A[i, k], axis=k), name="B")
+    s = te.create_schedule(B.op)
+    dev = tvm.cpu(0)
+    a = np.random.uniform(size=(n, n)).astype("float32")
+
+    with tvm.transform.PassContext(config={"tir.LoopProfile": {"instrument": True}}):
+        f = tvm.build(s, [A, B], "llvm")
+    tvm.tir.loop_profile.reset()
+    b = tvm.nd.empty((n,), "float32", dev)
+    f(tvm.nd.array(a, dev), b)
+    tvm.testing.assert_allclose(b.asnumpy(), a.sum(axis=1), rtol=1e-5)
+
+    profile = tvm.tir.loop_profile.collect()
+    assert profile["default_function/0:i"][:2] == [1, n]
+    assert profile["default_function/1:k"][:2] == [n, n * n]
+    path = utils.tempdir().relpath("profile.json")
+    tvm.tir.loop_profile.save(path)
+    profile = tvm.tir.loop_profile.load(path)
+
+    with tvm.transform.PassContext(config={"tir.LoopProfile": {"profile": profile}}):
+        f = tvm.build(s, [A, B], "llvm")
+    b = tvm.nd.empty((n,), "float32", dev)
+    f(tvm.nd.array(a, dev), b)
+    tvm.testing.assert_allclose(b.asnumpy(), a.sum(axis=1), rtol=1e-5)
+
+
+@tvm.testing.requires_llvm
+def test_profile_parallel_and_unloaded_modules():
+    n = 64
+    A = te.placeholder((n, n), name="A")
+    k = te.reduce_axis((0, n), name="k")
+    B = te.compute((n,), lambda i: te.sum(A[i, k], axis=k), name="B")
+    s = te.create_schedule(B.op)
+    s[B].parallel(B.op.axis[0])
+    dev = tvm.cpu(0)
+    a = np.random.uniform(size=(n, n)).astype("float32")
+
+    tvm.tir.loop_profile.reset()
+    for _ in range(2):
+        with tvm.transform.PassContext(config={"tir.LoopProfile": {"instrument": True}}):
+            f = tvm.build(s, [A, B], "llvm")
+        b = tvm.nd.empty((n,), "float32", dev)
+        f(tvm.nd.array(a, dev), b)
+        tvm.testing.assert_allclose(b.asnumpy(), a.sum(axis=1), rtol=1e-5)
+        del f
+
+    # the counters of the threads and of both modules are merged after the modules are gone.
+    profile = tvm.tir.loop_profile.collect()
+    assert profile["default_function/1:k"][:2] == [2 * n, 2 * n * n]
+
+
+if __name__ == "__main__":
+    test_instrument()
+    test_instrument_skip_vectorized()
+    test_apply_profile()
+    test_profile_guided_build()
+    test_profile_parallel_and_unloaded_modules()
@@ -0,0 +1,115 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import tvm
+import tvm.testing
+from tvm import te
+
+
+def run_loop_tiling(s, args, config=None):
+    mod = tvm.driver.build_module.form_irmodule(s, args, "main", None)
+    with tvm.transform.PassContext(config={"tir.LoopTiling": config or {}}):
+        mod = tvm.tir.transform.LoopTiling()(mod)
+    return mod["main"].body
+
+
+def collect_loops(stmt):
+    loops = []
+
+    def _visit(op):
+        if isinstance(op, tvm.tir.For):
+            loops.append((op.loop_var.name, op.extent.value))
+
+    tvm.tir.stmt_functor.post_order_visit(stmt, _visit)
+    return list(reversed(loops))
+
+
+def test_transpose():
+    n = 1024
+    A = te.placeholder((n, n), name="A")
+    B = te.compute((n, n), lambda i, j: A[j, i], name="B")
+    s = te.create_schedule(B.op)
+
+    loops = collect_loops(run_loop_tiling(s, [A, B]))
+    names = [name for name, _ in loops]
+    assert names[0] == "i.outer" and names[-1] == "j.inner"
+    # the tiles of both loops fit into the L1 cache.
+    extents = dict(loops)
+    assert extents["i.inner"] * extents["j.inner"] * 4 * 2 <= 32768
+
+    config = {"l1_cache_bytes": 1 << 24, "l2_cache_bytes": 1 << 24}
+    loops = collect_loops(run_loop_tiling(s, [A, B], config))
+    assert [name for name, _ in loops] == ["i", "j"]
+
+
+def test_reduction():
+    n = 512
+    A = te.placeholder((n, n), name="A")
+    B = te.placeholder((n, n), name="B")
+    k = te.reduce_axis((0, n), name="k")
+    C = te.compute((n, n), lambda i, j: te.sum(A[i, k] * B[k, j], axis=k), name="C")
+    s = te.create_schedule(C.op)
+
+    loops = collect_loops(run_loop_tiling(s, [A, B, C]))
+    names = [name for name, _ in loops]
+    assert names[0] == "i.outer"
+    assert "i.inner" in names and "j.inner" in names
+    # the reduction loop is not part of the perfectly nested band.
+    assert "k" in names
+
+
+def test_skip_accumulation():
+    n = 256
+    A = te.placeholder((n, n), name="A")
+    k = te.reduce_axis((0, n), name="k")
+    r = te.reduce_axis((0, n), name="r")
+    B = te.compute((1,), lambda i: te.sum(A[k, r], axis=[k, r]), name="B")
+    s = te.create_schedule(B.op)
+
+    loops = collect_loops(run_loop_tiling(s, [A, B], {"l1_cache_bytes": 1024}))
+    names = [name for name, _ in loops]
+    # only the outer accumulation loop can be tiled without changing the order of the sum.
+    assert "r" in names
+    assert "r.inner" not in names and "r.outer" not in names
+
+
+@tvm.testing.requires_llvm
+def test_build():
+    n = 256
+    A = te.placeholder((n, n), name="A")
+    B = te.placeholder((n, n), name="B")
+    k = te.reduce_axis((0, n), name="k")
+    C = te.compute((n, n), lambda i, j: te.sum(A[i, k] * B[k, j], axis=k), name="C")
+    D = te.compute((n, n), lambda i, j: C[j, i] + 1, name="D")
+    s = te.create_schedule(D.op)
+
+    config = {"tir.enable_loop_tiling": True, "tir.LoopTiling": {"l1_cache_bytes": 4096}}
+    with tvm.transform.PassContext(config=config):
+        f = tvm.build(s, [A, B, D], "llvm")
+    dev = tvm.cpu(0)
+    a = np.random.uniform(size=(n, n)).astype("float32")
+    b = np.random.uniform(size=(n, n)).astype("float32")
+    d = tvm.nd.empty((n, n), "float32", dev)
+    f(tvm.nd.array(a, dev), tvm.nd.array(b, dev), d)
+    tvm.testing.assert_allclose(d.asnumpy(), np.dot(a, b).T + 1, rtol=1e-5)
+
+
+if __name__ == "__main__":
+    test_transpose()
+    test_reduction()
+    test_skip_accumulation()
+    test_build()
@@ -133,9 +133,27 @@ def test_complex_likely_elimination():
     assert "if" not in str(stmt)
 
 
+def test_simplify_with_memo():
+    data = te.placeholder((1, 16, 30, 30), name="data")
+    kernel = te.placeholder((32, 16, 3, 3), name="kernel")
+    conv = tvm.topi.nn.conv2d_nchw(data, kernel, 1, 1, 1)
+    s = te.create_schedule(conv.op)
+    n, f, y, x = s[conv].op.axis
+    fo, fi = s[conv].split(f, factor=8)
+    xo, xi = s[conv].split(x, factor=7)
+    s[conv].reorder(n, fo, y, xo, fi, xi)
+    s[s[conv].op.input_tensors[0]].compute_at(s[conv], xo)
+
+    mod = tvm.lower(s, [data, kernel, conv], simple_mode=True)
+    with tvm.transform.PassContext(config={"tir.Simplify": {"enable_memo": True}}):
+        mod_memo = tvm.lower(s, [data, kernel, conv], simple_mode=True)
+    tvm.ir.assert_structural_equal(mod, mod_memo)
+
+
 if __name__ == "__main__":
     test_stmt_simplify()
     test_thread_extent_simplify()
     test_if_likely()
     test_basic_likely_elimination()
     test_complex_likely_elimination()
+    test_simplify_with_memo()
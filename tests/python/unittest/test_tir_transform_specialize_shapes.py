@@ -0,0 +1,135 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import tvm
+import tvm.testing
+from tvm import te
+
+
+def vector_add():
+    n = te.var("n")
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i] * 2.0, name="B")
+    s = te.create_schedule(B.op)
+    _, xi = s[B].split(B.op.axis[0], factor=8)
+    s[B].vectorize(xi)
+    return s, [A, B]
+
+
+def local_let_kernel():
+    n = te.var("n")
+    A = tvm.tir.decl_buffer((n,), "float32", name="A")
+    B = tvm.tir.decl_buffer((n,), "float32", name="B")
+    ib = tvm.tir.ir_builder.create()
+    Ap = ib.buffer_ptr(A)
+    Bp = ib.buffer_ptr(B)
+    tmp = ib.allocate("float32", (1,), name="tmp", scope="local")
+    with ib.for_range(0, n, "i") as i:
+        x = te.var("x", "float32")
+        ib.emit(lambda body: tvm.tir.LetStmt(x, Ap[i] * 2.0, body))
+        tmp[0] = x + 1.0
+        Bp[i] = tmp[0]
+    func = tvm.tir.PrimFunc([A, B], ib.get()).with_attr("global_symbol", "main")
+    return tvm.IRModule({"main": func})
+
+
+def collect_dispatch(stmt):
+    dispatch = []
+
+    def _visit(op):
+        if isinstance(op, tvm.tir.IfThenElse) and op.else_case is not None:
+            dispatch.append(op)
+
+    tvm.tir.stmt_functor.post_order_visit(stmt, _visit)
+    return dispatch
+
+
+def test_no_config():
+    s, args = vector_add()
+    body = tvm.lower(s, args)["main"].body
+    assert not collect_dispatch(body)
+
+
+def test_dispatch():
+    s, args = vector_add()
+    config = {"tir.SpecializeShapes": {"hot_values": {"n": [64]}, "divisors": [8]}}
+    with tvm.transform.PassContext(config=config):
+        body = tvm.lower(s, args)["main"].body
+
+    dispatch = collect_dispatch(body)
+    assert len(dispatch) == 2
+    hot, divisible = dispatch[1], dispatch[0]
+    assert isinstance(hot.condition, tvm.tir.EQ) and hot.condition.b.value == 64
+    assert isinstance(divisible.condition.a, tvm.tir.FloorMod)
+    assert divisible.condition.a.b.value == 8
+    # the variant for n == 64 has no loop tail.
+    hot = hot.then_case
+
+    def _visit(op):
+        assert not isinstance(op, tvm.tir.IfThenElse)
+
+    tvm.tir.stmt_functor.post_order_visit(hot, _visit)
+
+    # the number of variants is bounded.
+    config["tir.SpecializeShapes"]["max_variants"] = 2
+    with tvm.transform.PassContext(config=config):
+        body = tvm.lower(s, args)["main"].body
+    assert not collect_dispatch(body)
+
+
+def test_hot_values():
+    samples = [{"n": 64}] * 6 + [{"n": 128}] * 3 + [{"n": 7}] + [{"m": 3}]
+    assert tvm.tir.shape_profile.hot_values(samples) == {"n": [64, 128], "m": [3]}
+    assert tvm.tir.shape_profile.hot_values(samples, max_values=1) == {"n": [64], "m": [3]}
+    assert tvm.tir.shape_profile.hot_values(samples, min_share=0.5) == {"n": [64], "m": [3]}
+
+
+@tvm.testing.requires_llvm
+def test_build():
+    s, args = vector_add()
+    config = {"tir.SpecializeShapes": {"hot_values": {"n": [64]}, "divisors": [8, 4]}}
+    with tvm.transform.PassContext(config=config):
+        f = tvm.build(s, args, "llvm")
+    dev = tvm.cpu(0)
+    for n in [64, 40, 12, 13]:
+        a = np.random.uniform(size=(n,)).astype("float32")
+        b = tvm.nd.empty((n,), "float32", dev)
+        f(tvm.nd.array(a, dev), b)
+        tvm.testing.assert_allclose(b.asnumpy(), a * 2.0)
+
+
+@tvm.testing.requires_llvm
+def test_build_local_buffer_and_let():
+    config = {"tir.SpecializeShapes": {"hot_values": {"n": [64]}, "divisors": [8]}}
+    with tvm.transform.PassContext(config=config):
+        mod = tvm.lower(local_let_kernel())
+        assert len(collect_dispatch(mod["main"].body)) == 2
+        f = tvm.build(mod, target="llvm")
+    dev = tvm.cpu(0)
+    for n in [64, 40, 13]:
+        a = np.random.uniform(size=(n,)).astype("float32")
+        b = tvm.nd.empty((n,), "float32", dev)
+        f(tvm.nd.array(a, dev), b)
+        tvm.testing.assert_allclose(b.asnumpy(), a * 2.0 + 1.0)
+
+
+if __name__ == "__main__":
+    test_no_config()
+    test_dispatch()
+    test_hot_values()
+    test_build()
+    test_build_local_buffer_and_let()
@@ -158,6 +158,68 @@ def test_vectorize_if_then_else():
     assert isinstance(stmt.body.value.args[2], tvm.tir.Broadcast)
 
 
+def test_vectorize_if_then_else_predicated():
+    n = te.var("n")
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, 4, kind="vectorize") as i:
+        B[i] = tvm.tir.call_intrin("float32", "tir.if_then_else", i < n, A[i], 0)
+    stmt = ib.get()
+
+    mod = tvm.IRModule.from_expr(tvm.tir.PrimFunc([A, B, n], stmt))
+    with tvm.transform.PassContext(config={"tir.VectorizeLoop": {"enable_predication": True}}):
+        stmt = tvm.tir.transform.VectorizeLoop()(mod)["main"].body
+
+    assert isinstance(stmt, tvm.tir.Store)
+    assert isinstance(stmt.value, tvm.tir.Select)
+    load = stmt.value.true_value
+    assert isinstance(load, tvm.tir.Load) and load.dtype == "float32x4"
+    assert tvm.ir.structural_equal(load.predicate, stmt.value.condition)
+
+    # an integer division may trap in the disabled lanes.
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("int32", name="A")
+    B = ib.pointer("int32", name="B")
+    with ib.for_range(0, 4, kind="vectorize") as i:
+        B[i] = tvm.tir.call_intrin("int32", "tir.if_then_else", A[i] != 0, 64 // A[i], 0)
+    stmt = ib.get()
+
+    mod = tvm.IRModule.from_expr(tvm.tir.PrimFunc([A, B], stmt))
+    with tvm.transform.PassContext(config={"tir.VectorizeLoop": {"enable_predication": True}}):
+        stmt = tvm.tir.transform.VectorizeLoop()(mod)["main"].body
+    assert isinstance(stmt, tvm.tir.For)
+
+
+def test_vectorize_with_if_predicated():
+    n = te.var("n")
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    Idx = ib.pointer("int32", name="Idx")
+    with ib.for_range(0, 4, kind="vectorize") as i:
+        with ib.if_scope(i < n):
+            A[Idx[i]] = A[Idx[i]] + 1
+        with ib.else_scope():
+            A[i] = 0
+    stmt = ib.get()
+
+    mod = tvm.IRModule.from_expr(tvm.tir.PrimFunc([A, Idx, n], stmt))
+    with tvm.transform.PassContext(config={"tir.VectorizeLoop": {"enable_predication": True}}):
+        stmt = tvm.tir.transform.VectorizeLoop()(mod)["main"].body
+
+    assert isinstance(stmt, tvm.tir.LetStmt)
+    mask = stmt.var
+    then_case, else_case = stmt.body[0], stmt.body[1]
+    assert isinstance(then_case, tvm.tir.Store) and then_case.predicate.same_as(mask)
+    assert then_case.index.predicate.same_as(mask)
+    assert isinstance(else_case, tvm.tir.Store)
+    assert tvm.ir.structural_equal(else_case.predicate, tvm.tir.Not(mask))
+
+    # scalarized by default.
+    stmt = tvm.tir.transform.VectorizeLoop()(mod)["main"].body
+    assert isinstance(stmt, tvm.tir.For)
+
+
 def test_vectorize_while_fail():
     """A while loop inside a vectorized loop should fail."""
 
@@ -210,6 +272,8 @@ if __name__ == "__main__":
     test_vectorize_with_if()
     test_vectorize_loop()
     test_vectorize_if_then_else()
+    test_vectorize_if_then_else_predicated()
+    test_vectorize_with_if_predicated()
     test_vectorize_with_le_cond()
     test_vectorize_with_ge_cond()
     test_vectorize_let()
@@ -0,0 +1,153 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import tvm
+import tvm.testing
+from tvm import te, topi
+
+
+def run_vectorize_reduction(stmt, args, target="llvm", config=None):
+    func = tvm.tir.PrimFunc(args, stmt).with_attr("target", tvm.target.Target(target))
+    mod = tvm.IRModule.from_expr(func)
+    with tvm.transform.PassContext(config={"tir.VectorizeReduction": config or {}}):
+        mod = tvm.tir.transform.VectorizeReduction()(mod)
+    return mod["main"].body
+
+
+def collect_reduce(stmt):
+    reduce = []
+
+    def _visit(op):
+        if isinstance(op, tvm.tir.Call) and op.op.name.startswith("tir.vector_reduce_"):
+            reduce.append(op)
+
+    tvm.tir.stmt_functor.post_order_visit(stmt, _visit)
+    return reduce
+
+
+def collect_loops(stmt):
+    loops = []
+
+    def _visit(op):
+        if isinstance(op, tvm.tir.For):
+            loops.append(op)
+
+    tvm.tir.stmt_functor.post_order_visit(stmt, _visit)
+    return loops
+
+
+def test_sum():
+    n = 1024
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, n, name="i") as i:
+        with ib.for_range(0, n, name="k") as k:
+            B[i] = B[i] + A[i * n + k]
+    stmt = run_vectorize_reduction(ib.get(), [A.asobject(), B.asobject()])
+
+    reduce = collect_reduce(stmt)
+    assert len(reduce) == 1
+    assert reduce[0].op.same_as(tvm.ir.Op.get("tir.vector_reduce_add"))
+    assert reduce[0].args[0].dtype == "float32x16"
+    # no tail loop.
+    assert [loop.loop_var.name for loop in collect_loops(stmt)] == ["k.outer", "i"]
+
+    config = {"vector_bits": 256}
+    stmt = run_vectorize_reduction(ib.get(), [A.asobject(), B.asobject()], config=config)
+    assert collect_reduce(stmt)[0].args[0].dtype == "float32x8"
+
+
+def test_max_with_tail():
+    n = te.var("n")
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, n, name="k") as k:
+        B[0] = tvm.tir.Max(A[k], B[0])
+    stmt = run_vectorize_reduction(ib.get(), [A.asobject(), B.asobject(), n])
+
+    reduce = collect_reduce(stmt)
+    assert len(reduce) == 1
+    assert reduce[0].op.same_as(tvm.ir.Op.get("tir.vector_reduce_max"))
+    names = [loop.loop_var.name for loop in collect_loops(stmt)]
+    assert "k.outer" in names and "k.tail" in names
+
+
+def test_skip():
+    n = 1024
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, n, name="k") as k:
+        # not a reduction, the index depends on the loop.
+        B[k] = B[k] + A[k]
+    with ib.for_range(0, n, name="k") as k:
+        # reads the accumulator at another index.
+        B[0] = B[0] + B[k + 1]
+    with ib.for_range(0, 4, name="k") as k:
+        # too short.
+        B[0] = B[0] + A[k]
+    stmt = run_vectorize_reduction(ib.get(), [A.asobject(), B.asobject()])
+    assert len(collect_reduce(stmt)) == 0
+
+    with ib.for_range(0, n, name="k") as k:
+        B[0] = B[0] + A[k]
+    stmt = run_vectorize_reduction(ib.get(), [A.asobject(), B.asobject()], target="c")
+    assert len(collect_reduce(stmt)) == 0
+
+
+@tvm.testing.requires_llvm
+def test_build_softmax():
+    m, n = 16, 1003
+    A = te.placeholder((m, n), name="A")
+    B = topi.nn.softmax(A)
+    s = te.create_schedule(B.op)
+
+    with tvm.transform.PassContext(config={"tir.enable_vectorize_reduction": True}):
+        f = tvm.build(s, [A, B], "llvm")
+    dev = tvm.cpu(0)
+    a = np.random.uniform(size=(m, n)).astype("float32")
+    b = tvm.nd.empty((m, n), "float32", dev)
+    f(tvm.nd.array(a, dev), b)
+    e = np.exp(a - a.max(axis=1, keepdims=True))
+    tvm.testing.assert_allclose(b.asnumpy(), e / e.sum(axis=1, keepdims=True), rtol=1e-5)
+
+
+@tvm.testing.requires_llvm
+def test_build_int_min():
+    n = 100
+    A = te.placeholder((n,), name="A", dtype="int32")
+    k = te.reduce_axis((0, n), name="k")
+    B = te.compute((1,), lambda i: te.min(A[k], axis=k), name="B")
+    s = te.create_schedule(B.op)
+
+    with tvm.transform.PassContext(config={"tir.enable_vectorize_reduction": True}):
+        f = tvm.build(s, [A, B], "llvm")
+    dev = tvm.cpu(0)
+    a = np.random.randint(-1000, 1000, size=n).astype("int32")
+    b = tvm.nd.empty((1,), "int32", dev)
+    f(tvm.nd.array(a, dev), b)
+    assert b.asnumpy()[0] == a.min()
+
+
+if __name__ == "__main__":
+    test_sum()
+    test_max_with_tail()
+    test_skip()
+    test_build_softmax()
+    test_build_int_min()